@@ -0,0 +1,926 @@
+/**
+ * @file bench_uuid7.c
+ * @brief Micro-benchmarks for the UUIDv7 generation paths.
+ *
+ * Each case runs a fixed number of operations and reports ns/op and Mop/s.
+ * Usage: bench_uuid7 [-n ops] [-t threads] [case...]   (no case: run all)
+ *
+ * `gen_n` generates IDs 256 at a time with `uuid7_gen_n()`, the chunk
+ * size of the C++ `uuid7::stream()`; one op is one ID.
+ * The `first_call*` cases measure the first `uuid7_gen()` of fresh threads
+ * (one op = one thread), with and without `uuid7_warmup()` at thread start.
+ * The `*_mt` cases split the ops over `-t` threads (default 64) started
+ * together, and report wall time per op, i.e. aggregate throughput.
+ * The `*heap` cases run a scheduler-like queue: 8 producers (simulated
+ * nodes on one virtual clock) feed a queue of ~4096 pending items, and one
+ * op is a push of the next ID plus a pop of the minimum.
+ * `recent_get` resolves random picks among the last 64Ki registered IDs
+ * through the direct-mapped recent-ID table.
+ * `time_str_n` renders RFC 3339 timestamps of a sorted stream (one ID per
+ * ms) in batches; `time_str_libc` is the gmtime_r + strftime baseline.
+ * `dict_encode` / `dict_decode` run a 1 Mi-row column of 4096 distinct IDs
+ * (random picks) through the dictionary codec; one op is one row.
+ * `log_append` appends 64-byte records to the event log (segments retired
+ * as they fill); `log_since` seeks random recent IDs in a 1 Mi-record log.
+ * `sample_n` takes 1% sampling decisions for a 64Ki-ID stream (16 IDs per
+ * ms) into a bitmap; `sample_bucket` keeps 4 IDs per ms of the same stream.
+ * One op is one ID.
+ * `age_record_n` records the ages of the same stream into an ID-age sketch
+ * in batches of 256; `age_record` records one ID per call (clock each time).
+ * `arena_alloc` allocates a 64-byte object per ID of a continuing stream
+ * in its 1 s window and releases the finished windows after every 64Ki
+ * IDs; `arena_malloc` is the malloc + free baseline for the same objects.
+ *
+ * @author: Roman Horshkov <roman.horshkov@gmail.com>
+ * @date:   2025
+ */
+#ifndef _GNU_SOURCE
+#    define _GNU_SOURCE
+#endif
+
+#include "uuid7.h"
+#include "uuid7_age.h"
+#include "uuid7_arena.h"
+#include "uuid7_dict.h"
+#include "uuid7_log.h"
+#include "uuid7_recent.h"
+#include "uuid7_rheap.h"
+#include "uuid7_sample.h"
+#include "uuid7_sim.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/****************************************************************************
+ * PRIVATE DEFINES
+ ****************************************************************************
+ */
+
+#define BENCH_DEFAULT_OPS 1000000u
+#define BENCH_CHUNK       256u /* IDs per batch call */
+#define BENCH_MAX_THREADS 256u /* cap for one-op-per-thread cases */
+#define BENCH_MT_DEFAULT  64u  /* threads of the *_mt cases */
+#define BENCH_MT_MAX      1024u
+#define BENCH_HEAP_SIZE   4096u /* pending items of the *heap cases */
+#define BENCH_PRODUCERS   8u
+#define BENCH_RECENT_IDS  65536u /* registered IDs of recent_get, power of two */
+#define BENCH_TIME_IDS    4096u  /* input stream of the time_str cases, power of two */
+#define BENCH_DICT_ROWS   (1u << 20) /* column of the dict cases, power of two */
+#define BENCH_DICT_KEYS   4096u
+#define BENCH_LOG_RECORDS (1u << 20) /* log_since log size, power of two */
+#define BENCH_SAMPLE_IDS  65536u     /* input stream of the sample cases, multiple of 64 */
+#define BENCH_SAMPLE_MS   16u        /* ... IDs per ms */
+
+/****************************************************************************
+ * PRIVATE STUCTURED VARIABLES
+ ****************************************************************************
+ */
+
+/* A case runs @p n operations and returns elapsed nanoseconds. A non-zero
+ * `max_ops` caps @p n for expensive operations. */
+typedef struct bench_case
+{
+    const char* name;
+    uint64_t (*run)(size_t n);
+    size_t max_ops;
+} bench_case_t;
+
+/* Per-thread share of a multi-threaded case */
+typedef struct mt_arg
+{
+    int (*gen)(uint8_t* out);
+    size_t n;
+    uint64_t t0; /* first and last timestamp of this thread's loop */
+    uint64_t t1;
+} mt_arg_t;
+
+/* Binary min-heap entry of the baseline queue */
+typedef struct bin_entry
+{
+    uint64_t hi;
+    uint64_t lo;
+    void* value;
+} bin_entry_t;
+
+/* Round-robin producers of the *heap cases */
+typedef struct heap_feed
+{
+    uuid7_sim_t sim[BENCH_PRODUCERS];
+    size_t next;
+} heap_feed_t;
+
+/* Per-thread input/output of the first-call cases */
+typedef struct first_call_arg
+{
+    bool warmup;
+    uint64_t ns;
+} first_call_arg_t;
+
+/****************************************************************************
+ * PRIVATE VARIABLES
+ ****************************************************************************
+ */
+
+/* Sink so the compiler cannot drop generated IDs */
+static volatile uint8_t g_sink;
+
+/* Thread count of the *_mt cases, and the barrier that starts them */
+static unsigned g_mt_threads = BENCH_MT_DEFAULT;
+static pthread_barrier_t g_mt_barrier;
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS PROTOTYPES
+ ****************************************************************************
+ */
+
+static uint64_t _bench_gen(size_t n);
+static uint64_t _bench_gen_n(size_t n);
+static uint64_t _bench_gen_v4(size_t n);
+static uint64_t _bench_to_str(size_t n);
+static uint64_t _bench_from_str(size_t n);
+static uint64_t _bench_sim_gen(size_t n);
+static uint64_t _bench_gen_mt(size_t n);
+static uint64_t _bench_gen_fc_mt(size_t n);
+static uint64_t _bench_rheap(size_t n);
+static uint64_t _bench_binheap(size_t n);
+static uint64_t _bench_first_call(size_t n);
+static uint64_t _bench_first_call_warm(size_t n);
+static uint64_t _bench_sim_gen_n(size_t n);
+static uint64_t _bench_recent_get(size_t n);
+static uint64_t _bench_time_str_n(size_t n);
+static uint64_t _bench_time_str_libc(size_t n);
+static uint64_t _bench_dict_encode(size_t n);
+static uint64_t _bench_dict_decode(size_t n);
+static uint64_t _bench_log_append(size_t n);
+static uint64_t _bench_log_since(size_t n);
+static uint64_t _bench_sample_n(size_t n);
+static uint64_t _bench_sample_bucket(size_t n);
+static uint64_t _bench_age_record_n(size_t n);
+static uint64_t _bench_age_record(size_t n);
+static uint64_t _bench_arena_alloc(size_t n);
+static uint64_t _bench_arena_malloc(size_t n);
+
+/* Fill the time_str input: a simulated stream advancing one ms per ID */
+static void _time_ids(uint8_t* ids);
+
+/* Run the dict cases: build the column and dictionary, time @p decode or encode */
+static uint64_t _bench_dict(size_t n, bool decode);
+
+/* Run the sample cases over a simulated stream, per ms bucket if @p bucket */
+static uint64_t _bench_sample(size_t n, bool bucket);
+
+/* Fill the sample/age input: BENCH_SAMPLE_MS simulated IDs per ms */
+static void _sample_ids(uint8_t* ids);
+
+/* Run the age cases, in BENCH_CHUNK batches if @p batch */
+static uint64_t _bench_age(size_t n, bool batch);
+
+/****************************************************************************
+ * CASE TABLE
+ ****************************************************************************
+ */
+
+static const bench_case_t g_cases[] = {
+    {"gen", _bench_gen, 0},
+    {"gen_n", _bench_gen_n, 0},
+    {"gen_v4", _bench_gen_v4, 0},
+    {"to_str", _bench_to_str, 0},
+    {"from_str", _bench_from_str, 0},
+    {"gen_mt", _bench_gen_mt, 0},
+    {"gen_fc_mt", _bench_gen_fc_mt, 0},
+    {"rheap", _bench_rheap, 0},
+    {"binheap", _bench_binheap, 0},
+    {"first_call", _bench_first_call, BENCH_MAX_THREADS},
+    {"first_call_warm", _bench_first_call_warm, BENCH_MAX_THREADS},
+    {"sim_gen", _bench_sim_gen, 0},
+    {"sim_gen_n", _bench_sim_gen_n, 0},
+    {"recent_get", _bench_recent_get, 0},
+    {"time_str_n", _bench_time_str_n, 0},
+    {"time_str_libc", _bench_time_str_libc, 0},
+    {"dict_encode", _bench_dict_encode, 0},
+    {"dict_decode", _bench_dict_decode, 0},
+    {"log_append", _bench_log_append, 0},
+    {"log_since", _bench_log_since, 0},
+    {"sample_n", _bench_sample_n, 0},
+    {"sample_bucket", _bench_sample_bucket, 0},
+    {"age_record_n", _bench_age_record_n, 0},
+    {"age_record", _bench_age_record, 0},
+    {"arena_alloc", _bench_arena_alloc, 0},
+    {"arena_malloc", _bench_arena_malloc, 0},
+};
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+int main(int argc, char** argv)
+{
+    size_t ops = BENCH_DEFAULT_OPS;
+    int c;
+    while((c = getopt(argc, argv, "n:t:h")) != -1)
+    {
+        switch(c)
+        {
+            case 'n': ops = (size_t)strtoull(optarg, NULL, 10); break;
+            case 't': g_mt_threads = (unsigned)strtoul(optarg, NULL, 10); break;
+            case 'h':
+            default:
+                fprintf(stderr, "usage: %s [-n ops] [-t threads] [case...]\ncases:", argv[0]);
+                for(size_t i = 0; i < sizeof(g_cases) / sizeof(g_cases[0]); ++i)
+                {
+                    fprintf(stderr, " %s", g_cases[i].name);
+                }
+                fprintf(stderr, "\n");
+                return 2;
+        }
+    }
+    if(ops == 0) ops = 1;
+    if(g_mt_threads == 0) g_mt_threads = 1;
+    if(g_mt_threads > BENCH_MT_MAX) g_mt_threads = BENCH_MT_MAX;
+
+    printf("%-24s %12s %12s\n", "case", "ns/op", "Mop/s");
+    for(size_t i = 0; i < sizeof(g_cases) / sizeof(g_cases[0]); ++i)
+    {
+        bool selected = optind == argc;
+        for(int a = optind; a < argc; ++a)
+        {
+            if(strcmp(argv[a], g_cases[i].name) == 0) selected = true;
+        }
+        if(!selected) continue;
+
+        size_t n = ops;
+        if(g_cases[i].max_ops && n > g_cases[i].max_ops) n = g_cases[i].max_ops;
+        const uint64_t ns = g_cases[i].run(n);
+        const double per_op = (double)ns / (double)n;
+        printf("%-24s %12.2f %12.2f\n", g_cases[i].name, per_op, per_op > 0 ? 1e3 / per_op : 0.0);
+    }
+    return 0;
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static inline uint64_t _now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t _bench_gen(size_t n)
+{
+    uint8_t id[16];
+    const uint64_t t0 = _now_ns();
+    for(size_t i = 0; i < n; ++i)
+    {
+        uuid7_gen(id);
+        g_sink ^= id[15];
+    }
+    return _now_ns() - t0;
+}
+
+static uint64_t _bench_gen_n(size_t n)
+{
+    uint8_t ids[256][16];
+    const uint64_t t0 = _now_ns();
+    for(size_t i = 0; i < n; i += 256u)
+    {
+        uuid7_gen_n(&ids[0][0], n - i < 256u ? n - i : 256u);
+        g_sink ^= ids[0][15];
+    }
+    return _now_ns() - t0;
+}
+
+static uint64_t _bench_gen_v4(size_t n)
+{
+    uint8_t id[16];
+    const uint64_t t0 = _now_ns();
+    for(size_t i = 0; i < n; ++i)
+    {
+        uuid7_gen_v4(id);
+        g_sink ^= id[15];
+    }
+    return _now_ns() - t0;
+}
+
+static uint64_t _bench_to_str(size_t n)
+{
+    uint8_t id[16];
+    char str[37];
+    uuid7_gen(id);
+    const uint64_t t0 = _now_ns();
+    for(size_t i = 0; i < n; ++i)
+    {
+        id[15] = (uint8_t)i;
+        uuid7_to_str(id, str);
+        g_sink ^= (uint8_t)str[35];
+    }
+    return _now_ns() - t0;
+}
+
+static uint64_t _bench_from_str(size_t n)
+{
+    uint8_t id[16];
+    char str[37];
+    uuid7_gen(id);
+    uuid7_to_str(id, str);
+    const uint64_t t0 = _now_ns();
+    for(size_t i = 0; i < n; ++i)
+    {
+        str[35] = "0123456789abcdef"[i & 15u];
+        uuid7_from_str(str, id);
+        g_sink ^= id[15];
+    }
+    return _now_ns() - t0;
+}
+
+static void* _mt_thread(void* p)
+{
+    mt_arg_t* arg = (mt_arg_t*)p;
+    uint8_t id[16];
+    pthread_barrier_wait(&g_mt_barrier);
+    arg->t0 = _now_ns();
+    for(size_t i = 0; i < arg->n; ++i)
+    {
+        arg->gen(id);
+        g_sink ^= id[15];
+    }
+    arg->t1 = _now_ns();
+    return NULL;
+}
+
+/* Wall time (first start to last finish) for @p n IDs from g_mt_threads
+ * threads released at once */
+static uint64_t _run_mt(size_t n, int (*gen)(uint8_t* out))
+{
+    static pthread_t th[BENCH_MT_MAX];
+    static mt_arg_t args[BENCH_MT_MAX];
+    const unsigned nt = g_mt_threads;
+    pthread_barrier_init(&g_mt_barrier, NULL, nt + 1u);
+
+    unsigned started = 0;
+    for(; started < nt; ++started)
+    {
+        args[started] = (mt_arg_t){gen, n / nt + (started < n % nt ? 1u : 0u), 0, 0};
+        if(pthread_create(&th[started], NULL, _mt_thread, &args[started]) != 0) break;
+    }
+    if(started < nt)
+    {
+        fprintf(stderr, "bench: only %u of %u threads started\n", started, nt);
+        exit(1);
+    }
+
+    pthread_barrier_wait(&g_mt_barrier);
+    uint64_t first = UINT64_MAX;
+    uint64_t last = 0;
+    for(unsigned t = 0; t < nt; ++t)
+    {
+        pthread_join(th[t], NULL);
+        if(args[t].t0 < first) first = args[t].t0;
+        if(args[t].t1 > last) last = args[t].t1;
+    }
+    pthread_barrier_destroy(&g_mt_barrier);
+    return last - first;
+}
+
+static uint64_t _bench_gen_mt(size_t n)
+{
+    return _run_mt(n, uuid7_gen);
+}
+
+static uint64_t _bench_gen_fc_mt(size_t n)
+{
+    return _run_mt(n, uuid7_gen_fc);
+}
+
+static void _feed_init(heap_feed_t* f)
+{
+    for(unsigned i = 0; i < BENCH_PRODUCERS; ++i) uuid7_sim_init(&f->sim[i], i + 1u, 1735689600000ull);
+    f->next = 0;
+}
+
+static void _feed_next(heap_feed_t* f, uint8_t* id)
+{
+    /* All producers share the virtual clock: one ms per 64 IDs in total */
+    if(f->next % 64u == 0)
+    {
+        for(unsigned i = 0; i < BENCH_PRODUCERS; ++i) uuid7_sim_advance(&f->sim[i], 1u);
+    }
+    uuid7_sim_gen(&f->sim[f->next % BENCH_PRODUCERS], id);
+    f->next++;
+}
+
+static inline uint64_t _be64(const uint8_t* p)
+{
+    uint64_t v = 0;
+    for(int i = 0; i < 8; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+static inline bool _bin_less(const bin_entry_t* a, const bin_entry_t* b)
+{
+    return a->hi < b->hi || (a->hi == b->hi && a->lo < b->lo);
+}
+
+static void _bin_push(bin_entry_t* h, size_t* n, const uint8_t* id, void* value)
+{
+    const bin_entry_t e = {_be64(id), _be64(id + 8), value};
+    size_t i = (*n)++;
+    while(i > 0 && _bin_less(&e, &h[(i - 1u) / 2u]))
+    {
+        h[i] = h[(i - 1u) / 2u];
+        i = (i - 1u) / 2u;
+    }
+    h[i] = e;
+}
+
+static bin_entry_t _bin_pop(bin_entry_t* h, size_t* n)
+{
+    const bin_entry_t top = h[0];
+    const bin_entry_t tail = h[--(*n)];
+    size_t i = 0;
+    for(;;)
+    {
+        size_t c = 2u * i + 1u;
+        if(c >= *n) break;
+        if(c + 1u < *n && _bin_less(&h[c + 1u], &h[c])) c++;
+        if(!_bin_less(&h[c], &tail)) break;
+        h[i] = h[c];
+        i = c;
+    }
+    if(*n) h[i] = tail;
+    return top;
+}
+
+static uint64_t _bench_rheap(size_t n)
+{
+    heap_feed_t feed;
+    _feed_init(&feed);
+    uuid7_rheap_t* h = uuid7_rheap_create();
+    uint8_t id[16];
+    for(size_t i = 0; i < BENCH_HEAP_SIZE; ++i)
+    {
+        _feed_next(&feed, id);
+        uuid7_rheap_push(h, id, NULL);
+    }
+    const uint64_t t0 = _now_ns();
+    for(size_t i = 0; i < n; ++i)
+    {
+        _feed_next(&feed, id);
+        uuid7_rheap_push(h, id, NULL);
+        uuid7_rheap_pop(h, id, NULL);
+        g_sink ^= id[15];
+    }
+    const uint64_t ns = _now_ns() - t0;
+    uuid7_rheap_destroy(h);
+    return ns;
+}
+
+static uint64_t _bench_binheap(size_t n)
+{
+    heap_feed_t feed;
+    _feed_init(&feed);
+    bin_entry_t* h = malloc((BENCH_HEAP_SIZE + 1u) * sizeof(*h));
+    if(!h) return 0;
+    size_t size = 0;
+    uint8_t id[16];
+    for(size_t i = 0; i < BENCH_HEAP_SIZE; ++i)
+    {
+        _feed_next(&feed, id);
+        _bin_push(h, &size, id, NULL);
+    }
+    const uint64_t t0 = _now_ns();
+    for(size_t i = 0; i < n; ++i)
+    {
+        _feed_next(&feed, id);
+        _bin_push(h, &size, id, NULL);
+        g_sink ^= (uint8_t)_bin_pop(h, &size).lo;
+    }
+    const uint64_t ns = _now_ns() - t0;
+    free(h);
+    return ns;
+}
+
+static void* _first_call_thread(void* p)
+{
+    first_call_arg_t* arg = (first_call_arg_t*)p;
+    if(arg->warmup) uuid7_warmup(0);
+
+    uint8_t id[16];
+    const uint64_t t0 = _now_ns();
+    uuid7_gen(id);
+    arg->ns = _now_ns() - t0;
+    g_sink ^= id[15];
+    return NULL;
+}
+
+/* Threads run one after another so only the cold path is measured */
+static uint64_t _run_first_calls(size_t n, bool warmup)
+{
+    uint64_t total = 0;
+    uint64_t worst = 0;
+    for(size_t i = 0; i < n; ++i)
+    {
+        first_call_arg_t arg = {warmup, 0};
+        pthread_t th;
+        if(pthread_create(&th, NULL, _first_call_thread, &arg) != 0) break;
+        pthread_join(th, NULL);
+        total += arg.ns;
+        if(arg.ns > worst) worst = arg.ns;
+    }
+    printf("  %s: max first-call %.2f us over %zu threads\n", warmup ? "warm" : "cold",
+            (double)worst / 1e3, n);
+    return total;
+}
+
+static uint64_t _bench_first_call(size_t n)
+{
+    return _run_first_calls(n, false);
+}
+
+static uint64_t _bench_first_call_warm(size_t n)
+{
+    return _run_first_calls(n, true);
+}
+
+static uint64_t _bench_sim_gen(size_t n)
+{
+    uuid7_sim_t sim;
+    uuid7_sim_init(&sim, 1u, 1735689600000ull);
+    uint8_t id[16];
+    const uint64_t t0 = _now_ns();
+    for(size_t i = 0; i < n; ++i)
+    {
+        /* One virtual ms per 1024 IDs, like a busy simulated node */
+        if((i & 1023u) == 0) uuid7_sim_advance(&sim, 1u);
+        uuid7_sim_gen(&sim, id);
+        g_sink ^= id[15];
+    }
+    return _now_ns() - t0;
+}
+
+static uint64_t _bench_sim_gen_n(size_t n)
+{
+    uuid7_sim_t sim;
+    uuid7_sim_init(&sim, 1u, 1735689600000ull);
+    uint8_t ids[BENCH_CHUNK * 16u];
+    const uint64_t t0 = _now_ns();
+    for(size_t done = 0; done < n; done += BENCH_CHUNK)
+    {
+        const size_t k = (n - done < BENCH_CHUNK) ? n - done : BENCH_CHUNK;
+        uuid7_sim_advance(&sim, 1u);
+        uuid7_sim_gen_n(&sim, ids, k);
+        g_sink ^= ids[15];
+    }
+    return _now_ns() - t0;
+}
+
+static uint64_t _bench_recent_get(size_t n)
+{
+    uuid7_recent_config_t cfg;
+    uuid7_recent_config_init(&cfg);
+    uuid7_recent_t* r = uuid7_recent_create(&cfg);
+    uint8_t(*ids)[16] = malloc(BENCH_RECENT_IDS * 16u);
+    if(!r || !ids)
+    {
+        uuid7_recent_destroy(r);
+        free(ids);
+        return 0;
+    }
+    for(size_t i = 0; i < BENCH_RECENT_IDS; ++i) uuid7_recent_gen(r, ids[i], &ids[i]);
+
+    /* xorshift picks, so lookups do not walk the table in order */
+    uint32_t x = 2463534242u;
+    const uint64_t t0 = _now_ns();
+    for(size_t i = 0; i < n; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        g_sink ^= (uint8_t)(uintptr_t)uuid7_recent_get(r, ids[x & (BENCH_RECENT_IDS - 1u)]);
+    }
+    const uint64_t ns = _now_ns() - t0;
+
+    uuid7_recent_stats_t st;
+    uuid7_recent_get_stats(r, &st);
+    fprintf(stderr, "recent_get: %llu of %u IDs displaced\n", (unsigned long long)st.evictions,
+            BENCH_RECENT_IDS);
+    uuid7_recent_destroy(r);
+    free(ids);
+    return ns;
+}
+
+static uint64_t _bench_time_str_n(size_t n)
+{
+    static uint8_t ids[BENCH_TIME_IDS * 16u];
+    char out[BENCH_CHUNK * UUID7_TIME_STR_LEN];
+    _time_ids(ids);
+    const uint64_t t0 = _now_ns();
+    for(size_t done = 0; done < n; done += BENCH_CHUNK)
+    {
+        const size_t k = (n - done < BENCH_CHUNK) ? n - done : BENCH_CHUNK;
+        const size_t at = done & (BENCH_TIME_IDS - 1u) & ~(size_t)(BENCH_CHUNK - 1u);
+        uuid7_time_str_n(ids + at * 16u, k, out);
+        g_sink ^= (uint8_t)out[22];
+    }
+    return _now_ns() - t0;
+}
+
+static uint64_t _bench_time_str_libc(size_t n)
+{
+    static uint8_t ids[BENCH_TIME_IDS * 16u];
+    char out[32];
+    _time_ids(ids);
+    const uint64_t t0 = _now_ns();
+    for(size_t i = 0; i < n; ++i)
+    {
+        uint64_t ms = 0;
+        uuid7_get_ms(ids + (i & (BENCH_TIME_IDS - 1u)) * 16u, &ms);
+        const time_t secs = (time_t)(ms / 1000u);
+        struct tm tm;
+        gmtime_r(&secs, &tm);
+        const size_t len = strftime(out, sizeof(out), "%Y-%m-%dT%H:%M:%S.", &tm);
+        snprintf(out + len, sizeof(out) - len, "%03uZ", (unsigned)(ms % 1000u));
+        g_sink ^= (uint8_t)out[22];
+    }
+    return _now_ns() - t0;
+}
+
+static void _time_ids(uint8_t* ids)
+{
+    uuid7_sim_t sim;
+    uuid7_sim_init(&sim, 1u, 1735689600000ull);
+    for(size_t i = 0; i < BENCH_TIME_IDS; ++i)
+    {
+        uuid7_sim_advance(&sim, 1u);
+        uuid7_sim_gen(&sim, ids + i * 16u);
+    }
+}
+
+static uint64_t _bench_dict_encode(size_t n)
+{
+    return _bench_dict(n, false);
+}
+
+static uint64_t _bench_dict_decode(size_t n)
+{
+    return _bench_dict(n, true);
+}
+
+static uint64_t _bench_dict(size_t n, bool decode)
+{
+    uint8_t(*keys)[16] = malloc(BENCH_DICT_KEYS * 16u);
+    uint8_t(*rows)[16] = malloc((size_t)BENCH_DICT_ROWS * 16u);
+    uint64_t* packed = malloc((size_t)BENCH_DICT_ROWS * 2u); /* 12 bits per row fit in 16 */
+    uuid7_dict_t* d = NULL;
+    uint64_t ns = 0;
+    if(keys && rows && packed)
+    {
+        for(size_t i = 0; i < BENCH_DICT_KEYS; ++i) uuid7_gen(keys[i]);
+        uint32_t x = 2463534242u;
+        for(size_t i = 0; i < BENCH_DICT_ROWS; ++i)
+        {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            memcpy(rows[i], keys[x % BENCH_DICT_KEYS], 16);
+        }
+        d = uuid7_dict_build(&rows[0][0], BENCH_DICT_ROWS);
+    }
+    if(d)
+    {
+        uuid7_dict_encode(d, &rows[0][0], BENCH_DICT_ROWS, packed);
+        const uint64_t t0 = _now_ns();
+        for(size_t done = 0; done < n; done += BENCH_DICT_ROWS)
+        {
+            const size_t k = (n - done < BENCH_DICT_ROWS) ? n - done : BENCH_DICT_ROWS;
+            if(decode)
+            {
+                uuid7_dict_decode(d, packed, k, &rows[0][0]);
+            }
+            else
+            {
+                uuid7_dict_encode(d, &rows[0][0], k, packed);
+            }
+            g_sink ^= rows[k - 1][15] ^ (uint8_t)packed[0];
+        }
+        ns = _now_ns() - t0;
+    }
+    uuid7_dict_destroy(d);
+    free(packed);
+    free(rows);
+    free(keys);
+    return ns;
+}
+
+static uint64_t _bench_log_append(size_t n)
+{
+    uuid7_log_config_t cfg;
+    uuid7_log_config_init(&cfg);
+    uuid7_log_t* log = uuid7_log_create(&cfg);
+    if(!log) return 0;
+    uint8_t rec[64] = {0};
+    uint8_t id[16];
+    const uint64_t t0 = _now_ns();
+    for(size_t i = 0; i < n; ++i)
+    {
+        rec[0] = (uint8_t)i;
+        if(uuid7_log_append(log, rec, id) != 0)
+        {
+            uuid7_log_retire(log, UINT64_MAX); /* directory full: drop the oldest */
+            uuid7_log_append(log, rec, id);
+        }
+        g_sink ^= id[15];
+    }
+    const uint64_t ns = _now_ns() - t0;
+    uuid7_log_destroy(log);
+    return ns;
+}
+
+static uint64_t _bench_log_since(size_t n)
+{
+    uuid7_log_config_t cfg;
+    uuid7_log_config_init(&cfg);
+    cfg.record_size = 8u;
+    uuid7_log_t* log = uuid7_log_create(&cfg);
+    uint8_t(*ids)[16] = malloc((size_t)BENCH_LOG_RECORDS * 16u);
+    uint64_t ns = 0;
+    if(log && ids)
+    {
+        for(uint64_t i = 0; i < BENCH_LOG_RECORDS; ++i) uuid7_log_append(log, &i, ids[i]);
+
+        uint32_t x = 2463534242u;
+        uint64_t rec = 0;
+        uuid7_log_cursor_t cur;
+        const uint64_t t0 = _now_ns();
+        for(size_t i = 0; i < n; ++i)
+        {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            uuid7_log_since(log, ids[x & (BENCH_LOG_RECORDS - 1u)], &cur);
+            uuid7_log_read(log, &cur, UINT64_MAX, NULL, &rec, 1u);
+            g_sink ^= (uint8_t)rec;
+        }
+        ns = _now_ns() - t0;
+    }
+    uuid7_log_destroy(log);
+    free(ids);
+    return ns;
+}
+
+static uint64_t _bench_sample_n(size_t n)
+{
+    return _bench_sample(n, false);
+}
+
+static uint64_t _bench_sample_bucket(size_t n)
+{
+    return _bench_sample(n, true);
+}
+
+static uint64_t _bench_sample(size_t n, bool bucket)
+{
+    uint8_t(*ids)[16] = malloc((size_t)BENCH_SAMPLE_IDS * 16u);
+    uint64_t bits[BENCH_SAMPLE_IDS / 64u];
+    if(!ids) return 0;
+    _sample_ids(&ids[0][0]);
+
+    size_t kept = 0;
+    const uint64_t t0 = _now_ns();
+    for(size_t done = 0; done < n; done += BENCH_SAMPLE_IDS)
+    {
+        const size_t k = (n - done < BENCH_SAMPLE_IDS) ? n - done : BENCH_SAMPLE_IDS;
+        if(bucket)
+        {
+            uuid7_sample_per_bucket(&ids[0][0], k, 1u, 4u, bits, &kept);
+        }
+        else
+        {
+            uuid7_sample_n(&ids[0][0], k, 0.01, bits, &kept);
+        }
+        g_sink ^= (uint8_t)(kept ^ bits[0]);
+    }
+    const uint64_t ns = _now_ns() - t0;
+    free(ids);
+    return ns;
+}
+
+static void _sample_ids(uint8_t* ids)
+{
+    uuid7_sim_t sim;
+    uuid7_sim_init(&sim, 42u, 1735689600000ull);
+    for(size_t i = 0; i < BENCH_SAMPLE_IDS; i += BENCH_SAMPLE_MS)
+    {
+        uuid7_sim_gen_n(&sim, ids + i * 16u, BENCH_SAMPLE_MS);
+        uuid7_sim_advance(&sim, 1u);
+    }
+}
+
+static uint64_t _bench_age_record_n(size_t n)
+{
+    return _bench_age(n, true);
+}
+
+static uint64_t _bench_age_record(size_t n)
+{
+    return _bench_age(n, false);
+}
+
+static uint64_t _bench_age(size_t n, bool batch)
+{
+    uint8_t(*ids)[16] = malloc((size_t)BENCH_SAMPLE_IDS * 16u);
+    uuid7_age_config_t cfg;
+    uuid7_age_config_init(&cfg);
+    uuid7_age_t* age = uuid7_age_create(&cfg);
+    uint64_t ns = 0;
+    if(ids && age)
+    {
+        _sample_ids(&ids[0][0]);
+        const uint64_t t0 = _now_ns();
+        for(size_t done = 0; done < n;)
+        {
+            const size_t at = done % BENCH_SAMPLE_IDS;
+            size_t k = batch ? BENCH_CHUNK : 1u;
+            if(k > n - done) k = n - done;
+            if(k > BENCH_SAMPLE_IDS - at) k = BENCH_SAMPLE_IDS - at;
+            uuid7_age_record_n(age, ids[at], k);
+            done += k;
+        }
+        ns = _now_ns() - t0;
+        uint64_t ms = 0;
+        uuid7_age_quantile(age, 0.99, &ms);
+        g_sink ^= (uint8_t)ms;
+    }
+    uuid7_age_destroy(age);
+    free(ids);
+    return ns;
+}
+
+static uint64_t _bench_arena_alloc(size_t n)
+{
+    uint8_t(*ids)[16] = malloc((size_t)BENCH_SAMPLE_IDS * 16u);
+    uuid7_arena_config_t cfg;
+    uuid7_arena_config_init(&cfg);
+    uuid7_arena_t* a = uuid7_arena_create(&cfg);
+    uint64_t ns = 0;
+    if(ids && a)
+    {
+        /* Time moves on across passes: each pass is a fresh stretch of
+         * windows, and the ones it has finished are released after it */
+        uuid7_sim_t sim;
+        uuid7_sim_init(&sim, 42u, 1735689600000ull);
+        for(size_t done = 0; done < n;)
+        {
+            for(size_t i = 0; i < BENCH_SAMPLE_IDS; i += BENCH_SAMPLE_MS)
+            {
+                uuid7_sim_gen_n(&sim, ids[i], BENCH_SAMPLE_MS);
+                uuid7_sim_advance(&sim, 1u);
+            }
+            const size_t batch = n - done < BENCH_SAMPLE_IDS ? n - done : BENCH_SAMPLE_IDS;
+            const uint64_t t0 = _now_ns();
+            for(size_t i = 0; i < batch; ++i)
+            {
+                uint8_t* p = uuid7_arena_alloc(a, ids[i], 64u);
+                if(p) p[0] = (uint8_t)i;
+            }
+            uuid7_arena_release(a, sim.now_ms);
+            ns += _now_ns() - t0;
+            done += batch;
+        }
+    }
+    uuid7_arena_destroy(a);
+    free(ids);
+    return ns;
+}
+
+static uint64_t _bench_arena_malloc(size_t n)
+{
+    uint8_t** objs = malloc((size_t)BENCH_SAMPLE_IDS * sizeof(*objs));
+    if(!objs) return 0;
+    size_t live = 0;
+    const uint64_t t0 = _now_ns();
+    for(size_t i = 0; i < n; ++i)
+    {
+        uint8_t* p = malloc(64u);
+        if(p) p[0] = (uint8_t)i;
+        objs[live++] = p;
+        if(live == BENCH_SAMPLE_IDS)
+        {
+            while(live) free(objs[--live]);
+        }
+    }
+    while(live) free(objs[--live]);
+    const uint64_t ns = _now_ns() - t0;
+    free(objs);
+    return ns;
+}
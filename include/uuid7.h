@@ -22,13 +22,54 @@ extern "C"
  * PUBLIC DEFINES
  ****************************************************************************
  */
-/* None */
+
+/** `uuid7_warmup()` flag: mix the kernel's AT_RANDOM auxv bytes into the RNG */
+#define UUID7_WARMUP_AT_RANDOM 0x1u
+
+/** IDs a thread may hold between `uuid7_inflight_begin()` and commit */
+#define UUID7_INFLIGHT_MAX 16u
+
+/** Length of an RFC 3339 timestamp `YYYY-MM-DDTHH:MM:SS.mmmZ`, without NUL */
+#define UUID7_TIME_STR_LEN 24u
 
 /****************************************************************************
  * PUBLIC STRUCTURED VARIABLES
  ****************************************************************************
 */
-/* None */
+
+/**
+ * @brief Tuning of the adaptive reservation path, see `uuid7_set_adaptive()`.
+ *
+ * Contention is measured per thread over windows of @p window CAS attempts
+ * on the shared state. The gap between @p enter_pct and @p exit_pct and the
+ * streak lengths form the hysteresis that keeps bursts from flapping modes.
+ */
+typedef struct uuid7_adapt_config
+{
+    uint32_t window;        /**< CAS attempts per evaluation window (default 256) */
+    uint32_t enter_pct;     /**< retry % that marks a window contended (default 25) */
+    uint32_t exit_pct;      /**< retry % that marks a window calm, <= enter_pct (default 5) */
+    uint32_t enter_windows; /**< contended windows in a row before leasing (default 2) */
+    uint32_t exit_windows;  /**< calm windows in a row before sharing again (default 8) */
+    uint32_t lease_size;    /**< IDs per leased block, 2..4096 (default 64) */
+} uuid7_adapt_config_t;
+
+/**
+ * @brief Counters of the adaptive reservation path.
+ *
+ * Threads publish their counters once per window, so the totals lag by up
+ * to one window per thread.
+ */
+typedef struct uuid7_adapt_stats
+{
+    uint64_t cas_attempts; /**< CAS attempts on the shared state */
+    uint64_t cas_retries;  /**< failed CAS attempts */
+    uint64_t ids;          /**< IDs issued on the adaptive path */
+    uint64_t leases;       /**< blocks leased */
+    uint64_t to_leased;    /**< switches shared -> leased */
+    uint64_t to_shared;    /**< switches leased -> shared */
+    int leased;            /**< current mode: 1 leased, 0 shared */
+} uuid7_adapt_stats_t;
 
 /****************************************************************************
  * PUBLIC FUNCTIONS DECLARATIONS
@@ -48,6 +89,110 @@ extern "C"
  */
 int uuid7_gen(uint8_t* val);
 
+/**
+ * @brief Generate @p n UUIDv7 values into consecutive 16-byte slots.
+ *
+ * Same ordering as @p n calls to `uuid7_gen()`, but the shared
+ * state is reserved once per block of up to 4096 IDs and the random tails
+ * are drawn 32 at a time. A block that overflows the 12-bit sequence rolls
+ * into the next millisecond. The blocks always come from the shared state:
+ * any adaptive lease the thread holds is retired, so its later
+ * `uuid7_gen()` IDs stay above the batch.
+ *
+ * @param[out] out  Output buffer of at least 16 * @p n bytes.
+ * @param[in]  n    Number of IDs, 0 is a no-op.
+ * @return 0 on success, -1 if @p out is NULL and @p n is not 0.
+ */
+int uuid7_gen_n(uint8_t* out, size_t n);
+
+/**
+ * @brief Generate a UUIDv7 through flat combining (experimental).
+ *
+ * **Experimental:** so far it has not beaten the CAS loop of `uuid7_gen()`
+ * in any measured setup (`bench_uuid7 -t 4` and `-t 64`: `gen_fc_mt` is
+ * 15-60% slower than `gen_mt`). Prefer `uuid7_gen()`; this entry point may
+ * change or go away.
+ *
+ * Same IDs and the same global ordering as `uuid7_gen()` (both reserve from
+ * one shared state), built for hundreds of threads hammering the generator
+ * at once. Each thread publishes its request in a private cache-line slot;
+ * whichever waiting thread takes the combiner lock reserves one contiguous
+ * block for every pending request and hands the pairs out in slot order.
+ * The shared state then sees one CAS per batch instead of one per ID.
+ *
+ * Up to 512 threads get a slot (released at thread exit); further threads
+ * fall back to the CAS loop. Adaptive leasing does not apply here; the
+ * thread's lease, if any, is retired so its next `uuid7_gen()` stays ordered.
+ *
+ * @param[out] val  Output buffer, must be at least 16 bytes.
+ * @return 0 on success, -1 if @p val is NULL.
+ */
+int uuid7_gen_fc(uint8_t* val);
+
+/**
+ * @brief Generate a UUIDv7 and track it as in flight until committed.
+ *
+ * For change-data-capture style readers that tail a table by ID range: IDs
+ * are generated in order but their rows may be committed out of order. Call
+ * this instead of `uuid7_gen()` for IDs whose rows readers must not skip,
+ * and `uuid7_inflight_commit()` once the row is durable (or abandoned).
+ * `uuid7_low_watermark()` then tells readers how far they may go.
+ *
+ * Each thread may hold up to `UUID7_INFLIGHT_MAX` open IDs; up to 512
+ * threads get a tracking slot (released at thread exit, which also drops
+ * its open IDs). The ID always comes from the shared state, never from an
+ * adaptive lease, and the thread's lease is retired, so it is ordered
+ * against every later ID of this thread.
+ *
+ * @param[out] val  Output buffer, must be at least 16 bytes.
+ * @return 0 on success, -1 if @p val is NULL, this thread already holds
+ *         `UUID7_INFLIGHT_MAX` open IDs, or no tracking slot is free.
+ */
+int uuid7_inflight_begin(uint8_t* val);
+
+/**
+ * @brief Mark an ID from `uuid7_inflight_begin()` on this thread as done.
+ *
+ * @param[in] val  The 16-byte ID.
+ * @return 0 on success, -1 if @p val is NULL or not open on this thread.
+ */
+int uuid7_inflight_commit(const uint8_t* val);
+
+/**
+ * @brief Lowest ID that may still be committed by an in-flight writer.
+ *
+ * Every tracked ID smaller than the result is committed, and no ID issued
+ * from now on will be smaller, so a reader that has consumed all rows below
+ * it never has to look back. The result is a bound rather than an issued
+ * ID: the (ms, seq) of the oldest open ID, or of the next ID the generator
+ * can produce, with an all-zero random tail. Lock-free: one pass over the
+ * tracking slots, concurrent with begin/commit on any thread.
+ *
+ * Only IDs from `uuid7_inflight_begin()` are tracked; plain `uuid7_gen()`
+ * IDs are treated as committed the moment they are issued.
+ *
+ * There is no bound while adaptive reservation is enabled: leases let
+ * `uuid7_gen()` issue words below the shared state at any later time, so
+ * the call fails until `uuid7_set_adaptive(NULL)`.
+ *
+ * @param[out] val  16-byte bound.
+ * @return 0 on success, -1 if @p val is NULL or adaptive reservation is
+ *         enabled.
+ */
+int uuid7_low_watermark(uint8_t* val);
+
+/**
+ * @brief Generate a random (version 4) UUID.
+ *
+ * Uses the same RNG as `uuid7_gen()`, including the per-thread pool of
+ * `uuid7_rng_buffered` when that is installed (as the libuuid preload shim
+ * does). Provided for callers that need v4 semantics.
+ *
+ * @param[out] val  Output buffer, must be at least 16 bytes.
+ * @return 0 on success, -1 if @p val is NULL.
+ */
+int uuid7_gen_v4(uint8_t* val);
+
 /**
  * @brief Type of RNG function used to fill random bytes in UUIDs.
  *
@@ -67,7 +212,8 @@ typedef void (*uuid_rng_fn_t)(void* buf, const size_t n);
  * If @p fn is non-NULL the UUID module will call this function to obtain
  * random bytes for sequence initialization and for the random tail. If
  * @p fn is NULL the module will reset to the built-in default RNG which
- * reads system entropy (getrandom(2) on Linux or /dev/urandom fallback).
+ * reads system entropy (getrandom(2) on Linux or /dev/urandom fallback)
+ * on every call. Pass `uuid7_rng_buffered` to opt into the per-thread pool.
  *
  * Thread-safety: this function is thread-safe and may be called at any time.
  * The implementation guarantees safe concurrent reads/writes of the RNG
@@ -78,6 +224,43 @@ typedef void (*uuid_rng_fn_t)(void* buf, const size_t n);
  */
 int uuid7_set_rng(uuid_rng_fn_t fn);
 
+/**
+ * @brief Built-in RNG behind a 256-byte per-thread entropy pool, so most
+ * calls make no system call. Opt in with `uuid7_set_rng(uuid7_rng_buffered)`.
+ *
+ * Bytes are wiped from the pool once handed out, and the pool is discarded
+ * in the child after fork(). If refilling the pool from the kernel fails,
+ * that request is served by the default RNG instead.
+ *
+ * @param[out] buf  Output buffer.
+ * @param[in]  n    Number of bytes to fill.
+ */
+void uuid7_rng_buffered(void* buf, const size_t n);
+
+/**
+ * @brief Type of clock function used for the UUID timestamp.
+ *
+ * The function must return the current time in milliseconds since the Unix
+ * epoch. It may jump backwards; the generator clamps to the last issued
+ * millisecond so monotonicity is preserved.
+ *
+ * @return Current unix time in ms.
+ */
+typedef uint64_t (*uuid_clock_fn_t)(void);
+
+/**
+ * @brief Configure the clock used by the UUID generator.
+ *
+ * Intended for tests and fault injection (e.g. simulated clock jumps). If
+ * @p fn is NULL the module resets to the built-in CLOCK_REALTIME source.
+ *
+ * Thread-safety: same guarantees as `uuid7_set_rng()`.
+ *
+ * @param[in] fn  Clock function pointer to use, or NULL to reset to default.
+ * @return 0 on success, negative on error.
+ */
+int uuid7_set_clock(uuid_clock_fn_t fn);
+
 /**
  * @brief Explicitly initialize the UUID module and optionally configure the
  * RNG implementation.
@@ -97,6 +280,142 @@ int uuid7_set_rng(uuid_rng_fn_t fn);
  */
 int uuid7_init(uuid_rng_fn_t fn);
 
+/**
+ * @brief Do all lazy initialization up front to avoid a first-call spike.
+ *
+ * Installs the built-in RNG if none is configured (like `uuid7_init(NULL)`),
+ * registers the fork handler, and, when `uuid7_rng_buffered` is the RNG,
+ * fills the calling thread's entropy pool so the next `uuid7_gen()` on this
+ * thread makes no system call. The process-wide part runs once; call it
+ * again at the start of each worker thread to prefill that thread's pool.
+ * A custom RNG is left untouched.
+ *
+ * With `UUID7_WARMUP_AT_RANDOM`, the 16 `AT_RANDOM` bytes the kernel passes
+ * in the auxiliary vector are mixed into every later refill of the
+ * `uuid7_rng_buffered` pool. They are only ever XORed over getrandom(2)
+ * output, never used on their own, since libc also derives its
+ * stack-protector secret from them.
+ *
+ * @param[in] flags  0 or `UUID7_WARMUP_AT_RANDOM`.
+ * @return 0 on success, -1 if the kernel entropy read failed.
+ */
+int uuid7_warmup(unsigned flags);
+
+/**
+ * @brief Fill @p cfg with the default adaptive tuning.
+ *
+ * @param[out] cfg  Configuration to initialize.
+ * @return 0 on success, -1 if @p cfg is NULL.
+ */
+int uuid7_adapt_config_init(uuid7_adapt_config_t* cfg);
+
+/**
+ * @brief Enable or disable contention-aware reservation in `uuid7_gen()`.
+ *
+ * When enabled, the generator watches its CAS retry rate. Under sustained
+ * contention it switches from reserving one (ms, seq) pair per call on the
+ * shared state to leasing per-thread blocks of `lease_size` consecutive
+ * pairs, and switches back once contention subsides and leases go mostly
+ * unused. A lease only lives within its millisecond, so timestamps stay
+ * current.
+ *
+ * Guarantees in leased mode: IDs stay unique and strictly increasing per
+ * thread, but IDs of *different* threads are no longer ordered by issue
+ * time within a millisecond. Leave adaptation off if callers rely on a
+ * global issue order; `uuid7_low_watermark()` fails while it is enabled.
+ *
+ * @param[in] cfg  Tuning, or NULL to disable (the default state).
+ * @return 0 on success, -1 if @p cfg is invalid.
+ */
+int uuid7_set_adaptive(const uuid7_adapt_config_t* cfg);
+
+/**
+ * @brief Snapshot the adaptive reservation counters.
+ *
+ * @param[out] st  Counters.
+ * @return 0 on success, -1 if @p st is NULL.
+ */
+int uuid7_get_adapt_stats(uuid7_adapt_stats_t* st);
+
+/**
+ * @brief Extract the 48-bit unix-ms timestamp from a binary UUIDv7.
+ *
+ * @param[in]  val  16-byte UUID as produced by `uuid7_gen()`.
+ * @param[out] ms   Embedded unix milliseconds (bytes 0..5, big-endian).
+ * @return 0 on success, -1 if an argument is NULL.
+ */
+int uuid7_get_ms(const uint8_t* val, uint64_t* ms);
+
+/**
+ * @brief Decode the 48-bit unix-ms timestamp from a canonical UUID string.
+ *
+ * Only the timestamp prefix `xxxxxxxx-xxxx` (12 hex digits around the first
+ * dash) is inspected; the rest of the string is neither read nor validated.
+ * Upper- and lower-case hex digits are accepted.
+ *
+ * @param[in]  str  Canonical 8-4-4-4-12 UUID string (at least 13 chars).
+ * @param[out] ms   Decoded unix milliseconds.
+ * @return 0 on success, -1 if an argument is NULL or the prefix is malformed.
+ */
+int uuid7_str_ms(const char* str, uint64_t* ms);
+
+/**
+ * @brief Render the embedded timestamp as an RFC 3339 UTC string with
+ * millisecond precision, e.g. `2025-01-01T00:00:00.000Z`.
+ *
+ * @param[in]  val  16-byte UUID as produced by `uuid7_gen()`.
+ * @param[out] out  Output buffer of at least `UUID7_TIME_STR_LEN + 1` chars.
+ * @return 0 on success, -1 if an argument is NULL or the timestamp lies past
+ *         year 9999.
+ */
+int uuid7_time_str(const uint8_t* val, char* out);
+
+/**
+ * @brief Batch form of `uuid7_time_str()` for log and API rendering.
+ *
+ * Writes @p n fixed-width records of `UUID7_TIME_STR_LEN` chars back to
+ * back, without separators or NUL. The date and `HH:MM:SS.` prefix is
+ * cached across records, so runs of IDs from the same second (the usual
+ * shape of generator output) cost a copy plus three digits each.
+ *
+ * @param[in]  vals  @p n packed 16-byte UUIDs.
+ * @param[in]  n     Number of UUIDs.
+ * @param[out] out   Room for `n * UUID7_TIME_STR_LEN` chars.
+ * @return 0 on success, -1 if an argument is NULL or a timestamp lies past
+ *         year 9999 (records before it are written, the rest are not).
+ */
+int uuid7_time_str_n(const uint8_t* vals, size_t n, char* out);
+
+/**
+ * @brief Format a UUID as a canonical lower-case string.
+ *
+ * @param[in]  val  16-byte UUID.
+ * @param[out] out  Output buffer of at least 37 chars (36 + NUL).
+ * @return 0 on success, -1 if an argument is NULL.
+ */
+int uuid7_to_str(const uint8_t* val, char* out);
+
+/**
+ * @brief Format a UUID as a canonical upper-case string.
+ *
+ * @param[in]  val  16-byte UUID.
+ * @param[out] out  Output buffer of at least 37 chars (36 + NUL).
+ * @return 0 on success, -1 if an argument is NULL.
+ */
+int uuid7_to_str_upper(const uint8_t* val, char* out);
+
+/**
+ * @brief Parse a canonical 8-4-4-4-12 UUID string (any version).
+ *
+ * Exactly 36 characters are read; mixed-case hex digits are accepted. The
+ * caller decides whether trailing characters are allowed.
+ *
+ * @param[in]  str  Input string of at least 36 chars.
+ * @param[out] val  16-byte output buffer.
+ * @return 0 on success, -1 if an argument is NULL or the string is malformed.
+ */
+int uuid7_from_str(const char* str, uint8_t* val);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,260 @@
+/**
+ * @file uuid7.hpp
+ * @brief Header-only C++ range over batch UUIDv7 generation.
+ *
+ * `uuid7::stream(n)` is a lazy, single-pass range of @p n IDs:
+ *
+ *     for(const uuid7::id& id : uuid7::stream(n)) ...
+ *     std::ranges::copy(uuid7::stream(n), out.begin());
+ *
+ * The stream holds a fixed chunk of IDs inline and refills it with one
+ * `uuid7_gen_n()` call, so the shared state is reserved once per chunk
+ * instead of once per ID. Dereferencing the iterator is a load from the
+ * chunk; nothing is allocated on the heap. IDs are handed out in
+ * generation order, and their timestamps are those of the chunk's
+ * reservation.
+ *
+ * A stream can only be walked once and must not be moved once `begin()`
+ * has been called: its iterators point into it.
+ *
+ * For parallel algorithms, `uuid7::split(n, parts)` cuts the @p n IDs into
+ * a random-access range of independent streams, each knowing its offset
+ * in the whole; every worker fills its own chunks:
+ *
+ *     auto parts = uuid7::split(out.size(), 64);
+ *     std::for_each(std::execution::par, parts.begin(), parts.end(),
+ *                   [&](auto s) { std::copy(s.begin(), s.end(), out.begin() + s.offset()); });
+ *
+ * IDs are unique and ordered within each part; parts are generated
+ * concurrently, so their IDs interleave in time.
+ *
+ * Requires C++17; `std::ranges` algorithms need C++20.
+ *
+ * @author  Roman Horshkov <roman.horshkov@gmail.com>
+ * @date    2025
+ * (c) 2025
+ */
+
+#ifndef UUID7_HPP
+#define UUID7_HPP
+
+#include "uuid7.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace uuid7
+{
+
+/****************************************************************************
+ * PUBLIC DEFINES
+ ****************************************************************************
+ */
+
+/** IDs per chunk of `uuid7::stream()` (4 KiB of IDs) */
+inline constexpr std::size_t stream_chunk = 256u;
+
+/****************************************************************************
+ * PUBLIC STRUCTURED VARIABLES
+ ****************************************************************************
+*/
+
+/** One 16-byte UUID, in the layout `uuid7_gen()` writes. */
+using id = std::array<std::uint8_t, 16>;
+
+/**
+ * @brief Lazy range of IDs generated @p Chunk at a time.
+ *
+ * @tparam Chunk  IDs per refill, 1 .. 4096 (one reservation each).
+ */
+template <std::size_t Chunk = stream_chunk>
+class basic_stream
+{
+    static_assert(Chunk >= 1u && Chunk <= 4096u, "one chunk is one reservation of at most 4096 IDs");
+
+public:
+    /** Single-pass iterator; `*it` reads the current chunk. Like
+     * `std::istream_iterator`, every iterator of an exhausted stream
+     * equals the default-constructed end iterator. */
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = id;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const id*;
+        using reference = const id&;
+
+        iterator() = default;
+
+        reference operator*() const { return s_->buf_[s_->pos_]; }
+        pointer operator->() const { return &s_->buf_[s_->pos_]; }
+
+        iterator& operator++()
+        {
+            s_->advance();
+            return *this;
+        }
+        id operator++(int)
+        {
+            const id v = **this;
+            s_->advance();
+            return v;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) { return a.done() == b.done(); }
+        friend bool operator!=(const iterator& a, const iterator& b) { return a.done() != b.done(); }
+
+    private:
+        friend class basic_stream;
+        explicit iterator(basic_stream* s) : s_(s) {}
+        bool done() const { return !s_ || s_->size() == 0u; }
+        basic_stream* s_ = nullptr;
+    };
+
+    /**
+     * @param n       IDs in the stream.
+     * @param offset  Position of the first ID in a larger whole (see `split()`).
+     */
+    explicit basic_stream(std::size_t n, std::size_t offset = 0u) noexcept : left_(n), offset_(offset) {}
+
+    /** First ID; generates the first chunk. Call once. */
+    iterator begin()
+    {
+        if(left_ != 0u && pos_ == fill_) refill();
+        return iterator(this);
+    }
+    iterator end() const noexcept { return iterator(); }
+
+    /** IDs not handed out yet. */
+    std::size_t size() const noexcept { return left_; }
+    /** Position of the first ID in the whole it was split from. */
+    std::size_t offset() const noexcept { return offset_; }
+
+private:
+    void advance()
+    {
+        --left_;
+        if(++pos_ == fill_ && left_ != 0u) refill();
+    }
+
+    void refill()
+    {
+        fill_ = left_ < Chunk ? left_ : Chunk;
+        pos_ = 0u;
+        (void)uuid7_gen_n(buf_[0].data(), fill_);
+    }
+
+    std::size_t left_;
+    std::size_t offset_;
+    std::size_t pos_ = 0u;
+    std::size_t fill_ = 0u;
+    std::array<id, Chunk> buf_; /* left uninitialized until filled */
+};
+
+/**
+ * @brief @p n IDs cut into @p parts streams of near-equal size, as a
+ * random-access range; `*it` makes the stream of one part.
+ *
+ * @tparam Chunk  IDs per refill of each part's stream.
+ */
+template <std::size_t Chunk = stream_chunk>
+class basic_split
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = basic_stream<Chunk>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = basic_stream<Chunk>;
+
+        iterator() = default;
+
+        reference operator*() const { return sp_->part(i_); }
+        reference operator[](difference_type k) const { return sp_->part(i_ + static_cast<std::size_t>(k)); }
+
+        iterator& operator++() { return ++i_, *this; }
+        iterator operator++(int) { iterator t = *this; ++i_; return t; }
+        iterator& operator--() { return --i_, *this; }
+        iterator operator--(int) { iterator t = *this; --i_; return t; }
+        iterator& operator+=(difference_type k) { return i_ += static_cast<std::size_t>(k), *this; }
+        iterator& operator-=(difference_type k) { return i_ -= static_cast<std::size_t>(k), *this; }
+        friend iterator operator+(iterator it, difference_type k) { return it += k; }
+        friend iterator operator+(difference_type k, iterator it) { return it += k; }
+        friend iterator operator-(iterator it, difference_type k) { return it -= k; }
+        friend difference_type operator-(const iterator& a, const iterator& b)
+        {
+            return static_cast<difference_type>(a.i_) - static_cast<difference_type>(b.i_);
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) { return a.i_ == b.i_; }
+        friend bool operator!=(const iterator& a, const iterator& b) { return a.i_ != b.i_; }
+        friend bool operator<(const iterator& a, const iterator& b) { return a.i_ < b.i_; }
+        friend bool operator>(const iterator& a, const iterator& b) { return a.i_ > b.i_; }
+        friend bool operator<=(const iterator& a, const iterator& b) { return a.i_ <= b.i_; }
+        friend bool operator>=(const iterator& a, const iterator& b) { return a.i_ >= b.i_; }
+
+    private:
+        friend class basic_split;
+        iterator(const basic_split* sp, std::size_t i) : sp_(sp), i_(i) {}
+        const basic_split* sp_ = nullptr;
+        std::size_t i_ = 0u;
+    };
+
+    /**
+     * @param n      IDs in total.
+     * @param parts  Streams to cut them into; 0 is treated as 1, and no
+     *               part is left empty when @p n is smaller.
+     */
+    basic_split(std::size_t n, std::size_t parts) noexcept
+        : n_(n), parts_(parts == 0u ? 1u : (n != 0u && parts > n ? n : parts))
+    {
+    }
+
+    iterator begin() const noexcept { return iterator(this, 0u); }
+    iterator end() const noexcept { return iterator(this, parts_); }
+    std::size_t size() const noexcept { return parts_; }
+
+    /** Stream of part @p i: the first `n % parts` parts take one ID more. */
+    basic_stream<Chunk> part(std::size_t i) const noexcept
+    {
+        const std::size_t base = n_ / parts_;
+        const std::size_t extra = n_ % parts_;
+        return basic_stream<Chunk>(base + (i < extra ? 1u : 0u), i * base + (i < extra ? i : extra));
+    }
+
+private:
+    std::size_t n_;
+    std::size_t parts_;
+};
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DECLARATIONS
+ ****************************************************************************
+*/
+
+/**
+ * @brief Lazy range of @p n fresh IDs, generated a chunk at a time.
+ */
+inline basic_stream<> stream(std::size_t n) noexcept
+{
+    return basic_stream<>(n);
+}
+
+/**
+ * @brief @p n fresh IDs as @p parts independent streams, for parallel
+ * algorithms.
+ */
+inline basic_split<> split(std::size_t n, std::size_t parts) noexcept
+{
+    return basic_split<>(n, parts);
+}
+
+}  // namespace uuid7
+
+#endif  // UUID7_HPP
@@ -0,0 +1,195 @@
+/**
+ * @file uuid7_age.h
+ * @brief Streaming quantile sketch of ID age, for end-to-end pipeline timing.
+ *
+ * Every UUIDv7 carries its creation ms, so a pipeline stage can measure
+ * end-to-end latency as "now minus ID time" without a timestamp field. A
+ * sketch records the ages of the IDs a stage sees and answers quantile
+ * queries; one sketch per stage gives per-stage p50/p99/p99.9.
+ *
+ * Ages are counted in log-linear buckets (HDR style): exact up to 127 ms,
+ * then 64 buckets per power of two, so a reported quantile is within 1% of
+ * the true value. Ages of 2^40 ms (about 35 years) and more share the last
+ * bucket; IDs newer than the clock (clock skew between hosts) count as age
+ * 0 and are reported in the stats.
+ *
+ * Recording is lock-free: each thread adds to its own shard of counters,
+ * and readers sum the shards. Sketches merge by adding counts, also across
+ * processes through `uuid7_age_export()` and `uuid7_age_import()`.
+ *
+ * @author  Roman Horshkov <roman.horshkov@gmail.com>
+ * @date    2025
+ * (c) 2025
+ */
+
+#ifndef UUID7_AGE_H
+#define UUID7_AGE_H
+
+#include "uuid7.h" /* uuid_clock_fn_t */
+
+#include <stdint.h>
+#include <stddef.h> /* size_t */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * PUBLIC DEFINES
+ ****************************************************************************
+ */
+
+/** Counters of one sketch, the length of an exported bucket array */
+#define UUID7_AGE_BUCKETS 2240u
+
+/****************************************************************************
+ * PUBLIC STRUCTURED VARIABLES
+ ****************************************************************************
+*/
+
+/**
+ * @brief Sketch configuration. Fill with `uuid7_age_config_init()` and
+ * override the fields you need.
+ */
+typedef struct uuid7_age_config
+{
+    uint32_t shards;          /**< per-thread counter sets, 1 .. 256 (default 16) */
+    uuid_clock_fn_t clock_fn; /**< time source, NULL: CLOCK_REALTIME */
+} uuid7_age_config_t;
+
+/** Summary reported by `uuid7_age_get_stats()`. */
+typedef struct uuid7_age_stats
+{
+    uint64_t count;   /**< ages recorded */
+    uint64_t future;  /**< IDs newer than the clock, counted as age 0 */
+    uint64_t p50_ms;  /**< median age */
+    uint64_t p99_ms;  /**< 99th percentile */
+    uint64_t p999_ms; /**< 99.9th percentile */
+    uint64_t max_ms;  /**< upper end of the highest non-empty bucket */
+} uuid7_age_stats_t;
+
+/** Opaque sketch. */
+typedef struct uuid7_age uuid7_age_t;
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DECLARATIONS
+ ****************************************************************************
+*/
+
+/**
+ * @brief Fill @p cfg with defaults (16 shards, realtime clock).
+ *
+ * @param[out] cfg  Configuration to initialize.
+ */
+void uuid7_age_config_init(uuid7_age_config_t* cfg);
+
+/**
+ * @brief Create an empty sketch.
+ *
+ * @param[in] cfg  Configuration (copied).
+ * @return New sketch, or NULL on invalid configuration or allocation failure.
+ */
+uuid7_age_t* uuid7_age_create(const uuid7_age_config_t* cfg);
+
+/**
+ * @brief Free a sketch. No other call may be in progress.
+ *
+ * @param[in] age  Sketch, may be NULL.
+ */
+void uuid7_age_destroy(uuid7_age_t* age);
+
+/**
+ * @brief Record the age of one ID against the current time.
+ *
+ * @param[in,out] age  Sketch.
+ * @param[in]     id   16-byte ID.
+ * @return 0 on success, -1 on bad arguments.
+ */
+int uuid7_age_record(uuid7_age_t* age, const uint8_t* id);
+
+/**
+ * @brief Record the ages of a batch. The clock is read once for the whole
+ * batch, and runs of IDs in the same bucket cost one counter update.
+ *
+ * @param[in,out] age  Sketch.
+ * @param[in]     ids  @p n packed 16-byte IDs.
+ * @param[in]     n    Number of IDs.
+ * @return 0 on success, -1 on bad arguments.
+ */
+int uuid7_age_record_n(uuid7_age_t* age, const uint8_t* ids, size_t n);
+
+/**
+ * @brief Record the ages of a batch against a caller-supplied time, e.g. a
+ * clock the caller already reads once per poll loop.
+ *
+ * @param[in,out] age     Sketch.
+ * @param[in]     ids     @p n packed 16-byte IDs.
+ * @param[in]     n       Number of IDs.
+ * @param[in]     now_ms  Unix time in ms.
+ * @return 0 on success, -1 on bad arguments.
+ */
+int uuid7_age_record_at(uuid7_age_t* age, const uint8_t* ids, size_t n, uint64_t now_ms);
+
+/**
+ * @brief Age at quantile @p q of the recorded ages.
+ *
+ * @param[in]  age  Sketch.
+ * @param[in]  q    Quantile in [0, 1].
+ * @param[out] ms   Age in ms (midpoint of the bucket holding the quantile).
+ * @return 0 on success, -1 on bad arguments or an empty sketch.
+ */
+int uuid7_age_quantile(const uuid7_age_t* age, double q, uint64_t* ms);
+
+/**
+ * @brief Count and p50/p99/p99.9 in one pass. Concurrent recording may or
+ * may not be included.
+ *
+ * @param[in]  age    Sketch.
+ * @param[out] stats  Summary; the quantiles are 0 for an empty sketch.
+ * @return 0 on success, -1 if an argument is NULL.
+ */
+int uuid7_age_get_stats(const uuid7_age_t* age, uuid7_age_stats_t* stats);
+
+/**
+ * @brief Copy the bucket counts and the future count out, optionally
+ * zeroing them.
+ *
+ * With @p reset, each counter is swapped for 0 atomically, so an interval
+ * exporter loses no concurrent records: each lands in this export or the
+ * next. The future count (IDs newer than the clock, already included in
+ * bucket 0) is only reset when @p future receives it.
+ *
+ * @param[in,out] age     Sketch.
+ * @param[out]    counts  `UUID7_AGE_BUCKETS` counters.
+ * @param[out]    future  Future count, or NULL to leave it in the sketch.
+ * @param[in]     reset   Non-zero to zero the sketch.
+ * @return 0 on success, -1 if @p age or @p counts is NULL.
+ */
+int uuid7_age_export(uuid7_age_t* age, uint64_t* counts, uint64_t* future, int reset);
+
+/**
+ * @brief Add exported counts to a sketch.
+ *
+ * @param[in,out] age     Sketch.
+ * @param[in]     counts  `UUID7_AGE_BUCKETS` counters.
+ * @param[in]     future  Future count exported with them.
+ * @return 0 on success, -1 if an argument is NULL.
+ */
+int uuid7_age_import(uuid7_age_t* age, const uint64_t* counts, uint64_t future);
+
+/**
+ * @brief Add the counts of @p src to @p dst, e.g. to roll stages or
+ * threads' sketches up into one.
+ *
+ * @param[in,out] dst  Sketch receiving the counts.
+ * @param[in]     src  Sketch to add; it is not modified.
+ * @return 0 on success, -1 on bad arguments (NULL, or @p dst == @p src).
+ */
+int uuid7_age_merge(uuid7_age_t* dst, const uuid7_age_t* src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UUID7_AGE_H
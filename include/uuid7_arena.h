@@ -0,0 +1,158 @@
+/**
+ * @file uuid7_arena.h
+ * @brief Time-bucketed arena allocator for objects keyed by UUIDv7.
+ *
+ * Session and dedup objects often live exactly as long as their ID's time
+ * window. The arena places each object in a chunk of the window its ID's
+ * ms falls in (`bucket_ms` wide), and frees objects only wholesale: once a
+ * window has expired, `uuid7_arena_release()` unmaps its chunks, or keeps
+ * a few of them to reset and reuse, in one step. Single objects are never
+ * freed, so there is no free path, no per-object header and no
+ * fragmentation.
+ *
+ * Allocation is a bump of the calling thread's current chunk in the
+ * window; only a new chunk takes the arena lock. `uuid7_arena_gen()`
+ * generates the ID and allocates its object in one call.
+ *
+ * Objects of a released window must no longer be used. Allocations for a
+ * released window fail, as do allocations whose window would share its
+ * slot with another live window (windows `max_windows` or more apart, with
+ * `max_windows` rounded up to a power of two).
+ *
+ * @author  Roman Horshkov <roman.horshkov@gmail.com>
+ * @date    2025
+ * (c) 2025
+ */
+
+#ifndef UUID7_ARENA_H
+#define UUID7_ARENA_H
+
+#include "uuid7.h" /* uuid_clock_fn_t */
+
+#include <stdint.h>
+#include <stddef.h> /* size_t */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * PUBLIC DEFINES
+ ****************************************************************************
+ */
+
+/** Alignment of every object */
+#define UUID7_ARENA_ALIGN 16u
+
+/****************************************************************************
+ * PUBLIC STRUCTURED VARIABLES
+ ****************************************************************************
+*/
+
+/**
+ * @brief Arena configuration. Fill with `uuid7_arena_config_init()` and
+ * override the fields you need.
+ */
+typedef struct uuid7_arena_config
+{
+    uint64_t bucket_ms;       /**< window width in ms (default 1000) */
+    size_t chunk_size;        /**< bytes per chunk, 4 KiB .. 1 GiB (default 1 MiB) */
+    uint32_t max_windows;     /**< live windows, 1 .. 65536, rounded up to a power of two (default 1024) */
+    uint32_t spare_chunks;    /**< released chunks kept for reuse (default 16) */
+    uint64_t retain_ms;       /**< release windows older than this when mapping, 0: only explicitly */
+    uuid_clock_fn_t clock_fn; /**< time source for `retain_ms`, NULL: CLOCK_REALTIME */
+} uuid7_arena_config_t;
+
+/** Counters reported by `uuid7_arena_get_stats()`. */
+typedef struct uuid7_arena_stats
+{
+    uint64_t bytes;        /**< bytes allocated in live windows, rounded to the alignment */
+    uint64_t rejected;     /**< allocations refused (released or conflicting window) */
+    uint64_t windows;      /**< live windows */
+    uint64_t released;     /**< windows released so far */
+    uint64_t chunks;       /**< chunks of live windows */
+    uint64_t mapped_bytes; /**< memory of live, spare and not yet unmapped chunks */
+} uuid7_arena_stats_t;
+
+/** Opaque arena. */
+typedef struct uuid7_arena uuid7_arena_t;
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DECLARATIONS
+ ****************************************************************************
+*/
+
+/**
+ * @brief Fill @p cfg with defaults (1 s windows, 1 MiB chunks, 1024
+ * windows, 16 spare chunks, no automatic release, realtime clock).
+ *
+ * @param[out] cfg  Configuration to initialize.
+ */
+void uuid7_arena_config_init(uuid7_arena_config_t* cfg);
+
+/**
+ * @brief Create an empty arena.
+ *
+ * @param[in] cfg  Configuration (copied).
+ * @return New arena, or NULL on invalid configuration or allocation failure.
+ */
+uuid7_arena_t* uuid7_arena_create(const uuid7_arena_config_t* cfg);
+
+/**
+ * @brief Unmap every chunk and free the arena. No other call may be in
+ * progress.
+ *
+ * @param[in] a  Arena, may be NULL.
+ */
+void uuid7_arena_destroy(uuid7_arena_t* a);
+
+/**
+ * @brief Allocate @p size bytes in the window of @p id. Lock-free unless
+ * the calling thread needs a new chunk. Any number of threads.
+ *
+ * @param[in,out] a     Arena.
+ * @param[in]     id    16-byte ID whose ms selects the window.
+ * @param[in]     size  Bytes (0 is rounded up to the alignment).
+ * @return `UUID7_ARENA_ALIGN`-aligned memory, valid until the window is
+ *         released; NULL on bad arguments, a refused window or mapping
+ *         failure.
+ */
+void* uuid7_arena_alloc(uuid7_arena_t* a, const uint8_t* id, size_t size);
+
+/**
+ * @brief Generate a UUIDv7 with `uuid7_gen()` and allocate its object.
+ *
+ * @param[in,out] a     Arena.
+ * @param[out]    id    16-byte ID of the object.
+ * @param[in]     size  Bytes.
+ * @return As for `uuid7_arena_alloc()`; @p id is set even if the
+ *         allocation fails.
+ */
+void* uuid7_arena_gen(uuid7_arena_t* a, uint8_t* id, size_t size);
+
+/**
+ * @brief Release every window that ends at or before @p before_ms: its
+ * chunks are unmapped, or kept as spares, once no thread can still be
+ * allocating from them.
+ *
+ * @param[in,out] a          Arena.
+ * @param[in]     before_ms  Unix time in ms.
+ * @return Number of windows released.
+ */
+size_t uuid7_arena_release(uuid7_arena_t* a, uint64_t before_ms);
+
+/**
+ * @brief Read the counters. Takes the arena lock to sum the live chunks.
+ *
+ * @param[in]  a      Arena.
+ * @param[out] stats  Counters snapshot.
+ * @return 0 on success, -1 if an argument is NULL.
+ */
+int uuid7_arena_get_stats(uuid7_arena_t* a, uuid7_arena_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UUID7_ARENA_H
@@ -0,0 +1,145 @@
+/**
+ * @file uuid7_dict.h
+ * @brief Dictionary encoding for columns of repeated UUIDv7 values.
+ *
+ * Foreign-key columns often repeat a few thousand distinct IDs millions of
+ * times. The encoder collects the distinct IDs into a sorted dictionary and
+ * replaces each value by its dictionary index, bit-packed at
+ * `ceil(log2(size))` bits: a 16-byte ID becomes 12 bits for a 4096-entry
+ * dictionary. The decoder expands packed indexes back into 16-byte IDs.
+ *
+ * Packed layout: index `i` occupies bits `[i * bits, (i + 1) * bits)` of
+ * the stream, where bit `k` is bit `k % 64` of word `k / 64` (LSB first).
+ * To store a column, write the dictionary entries (`uuid7_dict_entries()`)
+ * and the packed words; reopen it with `uuid7_dict_load()`.
+ *
+ * A dictionary is immutable once built; any number of threads may encode
+ * and decode with it concurrently.
+ *
+ * @author  Roman Horshkov <roman.horshkov@gmail.com>
+ * @date    2025
+ * (c) 2025
+ */
+
+#ifndef UUID7_DICT_H
+#define UUID7_DICT_H
+
+#include <stdint.h>
+#include <stddef.h> /* size_t */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * PUBLIC DEFINES
+ ****************************************************************************
+ */
+/* None */
+
+/****************************************************************************
+ * PUBLIC STRUCTURED VARIABLES
+ ****************************************************************************
+*/
+
+/** Opaque dictionary. */
+typedef struct uuid7_dict uuid7_dict_t;
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DECLARATIONS
+ ****************************************************************************
+*/
+
+/**
+ * @brief Build the dictionary of the distinct IDs of a column.
+ *
+ * Values arriving in ID order (the order `uuid7_gen()` issues them) are
+ * appended directly; out-of-order values are looked up in the sorted part
+ * and only new ones are sorted and merged in. Building costs
+ * O(n log d) for d distinct IDs, and one pass when the column is sorted.
+ *
+ * @param[in] ids  @p n packed 16-byte IDs, any order, repeats allowed.
+ * @param[in] n    Number of IDs (may be 0).
+ * @return New dictionary, or NULL on bad arguments, allocation failure or
+ *         more than 2^32 - 1 distinct IDs.
+ */
+uuid7_dict_t* uuid7_dict_build(const uint8_t* ids, size_t n);
+
+/**
+ * @brief Rebuild a dictionary from stored entries.
+ *
+ * @param[in] entries  @p n packed 16-byte IDs, strictly ascending.
+ * @param[in] n        Number of entries.
+ * @return New dictionary, or NULL on bad arguments, unsorted or duplicate
+ *         entries, or allocation failure.
+ */
+uuid7_dict_t* uuid7_dict_load(const uint8_t* entries, size_t n);
+
+/**
+ * @brief Free a dictionary.
+ *
+ * @param[in] d  Dictionary, may be NULL.
+ */
+void uuid7_dict_destroy(uuid7_dict_t* d);
+
+/**
+ * @brief Number of distinct IDs.
+ */
+size_t uuid7_dict_size(const uuid7_dict_t* d);
+
+/**
+ * @brief Width of one packed index: `ceil(log2(size))`, at least 1.
+ */
+unsigned uuid7_dict_bits(const uuid7_dict_t* d);
+
+/**
+ * @brief The sorted entries, `16 * uuid7_dict_size()` bytes, for storage.
+ */
+const uint8_t* uuid7_dict_entries(const uuid7_dict_t* d);
+
+/**
+ * @brief 64-bit words needed to pack @p n indexes.
+ */
+size_t uuid7_dict_packed_words(const uuid7_dict_t* d, size_t n);
+
+/**
+ * @brief Find the index of an ID in the sorted entries.
+ *
+ * @param[in]  d      Dictionary.
+ * @param[in]  id     16-byte ID.
+ * @param[out] index  Position in the sorted entries.
+ * @return 0 if found, -1 if absent or on bad arguments.
+ */
+int uuid7_dict_find(const uuid7_dict_t* d, const uint8_t* id, uint32_t* index);
+
+/**
+ * @brief Encode a column as bit-packed dictionary indexes.
+ *
+ * @param[in]  d       Dictionary holding every ID of the column.
+ * @param[in]  ids     @p n packed 16-byte IDs.
+ * @param[in]  n       Number of IDs.
+ * @param[out] packed  `uuid7_dict_packed_words(d, n)` words; unused high
+ *                     bits of the last word are zeroed.
+ * @return 0 on success, -1 on bad arguments or if an ID is not in @p d
+ *         (the output is then incomplete).
+ */
+int uuid7_dict_encode(const uuid7_dict_t* d, const uint8_t* ids, size_t n, uint64_t* packed);
+
+/**
+ * @brief Expand bit-packed indexes back into 16-byte IDs.
+ *
+ * @param[in]  d       Dictionary the column was encoded with.
+ * @param[in]  packed  Packed indexes.
+ * @param[in]  n       Number of IDs to decode.
+ * @param[out] ids     Room for 16 * @p n bytes.
+ * @return 0 on success, -1 on bad arguments or an index out of range
+ *         (corrupt input; the output is then incomplete).
+ */
+int uuid7_dict_decode(const uuid7_dict_t* d, const uint64_t* packed, size_t n, uint8_t* ids);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UUID7_DICT_H
@@ -0,0 +1,193 @@
+/**
+ * @file uuid7_log.h
+ * @brief Lock-free append-only in-memory event log indexed by UUIDv7.
+ *
+ * Appending generates the event's ID and reserves its slot in one atomic
+ * step, so the log is physically in ID order: position order is ID order,
+ * and "events since ID X" or "events in [t0, t1)" are a search plus a
+ * sequential read. Appenders and readers never take locks.
+ *
+ * Records are fixed-size and copied into memory-mapped segments of
+ * `segment_records` slots. Full segments are retired by age, either
+ * explicitly with `uuid7_log_retire()` or automatically when the log rolls
+ * to a new segment (`retain_ms`); their memory is unmapped once no reader
+ * or appender is inside the log.
+ *
+ * The IDs are UUIDv7 with the usual layout, drawn from the log's own
+ * (ms, seq) sequence and the library's random tail. They order among
+ * themselves; they are not sequenced against `uuid7_gen()`.
+ *
+ * Positions are 64-bit record numbers that only grow. A reader keeps a
+ * cursor; if the records under it were retired, the next read resumes at
+ * the oldest live record.
+ *
+ * @author  Roman Horshkov <roman.horshkov@gmail.com>
+ * @date    2025
+ * (c) 2025
+ */
+
+#ifndef UUID7_LOG_H
+#define UUID7_LOG_H
+
+#include "uuid7.h" /* uuid_clock_fn_t */
+
+#include <stdint.h>
+#include <stddef.h> /* size_t */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * PUBLIC DEFINES
+ ****************************************************************************
+ */
+/* None */
+
+/****************************************************************************
+ * PUBLIC STRUCTURED VARIABLES
+ ****************************************************************************
+*/
+
+/**
+ * @brief Log configuration. Fill with `uuid7_log_config_init()` and
+ * override the fields you need.
+ */
+typedef struct uuid7_log_config
+{
+    size_t record_size;       /**< bytes copied per append, may be 0 (default 64) */
+    uint32_t segment_records; /**< slots per segment, 1 .. 2^20 - 1 (default 65536) */
+    uint32_t max_segments;    /**< live segments before appends fail (default 1024) */
+    uint64_t retain_ms;       /**< retire segments older than this on roll, 0: only explicitly */
+    uuid_clock_fn_t clock_fn; /**< time source, NULL: CLOCK_REALTIME */
+} uuid7_log_config_t;
+
+/** Read position. Set by the seek functions, advanced by `uuid7_log_read()`. */
+typedef struct uuid7_log_cursor
+{
+    uint64_t pos;    /**< next record number */
+    uint64_t min_hi; /**< records below (min_hi, min_lo) are skipped */
+    uint64_t min_lo;
+} uuid7_log_cursor_t;
+
+/** Counters reported by `uuid7_log_get_stats()`. */
+typedef struct uuid7_log_stats
+{
+    uint64_t records;      /**< readable records in live segments */
+    uint64_t segments;     /**< live segments */
+    uint64_t retired;      /**< segments retired so far */
+    uint64_t rejected;     /**< appends refused because max_segments were live */
+    uint64_t mapped_bytes; /**< memory of live and not yet unmapped segments */
+} uuid7_log_stats_t;
+
+/** Opaque log. */
+typedef struct uuid7_log uuid7_log_t;
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DECLARATIONS
+ ****************************************************************************
+*/
+
+/**
+ * @brief Fill @p cfg with defaults (64-byte records, 65536 per segment,
+ * 1024 segments, no automatic retirement, realtime clock).
+ *
+ * @param[out] cfg  Configuration to initialize.
+ */
+void uuid7_log_config_init(uuid7_log_config_t* cfg);
+
+/**
+ * @brief Create a log with one empty segment.
+ *
+ * @param[in] cfg  Configuration (copied).
+ * @return New log, or NULL on invalid configuration or allocation failure.
+ */
+uuid7_log_t* uuid7_log_create(const uuid7_log_config_t* cfg);
+
+/**
+ * @brief Unmap every segment and free the log. No other call may be in
+ * progress.
+ *
+ * @param[in] log  Log, may be NULL.
+ */
+void uuid7_log_destroy(uuid7_log_t* log);
+
+/**
+ * @brief Generate the next ID and append a record under it. Lock-free,
+ * any number of threads.
+ *
+ * @param[in,out] log     Log.
+ * @param[in]     record  `record_size` bytes to copy (may be NULL if 0).
+ * @param[out]    id      16-byte ID of the record.
+ * @return 0 on success, -1 on bad arguments, if `max_segments` segments are
+ *         live and none can be retired, or if a segment cannot be mapped.
+ */
+int uuid7_log_append(uuid7_log_t* log, const void* record, uint8_t* id);
+
+/**
+ * @brief Position @p cur on the first record whose ID is greater than @p id.
+ *
+ * Recent IDs resolve to the newest segment and cost one interpolation
+ * search; older ones first bisect the segments. Records appended later but
+ * ordered before the target are skipped by reads through this cursor.
+ *
+ * @param[in]  log  Log.
+ * @param[in]  id   16-byte ID, or NULL for the oldest live record.
+ * @param[out] cur  Cursor.
+ * @return 0 on success, -1 on bad arguments.
+ */
+int uuid7_log_since(uuid7_log_t* log, const uint8_t* id, uuid7_log_cursor_t* cur);
+
+/**
+ * @brief Position @p cur on the first record created at or after @p ms.
+ * With `uuid7_log_read()`'s @p end_ms this answers time-range queries.
+ *
+ * @param[in]  log  Log.
+ * @param[in]  ms   Unix time in ms.
+ * @param[out] cur  Cursor.
+ * @return 0 on success, -1 on bad arguments.
+ */
+int uuid7_log_since_ms(uuid7_log_t* log, uint64_t ms, uuid7_log_cursor_t* cur);
+
+/**
+ * @brief Copy records from @p cur onwards, in ID order, and advance it.
+ * Lock-free; stops at the first record whose append is still in progress.
+ *
+ * @param[in]     log      Log.
+ * @param[in,out] cur      Cursor.
+ * @param[in]     end_ms   Stop before the first record created at or after
+ *                         this time; UINT64_MAX for no bound.
+ * @param[out]    ids      Room for 16 * @p max bytes of IDs (may be NULL).
+ * @param[out]    records  Room for @p max records (may be NULL).
+ * @param[in]     max      Capacity of the output arrays.
+ * @return Number of records copied.
+ */
+size_t uuid7_log_read(uuid7_log_t* log, uuid7_log_cursor_t* cur, uint64_t end_ms, uint8_t* ids, void* records,
+                      size_t max);
+
+/**
+ * @brief Retire full segments whose newest record is older than
+ * @p before_ms, oldest first, and unmap retired segments no thread can
+ * still be reading. Returns 0 if another thread is retiring.
+ *
+ * @param[in,out] log        Log.
+ * @param[in]     before_ms  Unix time in ms.
+ * @return Number of segments retired by this call.
+ */
+size_t uuid7_log_retire(uuid7_log_t* log, uint64_t before_ms);
+
+/**
+ * @brief Read the counters.
+ *
+ * @param[in]  log    Log.
+ * @param[out] stats  Counters snapshot.
+ * @return 0 on success, -1 if an argument is NULL.
+ */
+int uuid7_log_get_stats(uuid7_log_t* log, uuid7_log_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UUID7_LOG_H
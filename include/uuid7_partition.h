@@ -0,0 +1,157 @@
+/**
+ * @file uuid7_partition.h
+ * @brief Route UUIDv7-keyed records into time-bucket output files.
+ *
+ * @author  Roman Horshkov <roman.horshkov@gmail.com>
+ * @date    2025
+ * (c) 2025
+ */
+
+#ifndef UUID7_PARTITION_H
+#define UUID7_PARTITION_H
+
+#include <stdint.h>
+#include <stddef.h> /* size_t */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * PUBLIC DEFINES
+ ****************************************************************************
+ */
+
+/** Common bucket widths in milliseconds. */
+#define UUID7_PART_MINUTE_MS 60000ull
+#define UUID7_PART_HOUR_MS   3600000ull
+#define UUID7_PART_DAY_MS    86400000ull
+
+/****************************************************************************
+ * PUBLIC STRUCTURED VARIABLES
+ ****************************************************************************
+*/
+
+/** Input record layout. */
+typedef enum uuid7_part_format
+{
+    UUID7_PART_TEXT = 0,   /**< newline-terminated lines, ID in a delimited column */
+    UUID7_PART_BINARY = 1, /**< fixed-width records, 16-byte binary ID at an offset */
+} uuid7_part_format_t;
+
+/**
+ * @brief Partitioner configuration. Fill with `uuid7_part_config_init()`
+ * and override the fields you need.
+ */
+typedef struct uuid7_part_config
+{
+    const char* out_dir;        /**< existing directory receiving bucket files */
+    const char* prefix;         /**< bucket file name prefix (may be NULL) */
+    const char* suffix;         /**< bucket file name suffix, e.g. ".csv" (may be NULL) */
+    uint64_t bucket_ms;         /**< bucket width in ms (default: one hour) */
+    uuid7_part_format_t format; /**< input layout (default: text) */
+    size_t record_size;         /**< binary: record width in bytes */
+    size_t id_offset;           /**< binary: offset of the 16-byte ID in a record */
+    unsigned id_column;         /**< text: 0-based column holding the ID string */
+    char delimiter;             /**< text: column delimiter (default ',') */
+    size_t max_open_files;      /**< bound of the open-file LRU (default 64) */
+    size_t buffer_size;         /**< per-bucket write buffer in bytes (default 1 MiB) */
+    unsigned threads;           /**< parse threads, 0 = online CPUs */
+} uuid7_part_config_t;
+
+/** Counters reported by `uuid7_part_get_stats()`. */
+typedef struct uuid7_part_stats
+{
+    uint64_t records;       /**< records routed to a time bucket */
+    uint64_t rejected;      /**< records without a parsable ID (sent to "invalid") */
+    uint64_t bytes_written; /**< bytes handed to write(2) */
+    uint64_t files_opened;  /**< bucket files opened, including re-opens */
+    uint64_t evictions;     /**< files closed by the LRU to honour the bound */
+} uuid7_part_stats_t;
+
+/** Opaque partitioner handle. */
+typedef struct uuid7_part uuid7_part_t;
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DECLARATIONS
+ ****************************************************************************
+*/
+
+/**
+ * @brief Fill @p cfg with defaults (hourly text buckets, ',' delimiter,
+ * column 0, 64 open files, 1 MiB buffers, one thread per CPU).
+ *
+ * @param[out] cfg  Configuration to initialize.
+ */
+void uuid7_part_config_init(uuid7_part_config_t* cfg);
+
+/**
+ * @brief Create a partitioner.
+ *
+ * Bucket files are named `<out_dir>/<prefix><UTC bucket start><suffix>`,
+ * where the start is formatted as coarsely as the bucket width allows
+ * (`2025-01-31`, `2025-01-31T13`, `2025-01-31T1305`, ...). Records whose ID
+ * is not a UUIDv7 (a malformed or truncated text ID, or any ID without the
+ * v7 version and variant bits) go to `<prefix>invalid<suffix>`. Files are
+ * opened in append mode, so an evicted bucket is simply re-opened when it
+ * is needed again.
+ *
+ * @param[in] cfg  Configuration; copied, strings must outlive the handle.
+ * @return New handle, or NULL on invalid configuration or allocation failure.
+ */
+uuid7_part_t* uuid7_part_create(const uuid7_part_config_t* cfg);
+
+/**
+ * @brief Partition a block of input.
+ *
+ * Only whole records are consumed: for text input everything up to the last
+ * newline, for binary input a multiple of `record_size`. The caller keeps the
+ * unconsumed tail and passes it again with the next block. With @p last set,
+ * an unterminated final text line is consumed too (a newline is appended in
+ * its bucket file); a trailing partial binary record is counted as rejected.
+ *
+ * Records are parsed in parallel chunks and appended to their bucket buffers
+ * in input order, so every bucket file preserves the input order.
+ *
+ * Not thread-safe: use one handle per producer.
+ *
+ * @param[in]  p         Partitioner.
+ * @param[in]  data      Input bytes.
+ * @param[in]  len       Number of input bytes.
+ * @param[in]  last      Non-zero if this is the final block of the stream.
+ * @param[out] consumed  Number of bytes consumed (may be NULL).
+ * @return 0 on success, -1 on error (errno is set).
+ */
+int uuid7_part_write(uuid7_part_t* p, const void* data, size_t len, int last, size_t* consumed);
+
+/**
+ * @brief Write all buffered bytes to their bucket files.
+ *
+ * @param[in] p  Partitioner.
+ * @return 0 on success, -1 on error (errno is set).
+ */
+int uuid7_part_flush(uuid7_part_t* p);
+
+/**
+ * @brief Read the partitioner counters.
+ *
+ * @param[in]  p      Partitioner.
+ * @param[out] stats  Counters snapshot.
+ * @return 0 on success, -1 if an argument is NULL.
+ */
+int uuid7_part_get_stats(const uuid7_part_t* p, uuid7_part_stats_t* stats);
+
+/**
+ * @brief Flush, close every bucket file and free the partitioner.
+ *
+ * @param[in] p  Partitioner (NULL is accepted).
+ * @return 0 on success, -1 if a final flush or close failed.
+ */
+int uuid7_part_close(uuid7_part_t* p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UUID7_PARTITION_H
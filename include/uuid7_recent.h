@@ -0,0 +1,157 @@
+/**
+ * @file uuid7_recent.h
+ * @brief Direct-mapped lookup table for recently issued UUIDv7 values.
+ *
+ * Objects created in the last few seconds are found without hashing: the
+ * (ms, seq) pair the generator handed out already is a dense index. The
+ * table is a ring of `window_ms` milliseconds, each with `seq_sets` sets of
+ * two slots, and an ID lives in set `(ms mod window_ms, seq mod seq_sets)`.
+ * A set is one cache line, so a lookup is a single line read plus a full-ID
+ * check. Two ways absorb most collisions, since the generator's sequence
+ * starts at a random point each ms and may jump forward. IDs that fell out
+ * of the window or were displaced go to a caller-provided slow path.
+ *
+ * Size `seq_sets` for the peak issue rate: a ms holds about 2 * seq_sets
+ * IDs before they start displacing each other.
+ *
+ * @author  Roman Horshkov <roman.horshkov@gmail.com>
+ * @date    2025
+ * (c) 2025
+ */
+
+#ifndef UUID7_RECENT_H
+#define UUID7_RECENT_H
+
+#include <stdint.h>
+#include <stddef.h> /* size_t */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * PUBLIC DEFINES
+ ****************************************************************************
+ */
+/* None */
+
+/****************************************************************************
+ * PUBLIC STRUCTURED VARIABLES
+ ****************************************************************************
+*/
+
+/**
+ * @brief Slow-path lookup for IDs the table does not hold.
+ *
+ * @param[in] id   16-byte ID.
+ * @param[in] ctx  `miss_ctx` from the configuration.
+ * @return The object, or NULL if unknown.
+ */
+typedef void* (*uuid7_recent_miss_fn_t)(const uint8_t* id, void* ctx);
+
+/**
+ * @brief Table configuration. Fill with `uuid7_recent_config_init()` and
+ * override the fields you need.
+ */
+typedef struct uuid7_recent_config
+{
+    uint32_t window_ms;             /**< ms kept, power of two (default 2048) */
+    uint32_t seq_sets;              /**< 2-slot sets per ms, power of two, <= 4096 (default 32) */
+    uuid7_recent_miss_fn_t miss_fn; /**< slow path, may be NULL */
+    void* miss_ctx;                 /**< passed to @p miss_fn */
+} uuid7_recent_config_t;
+
+/** Counters reported by `uuid7_recent_get_stats()`. */
+typedef struct uuid7_recent_stats
+{
+    uint64_t slots;     /**< table size: window_ms * seq_sets * 2 */
+    uint64_t evictions; /**< inserts that overwrote a different live ID */
+    uint64_t misses;    /**< lookups not served by the table */
+} uuid7_recent_stats_t;
+
+/** Opaque table. */
+typedef struct uuid7_recent uuid7_recent_t;
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DECLARATIONS
+ ****************************************************************************
+*/
+
+/**
+ * @brief Fill @p cfg with defaults (2048 ms x 32 sets, 4 MiB, no slow path).
+ *
+ * @param[out] cfg  Configuration to initialize.
+ */
+void uuid7_recent_config_init(uuid7_recent_config_t* cfg);
+
+/**
+ * @brief Create a table.
+ *
+ * @param[in] cfg  Configuration (copied).
+ * @return New table, or NULL on invalid configuration or allocation failure.
+ */
+uuid7_recent_t* uuid7_recent_create(const uuid7_recent_config_t* cfg);
+
+/**
+ * @brief Free a table. Registered objects are not touched.
+ *
+ * @param[in] r  Table, may be NULL.
+ */
+void uuid7_recent_destroy(uuid7_recent_t* r);
+
+/**
+ * @brief Generate a UUIDv7 with `uuid7_gen()` and register @p obj under it.
+ *
+ * @param[in,out] r    Table.
+ * @param[out]    id   16-byte output.
+ * @param[in]     obj  Object to register (non-NULL).
+ * @return 0 on success, -1 on bad arguments.
+ */
+int uuid7_recent_gen(uuid7_recent_t* r, uint8_t* id, void* obj);
+
+/**
+ * @brief Register @p obj under an existing ID. Takes a free slot of the
+ * set if there is one, else displaces the older occupant. Safe concurrently
+ * with every other call.
+ *
+ * @param[in,out] r    Table.
+ * @param[in]     id   16-byte ID.
+ * @param[in]     obj  Object to register (non-NULL).
+ * @return 0 on success, -1 on bad arguments.
+ */
+int uuid7_recent_insert(uuid7_recent_t* r, const uint8_t* id, void* obj);
+
+/**
+ * @brief Find the object of @p id: from its set if a slot still holds this
+ * exact ID, otherwise through the slow path. Lock-free.
+ *
+ * @param[in] r   Table.
+ * @param[in] id  16-byte ID.
+ * @return The object, or NULL if neither the table nor the slow path knows it.
+ */
+void* uuid7_recent_get(uuid7_recent_t* r, const uint8_t* id);
+
+/**
+ * @brief Unregister @p id if its set still holds it.
+ *
+ * @param[in,out] r   Table.
+ * @param[in]     id  16-byte ID.
+ * @return 0 if removed, -1 if not present or on bad arguments.
+ */
+int uuid7_recent_remove(uuid7_recent_t* r, const uint8_t* id);
+
+/**
+ * @brief Read the counters.
+ *
+ * @param[in]  r      Table.
+ * @param[out] stats  Counters snapshot.
+ * @return 0 on success, -1 if an argument is NULL.
+ */
+int uuid7_recent_get_stats(const uuid7_recent_t* r, uuid7_recent_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UUID7_RECENT_H
@@ -0,0 +1,147 @@
+/**
+ * @file uuid7_reorder.h
+ * @brief Bounded-skew reorder buffer that re-sequences events by UUIDv7.
+ *
+ * Producers on any thread push (ID, payload) pairs as events arrive, in
+ * whatever order the network delivered them. One consumer drains them in
+ * strict ID order: an event is released once the watermark, i.e. the
+ * current time minus the configured skew window, has passed its embedded
+ * millisecond. Events that arrive after a later ID was already released are
+ * counted as late and either delivered immediately or dropped.
+ *
+ * @author  Roman Horshkov <roman.horshkov@gmail.com>
+ * @date    2025
+ * (c) 2025
+ */
+
+#ifndef UUID7_REORDER_H
+#define UUID7_REORDER_H
+
+#include <stdint.h>
+#include <stddef.h> /* size_t */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * PUBLIC DEFINES
+ ****************************************************************************
+ */
+/* None */
+
+/****************************************************************************
+ * PUBLIC STRUCTURED VARIABLES
+ ****************************************************************************
+*/
+
+/**
+ * @brief Reorder buffer configuration. Fill with
+ * `uuid7_reorder_config_init()` and override the fields you need.
+ */
+typedef struct uuid7_reorder_config
+{
+    uint64_t skew_ms; /**< how long an event is held for stragglers (default 50) */
+    size_t capacity;  /**< ingress ring slots, rounded up to a power of two (default 65536) */
+    int drop_late;    /**< non-zero: discard late events instead of delivering them */
+} uuid7_reorder_config_t;
+
+/** Counters reported by `uuid7_reorder_get_stats()`. */
+typedef struct uuid7_reorder_stats
+{
+    uint64_t pushed;       /**< events accepted by push */
+    uint64_t rejected;     /**< pushes refused because the ingress ring was full */
+    uint64_t emitted;      /**< events handed out by drain/flush, late ones included */
+    uint64_t late;         /**< events older than an ID already emitted */
+    uint64_t dropped;      /**< late events discarded (drop_late) */
+    uint64_t held;         /**< events currently waiting for the watermark */
+    uint64_t watermark_ms; /**< watermark of the last drain */
+} uuid7_reorder_stats_t;
+
+/** Opaque reorder buffer. */
+typedef struct uuid7_reorder uuid7_reorder_t;
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DECLARATIONS
+ ****************************************************************************
+*/
+
+/**
+ * @brief Fill @p cfg with defaults (50 ms skew, 65536 ingress slots, late
+ * events delivered).
+ *
+ * @param[out] cfg  Configuration to initialize.
+ */
+void uuid7_reorder_config_init(uuid7_reorder_config_t* cfg);
+
+/**
+ * @brief Create a reorder buffer.
+ *
+ * @param[in] cfg  Configuration (copied).
+ * @return New buffer, or NULL on invalid configuration or allocation failure.
+ */
+uuid7_reorder_t* uuid7_reorder_create(const uuid7_reorder_config_t* cfg);
+
+/**
+ * @brief Free a reorder buffer. Held payloads are not touched.
+ *
+ * @param[in] r  Buffer, may be NULL.
+ */
+void uuid7_reorder_destroy(uuid7_reorder_t* r);
+
+/**
+ * @brief Hand an event to the buffer. Lock-free, any number of threads.
+ *
+ * The event sits in a bounded ingress ring until the consumer's next drain
+ * moves it into the ordering structure.
+ *
+ * @param[in,out] r      Buffer.
+ * @param[in]     id     16-byte UUIDv7 of the event.
+ * @param[in]     value  Caller payload returned by drain.
+ * @return 0 on success, -1 on bad arguments or if the ingress ring is full
+ *         (drain more often or raise `capacity`).
+ */
+int uuid7_reorder_push(uuid7_reorder_t* r, const uint8_t* id, void* value);
+
+/**
+ * @brief Release up to @p max events that are past the watermark, in ID
+ * order. Single consumer: never call concurrently with itself or flush.
+ *
+ * The watermark is `now_ms - skew_ms`; an event is released once its
+ * embedded ms is at or below it. Pass the wall clock as @p now_ms, or 0 to
+ * run on event time (the highest ms pushed so far), which needs no clock
+ * and suits replays. Late events come out first, ahead of the in-order ones.
+ *
+ * @param[in,out] r       Buffer.
+ * @param[in]     now_ms  Current Unix time in ms, or 0 for event time.
+ * @param[out]    ids     Room for 16 * @p max bytes of IDs.
+ * @param[out]    values  Room for @p max payloads (may be NULL).
+ * @param[in]     max     Capacity of the output arrays.
+ * @return Number of events written.
+ */
+size_t uuid7_reorder_drain(uuid7_reorder_t* r, uint64_t now_ms, uint8_t* ids, void** values, size_t max);
+
+/**
+ * @brief Release up to @p max held events in ID order, ignoring the
+ * watermark (shutdown, end of a replay). Same threading rule as drain.
+ *
+ * @return Number of events written.
+ */
+size_t uuid7_reorder_flush(uuid7_reorder_t* r, uint8_t* ids, void** values, size_t max);
+
+/**
+ * @brief Read the counters. The consumer-side fields are exact when called
+ * from the consumer thread.
+ *
+ * @param[in]  r      Buffer.
+ * @param[out] stats  Counters snapshot.
+ * @return 0 on success, -1 if an argument is NULL.
+ */
+int uuid7_reorder_get_stats(const uuid7_reorder_t* r, uuid7_reorder_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UUID7_REORDER_H
@@ -0,0 +1,124 @@
+/**
+ * @file uuid7_rheap.h
+ * @brief Radix-heap priority queue keyed by UUIDv7 values.
+ *
+ * A min-priority queue for workloads whose new keys are (almost) never
+ * smaller than the last popped key, which is what IDs fresh from the
+ * generator look like. Keys are the full 128-bit big-endian ID, so pop order
+ * is exactly `memcmp()` order.
+ *
+ * @author  Roman Horshkov <roman.horshkov@gmail.com>
+ * @date    2025
+ * (c) 2025
+ */
+
+#ifndef UUID7_RHEAP_H
+#define UUID7_RHEAP_H
+
+#include <stdint.h>
+#include <stddef.h> /* size_t */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * PUBLIC DEFINES
+ ****************************************************************************
+ */
+/* None */
+
+/****************************************************************************
+ * PUBLIC STRUCTURED VARIABLES
+ ****************************************************************************
+*/
+
+/** Opaque radix heap. Not thread-safe: one owner at a time. */
+typedef struct uuid7_rheap uuid7_rheap_t;
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DECLARATIONS
+ ****************************************************************************
+*/
+
+/**
+ * @brief Create an empty heap.
+ *
+ * Bucket storage is allocated on demand and kept until destroy, so a heap
+ * that is drained and refilled does not allocate again.
+ *
+ * @return New heap, or NULL on allocation failure.
+ */
+uuid7_rheap_t* uuid7_rheap_create(void);
+
+/**
+ * @brief Destroy a heap. Stored values are not touched.
+ *
+ * @param[in] h  Heap, may be NULL.
+ */
+void uuid7_rheap_destroy(uuid7_rheap_t* h);
+
+/**
+ * @brief Insert one entry.
+ *
+ * Amortized O(1) for keys >= the last popped key. Older keys are accepted
+ * too, but go to a small binary-heap side queue (O(log k)) and are popped
+ * before everything else.
+ *
+ * @param[in,out] h      Heap.
+ * @param[in]     id     16-byte key.
+ * @param[in]     value  Caller payload returned by pop.
+ * @return 0 on success, -1 on bad arguments or allocation failure.
+ */
+int uuid7_rheap_push(uuid7_rheap_t* h, const uint8_t* id, void* value);
+
+/**
+ * @brief Insert @p n entries at once.
+ *
+ * Room for the whole batch is reserved up front, then entries are filed
+ * without further capacity checks.
+ *
+ * @param[in,out] h       Heap.
+ * @param[in]     ids     16 * @p n bytes of keys.
+ * @param[in]     values  @p n payloads, or NULL to store NULL payloads.
+ * @param[in]     n       Number of entries.
+ * @return 0 on success, -1 on bad arguments or allocation failure (no entry
+ *         inserted).
+ */
+int uuid7_rheap_push_n(uuid7_rheap_t* h, const uint8_t* ids, void* const* values, size_t n);
+
+/**
+ * @brief Remove the smallest entry.
+ *
+ * @param[in,out] h      Heap.
+ * @param[out]    id     Optional: 16-byte key of the entry.
+ * @param[out]    value  Optional: its payload.
+ * @return 0 on success, -1 if the heap is empty or @p h is NULL.
+ */
+int uuid7_rheap_pop(uuid7_rheap_t* h, uint8_t* id, void** value);
+
+/**
+ * @brief Look at the smallest entry without removing it.
+ *
+ * @param[in,out] h      Heap (bucket layout may be reorganized).
+ * @param[out]    id     Optional: 16-byte key of the entry.
+ * @param[out]    value  Optional: its payload.
+ * @return 0 on success, -1 if the heap is empty, @p h is NULL or on
+ *         allocation failure.
+ */
+int uuid7_rheap_peek(uuid7_rheap_t* h, uint8_t* id, void** value);
+
+/**
+ * @brief Number of stored entries.
+ *
+ * @param[in] h  Heap.
+ * @return Entry count (0 if @p h is NULL).
+ */
+size_t uuid7_rheap_size(const uuid7_rheap_t* h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UUID7_RHEAP_H
@@ -0,0 +1,100 @@
+/**
+ * @file uuid7_sample.h
+ * @brief Consistent sampling decisions taken from the UUIDv7 random tail.
+ *
+ * The 62 bits after the variant field are CSPRNG output, so they already
+ * are the uniform hash a sampler needs. An ID is kept at rate `r` when its
+ * tail, read as a big-endian integer, is below `r * 2^62`. Every process
+ * reaches the same decision for the same ID without hashing or
+ * coordination, and the decisions nest: an ID kept at one rate is kept at
+ * every higher rate, so services sampling at different rates keep
+ * consistent subsets of one another.
+ *
+ * Time-stratified sampling keeps, in each time bucket, the IDs with the
+ * smallest tails (bottom-k). Services that see the same IDs of a bucket
+ * keep the same ones, whatever else they see.
+ *
+ * The decisions are only as uniform as the tails: IDs from generators that
+ * put counters or fixed bits in `rand_b` will bias them.
+ *
+ * @author  Roman Horshkov <roman.horshkov@gmail.com>
+ * @date    2025
+ * (c) 2025
+ */
+
+#ifndef UUID7_SAMPLE_H
+#define UUID7_SAMPLE_H
+
+#include <stdint.h>
+#include <stddef.h> /* size_t */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * PUBLIC DEFINES
+ ****************************************************************************
+ */
+/* None */
+
+/****************************************************************************
+ * PUBLIC STRUCTURED VARIABLES
+ ****************************************************************************
+*/
+/* None */
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DECLARATIONS
+ ****************************************************************************
+*/
+
+/**
+ * @brief Decide whether to keep an ID at a sampling rate.
+ *
+ * @param[in] id    16-byte ID.
+ * @param[in] rate  Fraction to keep; <= 0 keeps nothing, >= 1 everything.
+ * @return 1 to keep, 0 to drop, -1 on bad arguments (NULL, NaN rate).
+ */
+int uuid7_sample(const uint8_t* id, double rate);
+
+/**
+ * @brief Sampling decisions for a batch, as a bitmap.
+ *
+ * @param[in]  ids     @p n packed 16-byte IDs.
+ * @param[in]  n       Number of IDs.
+ * @param[in]  rate    Fraction to keep, as for `uuid7_sample()`.
+ * @param[out] bitmap  `(n + 63) / 64` words; bit `i % 64` of word `i / 64`
+ *                     is set if ID `i` is kept. Unused high bits of the
+ *                     last word are zeroed.
+ * @param[out] kept    Number of kept IDs (may be NULL).
+ * @return 0 on success, -1 on bad arguments.
+ */
+int uuid7_sample_n(const uint8_t* ids, size_t n, double rate, uint64_t* bitmap, size_t* kept);
+
+/**
+ * @brief Keep at most @p per_bucket IDs per time bucket, those with the
+ * smallest tails.
+ *
+ * The IDs must be ordered by bucket, as they are in generation order;
+ * within a bucket any order is fine. A batch boundary splits a bucket, so
+ * pass whole buckets for the decisions to match across services.
+ *
+ * @param[in]  ids         @p n packed 16-byte IDs.
+ * @param[in]  n           Number of IDs.
+ * @param[in]  bucket_ms   Bucket width in ms, >= 1.
+ * @param[in]  per_bucket  IDs to keep per bucket.
+ * @param[out] bitmap      As for `uuid7_sample_n()`.
+ * @param[out] kept        Number of kept IDs (may be NULL).
+ * @return 0 on success, -1 on bad arguments, allocation failure or a
+ *         bucket that goes back in time (the bitmap is then incomplete).
+ */
+int uuid7_sample_per_bucket(const uint8_t* ids, size_t n, uint64_t bucket_ms, uint32_t per_bucket,
+                            uint64_t* bitmap, size_t* kept);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UUID7_SAMPLE_H
@@ -0,0 +1,271 @@
+/**
+ * @file libuuid7_shim.c
+ * @brief LD_PRELOAD drop-in for the util-linux libuuid generation/parse API.
+ *
+ * Interposes the hot libuuid entry points and routes them to the uuid7 fast
+ * paths, without recompiling the application:
+ *
+ *   LD_PRELOAD=libuuid7preload.so ./app
+ *
+ * - `uuid_generate`, `uuid_generate_random`: random v4 from the buffered
+ *   per-thread RNG (no syscall per ID). `UUID7_PRELOAD_GENERATE=v7` switches
+ *   `uuid_generate` to time-ordered v7, `=libuuid` forwards both to their
+ *   real counterparts. `uuid_generate_random` always returns v4.
+ * - `uuid_generate_time`, `uuid_generate_time_safe`: v7 instead of v1, i.e.
+ *   still time-ordered and unique, but without the MAC address, the clock
+ *   file lock and uuidd. `UUID7_PRELOAD_TIME=libuuid` forwards instead.
+ * - `uuid_unparse*`, `uuid_parse`: SIMD formatting/parsing with libuuid's
+ *   exact semantics (36 chars, any case, nothing trailing).
+ * - `uuid_time`: decodes v7 timestamps, forwards other versions.
+ *
+ * Signatures and symbol versions (see libuuid.map) are those of libuuid,
+ * so the ABI is unchanged. All other symbols, including the uuid7 core, are
+ * local to the shim and never clash with the application.
+ *
+ * @author: Roman Horshkov <roman.horshkov@gmail.com>
+ * @date:   2025
+ */
+#ifndef _GNU_SOURCE
+#    define _GNU_SOURCE
+#endif
+
+#include "uuid7.h"
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+/****************************************************************************
+ * PRIVATE DEFINES
+ ****************************************************************************
+ */
+
+#define SHIM_EXPORT        __attribute__((visibility("default")))
+#define SHIM_STR_CHARS     36u
+#define SHIM_VERSION_V7    7u
+#define SHIM_LIBUUID_V1    "UUID_1.0"
+#define SHIM_LIBUUID_V2_20 "UUID_2.20"
+
+/****************************************************************************
+ * PRIVATE STUCTURED VARIABLES
+ ****************************************************************************
+ */
+
+/* libuuid's own type, declared here so the shim needs no libuuid headers */
+typedef unsigned char uuid_t[16];
+
+/* Generic function pointer for symbols resolved with dlsym() */
+typedef void (*shim_fn_t)(void);
+
+/* Where a family of generate calls is routed */
+typedef enum shim_route
+{
+    SHIM_ROUTE_V4 = 0,
+    SHIM_ROUTE_V7,
+    SHIM_ROUTE_LIBUUID,
+} shim_route_t;
+
+/****************************************************************************
+ * PRIVATE VARIABLES
+ ****************************************************************************
+ */
+
+static pthread_once_t g_config_once = PTHREAD_ONCE_INIT;
+static shim_route_t g_route_generate = SHIM_ROUTE_V4;
+static shim_route_t g_route_time = SHIM_ROUTE_V7;
+
+/* Real libuuid entry points, resolved only for the `libuuid` routes */
+static void (*g_next_generate)(uuid_t);
+static void (*g_next_generate_random)(uuid_t);
+static void (*g_next_generate_time)(uuid_t);
+static int (*g_next_generate_time_safe)(uuid_t);
+static time_t (*g_next_time)(const uuid_t, struct timeval*);
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS PROTOTYPES
+ ****************************************************************************
+ */
+
+/**
+ * @brief Read the UUID7_PRELOAD_* environment and resolve forwarded symbols.
+ * Runs once per process.
+ */
+static void _load_config(void);
+
+/**
+ * @brief Parse a route name from the environment.
+ * @param name  Variable name.
+ * @param def   Value used when unset or unknown.
+ * @return Selected route.
+ */
+static shim_route_t _env_route(const char* name, shim_route_t def);
+
+/**
+ * @brief Look up the next definition of a libuuid symbol (the real library).
+ * @return Symbol address, or NULL when libuuid is not loaded.
+ */
+static shim_fn_t _next_symbol(const char* name, const char* version);
+
+/**
+ * @brief Generate one ID along @p route; falls back to v7 if the real
+ * library was requested but is not loaded.
+ */
+static void _generate(shim_route_t route, void (*next)(uuid_t), uuid_t out);
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+SHIM_EXPORT void uuid_generate(uuid_t out)
+{
+    pthread_once(&g_config_once, _load_config);
+    _generate(g_route_generate, g_next_generate, out);
+}
+
+SHIM_EXPORT void uuid_generate_random(uuid_t out)
+{
+    pthread_once(&g_config_once, _load_config);
+    /* Random is random: forward to the real uuid_generate_random(), never
+     * to uuid_generate(), which may fall back to v1, and never to v7 */
+    const bool forward = g_route_generate == SHIM_ROUTE_LIBUUID && g_next_generate_random;
+    _generate(forward ? SHIM_ROUTE_LIBUUID : SHIM_ROUTE_V4, g_next_generate_random, out);
+}
+
+SHIM_EXPORT void uuid_generate_time(uuid_t out)
+{
+    pthread_once(&g_config_once, _load_config);
+    _generate(g_route_time, g_next_generate_time, out);
+}
+
+SHIM_EXPORT int uuid_generate_time_safe(uuid_t out)
+{
+    pthread_once(&g_config_once, _load_config);
+    if(g_route_time == SHIM_ROUTE_LIBUUID && g_next_generate_time_safe)
+    {
+        return g_next_generate_time_safe(out);
+    }
+    /* v7 IDs are always unique within the process: report "safe" */
+    _generate(SHIM_ROUTE_V7, NULL, out);
+    return 0;
+}
+
+SHIM_EXPORT void uuid_unparse_lower(const uuid_t uu, char* out)
+{
+    (void)uuid7_to_str(uu, out);
+}
+
+SHIM_EXPORT void uuid_unparse_upper(const uuid_t uu, char* out)
+{
+    (void)uuid7_to_str_upper(uu, out);
+}
+
+SHIM_EXPORT void uuid_unparse(const uuid_t uu, char* out)
+{
+    /* libuuid's default case, unless built with --enable-uuid-upper */
+    (void)uuid7_to_str(uu, out);
+}
+
+SHIM_EXPORT int uuid_parse(const char* in, uuid_t uu)
+{
+    if(!in || strlen(in) != SHIM_STR_CHARS) return -1;
+
+    /* libuuid leaves @p uu untouched on failure */
+    uint8_t tmp[16];
+    if(uuid7_from_str(in, tmp) != 0) return -1;
+    memcpy(uu, tmp, sizeof(tmp));
+    return 0;
+}
+
+SHIM_EXPORT time_t uuid_time(const uuid_t uu, struct timeval* ret_tv)
+{
+    if((uu[6] >> 4) == SHIM_VERSION_V7)
+    {
+        uint64_t ms = 0;
+        (void)uuid7_get_ms(uu, &ms);
+        if(ret_tv)
+        {
+            ret_tv->tv_sec = (time_t)(ms / 1000u);
+            ret_tv->tv_usec = (suseconds_t)((ms % 1000u) * 1000u);
+        }
+        return (time_t)(ms / 1000u);
+    }
+
+    pthread_once(&g_config_once, _load_config);
+    if(g_next_time) return g_next_time(uu, ret_tv);
+    return (time_t)-1;
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static shim_route_t _env_route(const char* name, shim_route_t def)
+{
+    const char* v = getenv(name);
+    if(!v) return def;
+    if(strcmp(v, "v4") == 0) return SHIM_ROUTE_V4;
+    if(strcmp(v, "v7") == 0) return SHIM_ROUTE_V7;
+    if(strcmp(v, "libuuid") == 0) return SHIM_ROUTE_LIBUUID;
+    return def;
+}
+
+static shim_fn_t _next_symbol(const char* name, const char* version)
+{
+    void* sym = dlvsym(RTLD_NEXT, name, version);
+    if(!sym) sym = dlsym(RTLD_NEXT, name);
+
+    /* POSIX guarantees this round-trip; ISO C has no direct cast for it */
+    shim_fn_t fn;
+    memcpy(&fn, &sym, sizeof(fn));
+    return fn;
+}
+
+static void _load_config(void)
+{
+    /* libuuid callers generate often: serve the tails from the per-thread
+     * pool rather than a getrandom() call per ID */
+    (void)uuid7_set_rng(uuid7_rng_buffered);
+
+    g_route_generate = _env_route("UUID7_PRELOAD_GENERATE", SHIM_ROUTE_V4);
+    g_route_time = _env_route("UUID7_PRELOAD_TIME", SHIM_ROUTE_V7);
+    if(g_route_time == SHIM_ROUTE_V4) g_route_time = SHIM_ROUTE_V7;
+
+    /* Needed for uuid_time() on non-v7 IDs regardless of the routes */
+    g_next_time = (time_t(*)(const uuid_t, struct timeval*))_next_symbol("uuid_time", SHIM_LIBUUID_V1);
+    if(g_route_generate == SHIM_ROUTE_LIBUUID)
+    {
+        g_next_generate = (void (*)(uuid_t))_next_symbol("uuid_generate", SHIM_LIBUUID_V1);
+        g_next_generate_random = (void (*)(uuid_t))_next_symbol("uuid_generate_random", SHIM_LIBUUID_V1);
+    }
+    if(g_route_time == SHIM_ROUTE_LIBUUID)
+    {
+        g_next_generate_time = (void (*)(uuid_t))_next_symbol("uuid_generate_time", SHIM_LIBUUID_V1);
+        g_next_generate_time_safe =
+            (int (*)(uuid_t))_next_symbol("uuid_generate_time_safe", SHIM_LIBUUID_V2_20);
+    }
+}
+
+static void _generate(shim_route_t route, void (*next)(uuid_t), uuid_t out)
+{
+    switch(route)
+    {
+        case SHIM_ROUTE_V4: (void)uuid7_gen_v4(out); return;
+        case SHIM_ROUTE_LIBUUID:
+            if(next)
+            {
+                next(out);
+                return;
+            }
+            break;
+        case SHIM_ROUTE_V7:
+        default: break;
+    }
+    (void)uuid7_gen(out);
+}
@@ -42,17 +42,26 @@
 #endif
 
 #include "uuid7.h"
+#include "uuid7_internal.h"
 
+#include <pthread.h>
 #include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
 #include <time.h>
 #include <errno.h>
+#include <sched.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/types.h>
 #if defined(__linux__)
+#    include <sys/auxv.h>
 #    include <sys/syscall.h>
 #    include <sys/random.h>
 #endif
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
 
 
 #ifndef _GNU_SOURCE
@@ -90,6 +99,54 @@
 #define V7_RB_BYTES 8u
 #define V7_MS_BYTES 6u
 #define V7_UUID_BYTES 16u
+#define V7_GEN_N_TAILS 32u /* random tails drawn per RNG call in uuid7_gen_n() */
+
+/* Canonical string layout: the ms prefix is `xxxxxxxx-xxxx` */
+#define V7_STR_DASH0     8u
+#define V7_STR_DASH1     13u
+#define V7_STR_DASH2     18u
+#define V7_STR_DASH3     23u
+#define V7_STR_MS_PREFIX 13u
+#define V7_STR_CHARS     36u
+#define V7_HEX_CHARS     32u
+
+/* RFC 3339 layout: `YYYY-MM-DDT` (day part), `HH:MM:SS.` (second part), `mmmZ` */
+#define V7_TIME_DAY_CHARS 11u
+#define V7_TIME_SEC_CHARS 20u
+#define V7_TIME_MAX_MS    253402300799999ull /* 9999-12-31T23:59:59.999Z */
+#define V7_MS_PER_SEC     1000u
+#define V7_SEC_PER_DAY    86400u
+
+/* Version 4 (random) layout bits */
+#define V4_VERSION_NIBBLE 0x40u
+#define V4_VERSION_MASK   0x0Fu
+
+/* Per-thread entropy pool of the built-in RNG. Requests larger than half a
+ * pool bypass it and go straight to the kernel. */
+#define V7_RNG_POOL_BYTES 256u
+
+/* Adaptive reservation: global mode word = (epoch << 1) | mode */
+#define V7_MODE_SHARED     0u
+#define V7_MODE_LEASED     1u
+#define V7_MODE_BIT        1u
+#define V7_EPOCH_STEP      2u
+#define V7_LEASE_MAX       (V7_SEQ_MASK + 1ull)
+
+/* Flat combining: slot states besides a published result word. A result
+ * is a 60-bit state word, so PENDING never collides with one, even at ms 0
+ * under a custom clock; IDLE is only ever compared by its owner */
+#define V7_FC_IDLE    0ull
+#define V7_FC_PENDING UINT64_MAX
+#define V7_FC_SLOTS   512u /* threads beyond this use the CAS loop */
+#define V7_FC_PASSES  2u   /* scans per combiner turn */
+#define V7_FC_SPINS   64u  /* pause-spins before yielding the CPU */
+#define V7_CACHE_LINE 64u
+
+/* In-flight tracking: threads beyond this many cannot begin tracked IDs */
+#define V7_INFLIGHT_SLOTS 512u
+
+/* Size of the kernel-provided AT_RANDOM block */
+#define V7_AT_RANDOM_BYTES 16u
 
 /* Compile-time sanity check: MS bytes + 2 (version+seq bytes) + remaining RB bytes
  * must equal total UUID size. Note: RB bytes include the first byte used for the
@@ -102,7 +159,60 @@ _Static_assert((V7_MS_BYTES + 2u + V7_RB_BYTES) == V7_UUID_BYTES,
  * PRIVATE STUCTURED VARIABLES
  ****************************************************************************
  */
-/* None */
+
+/* Per-thread buffer of kernel entropy. Bytes are handed out from the end
+ * and wiped once used. `fork_gen` ties the contents to one process image:
+ * after fork() the child sees a new generation and discards the pool it
+ * inherited, so parent and child never reuse the same bytes. */
+typedef struct v7_rng_pool
+{
+    uint8_t buf[V7_RNG_POOL_BYTES];
+    uint32_t avail;
+    uint32_t fork_gen;
+} v7_rng_pool_t;
+
+/* Per-thread state of the adaptive reservation path. A lease is the block
+ * [next, end] of packed (ms << 12) | seq words reserved in one CAS; it is
+ * valid only for the mode epoch it was taken in and while its millisecond
+ * is still current. Window counters are flushed to the globals once per
+ * evaluation window. */
+typedef struct v7_lease
+{
+    uint64_t next;     /* next word to hand out */
+    uint64_t end;      /* last word of the block, inclusive */
+    uint64_t epoch;    /* mode word the block belongs to */
+    uint32_t attempts; /* CAS attempts in the current window */
+    uint32_t retries;  /* failed CAS attempts in the current window */
+    uint32_t ids;      /* IDs issued in the current window */
+    uint32_t leases;   /* blocks taken in the current window */
+    uint32_t streak;   /* consecutive windows voting for a mode change */
+} v7_lease_t;
+
+/* Per-thread request slot of the flat-combining path, one cache line each.
+ * The owner writes PENDING; the combiner answers with the reserved word. */
+typedef struct v7_fc_slot
+{
+    _Alignas(V7_CACHE_LINE) _Atomic uint64_t state;
+    _Atomic uint32_t owned;
+} v7_fc_slot_t;
+
+/* Per-thread slot of the in-flight tracker, one cache line each. `floor`
+ * is 0 while the thread holds no open ID, otherwise a word <= every one of
+ * its open IDs; readers take the minimum over all slots. */
+typedef struct v7_inflight_slot
+{
+    _Alignas(V7_CACHE_LINE) _Atomic uint64_t floor;
+    _Atomic uint32_t owned;
+} v7_inflight_slot_t;
+
+/* Open IDs of the calling thread, as packed words, in no particular order */
+typedef struct v7_inflight
+{
+    v7_inflight_slot_t* slot;
+    bool none; /* no slot was free */
+    uint32_t n;
+    uint64_t words[UUID7_INFLIGHT_MAX];
+} v7_inflight_t;
 
 /****************************************************************************
  * PRIVATE VARIABLES
@@ -121,6 +231,59 @@ static _Atomic uint64_t g_v7_state = 0;
  */
 static _Atomic uintptr_t g_uuid_rng_ptr = (uintptr_t)0; /* 0 means not set */
 
+/* Clock function pointer, same storage scheme as the RNG pointer.
+ * 0 selects the built-in CLOCK_REALTIME source without an indirect call. */
+static _Atomic uintptr_t g_uuid_clock_ptr = (uintptr_t)0;
+
+/* Entropy pool of the calling thread */
+static _Thread_local v7_rng_pool_t t_rng_pool;
+
+/* Bumped in the child after every fork(); starts at 1 so that a zeroed pool
+ * is always considered stale. */
+static _Atomic uint32_t g_fork_gen = 1u;
+static pthread_once_t g_atfork_once = PTHREAD_ONCE_INIT;
+
+/* AT_RANDOM auxv bytes to mix into pool refills, 0 when not enabled */
+static _Atomic uintptr_t g_at_random_ptr = 0;
+
+/* Adaptive reservation (off unless `uuid7_set_adaptive()` was called) */
+static _Atomic uint32_t g_adapt_enabled = 0u;
+static _Atomic uint64_t g_adapt_mode = V7_MODE_SHARED;
+static _Atomic uint32_t g_adapt_window;
+static _Atomic uint32_t g_adapt_enter_pct;
+static _Atomic uint32_t g_adapt_exit_pct;
+static _Atomic uint32_t g_adapt_enter_windows;
+static _Atomic uint32_t g_adapt_exit_windows;
+static _Atomic uint32_t g_adapt_lease_size;
+static _Atomic uint64_t g_adapt_attempts;
+static _Atomic uint64_t g_adapt_retries;
+static _Atomic uint64_t g_adapt_ids;
+static _Atomic uint64_t g_adapt_leases;
+static _Atomic uint64_t g_adapt_to_leased;
+static _Atomic uint64_t g_adapt_to_shared;
+
+/* Lease and contention window of the calling thread */
+static _Thread_local v7_lease_t t_lease;
+
+/* Flat combining: request slots, scan bound and combiner lock */
+static v7_fc_slot_t g_fc_slots[V7_FC_SLOTS];
+static _Atomic uint32_t g_fc_hwm = 0u;
+static _Atomic uint32_t g_fc_lock = 0u;
+static pthread_once_t g_fc_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_fc_key;
+
+/* Slot of the calling thread; `t_fc_none` once no slot was free */
+static _Thread_local v7_fc_slot_t* t_fc_slot;
+static _Thread_local bool t_fc_none;
+
+/* In-flight tracking: slots, scan bound, and the open IDs of this thread */
+static v7_inflight_slot_t g_inflight_slots[V7_INFLIGHT_SLOTS];
+static _Atomic uint32_t g_inflight_hwm = 0u;
+static _Atomic uint64_t g_inflight_low = 0u; /* highest watermark returned */
+static pthread_once_t g_inflight_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_inflight_key;
+static _Thread_local v7_inflight_t t_inflight;
+
 /* Helper: convert stored uintptr_t to function pointer */
 static inline uuid_rng_fn_t load_uuid_rng(void)
 {
@@ -148,13 +311,47 @@ static inline void store_uuid_rng(uuid_rng_fn_t fn)
 static inline uint64_t _realtime_ms(void);
 
 /**
- * @brief Default RNG implementation: reads from /dev/urandom.
+ * @brief Returns the generator time: the configured clock, or real time.
+ *
+ * @return uint64_t Current time in ms.
+ */
+static inline uint64_t _now_ms(void);
+
+/**
+ * @brief Kernel entropy: getrandom(2), falling back to /dev/urandom.
  *
  * @param buf  Output buffer.
  * @param n    Number of bytes to fill.
  */
 static void _default_rng(void* buf, size_t n);
 
+/**
+ * @brief Fill @p buf from getrandom(2), falling back to /dev/urandom.
+ *
+ * @param buf  Output buffer.
+ * @param n    Number of bytes to fill.
+ * @return 0 if all bytes came from the kernel, -1 otherwise.
+ */
+static int _read_entropy(void* buf, size_t n);
+
+/**
+ * @brief Register `_atfork_child()`; run once via `g_atfork_once`.
+ */
+static void _register_atfork(void);
+
+/**
+ * @brief Refill the calling thread's entropy pool.
+ *
+ * When AT_RANDOM mixing is enabled and the kernel read succeeded, the
+ * auxv bytes are stretched over the pool and XORed in.
+ *
+ * @param pool  Pool of the calling thread.
+ * @param gen   Current fork generation.
+ * @return 0 on success, -1 if the kernel read failed (the pool is left
+ *         empty).
+ */
+static int _refill_pool(v7_rng_pool_t* pool, uint32_t gen);
+
 /**
  * @brief Helper: call the configured RNG.
  * @param buf  Output buffer.
@@ -162,6 +359,127 @@ static void _default_rng(void* buf, size_t n);
  */
 static inline void _fill_random(void* buf, size_t n);
 
+/**
+ * @brief Helper: value of one hex digit.
+ * @param c  Character to decode.
+ * @return 0..15, or -1 if @p c is not a hex digit.
+ */
+static inline int _hex_nibble(char c);
+
+/**
+ * @brief Reserve @p count consecutive (ms << 12) | seq words from
+ * `g_v7_state`, the first one strictly greater than every word issued so far.
+ *
+ * @param count    Number of words, 1..4096.
+ * @param retries  Optional: incremented once per failed CAS.
+ * @return First reserved word; the block is [first, first + count - 1].
+ */
+static inline uint64_t _reserve(uint64_t count, uint32_t* retries);
+
+/**
+ * @brief Next word on the adaptive path: served from the thread's lease in
+ * leased mode, from `_reserve(1)` in shared mode.
+ * @return Reserved word.
+ */
+static uint64_t _adaptive_next(void);
+
+/**
+ * @brief Drop the rest of the calling thread's lease. Paths that reserve
+ * from the shared state directly call this, so a later `uuid7_gen()` on the
+ * thread cannot return an older leased word.
+ */
+static inline void _retire_lease(void);
+
+/**
+ * @brief Close the thread's contention window: vote on the mode, switch it
+ * once the streak is long enough, and flush the counters.
+ * @param l     Thread state.
+ * @param mode  Mode word the window was measured under.
+ */
+static void _adapt_window(v7_lease_t* l, uint64_t mode);
+
+/**
+ * @brief Lay out a reserved word plus a fresh random tail as a UUIDv7.
+ * @param out   16-byte output.
+ * @param word  Reserved (ms << 12) | seq.
+ */
+static inline void _emit(uint8_t* out, uint64_t word);
+
+/**
+ * @brief Write the variant and random bytes (8..15) from @p rb.
+ * @param out  16-byte output.
+ * @param rb   V7_RB_BYTES random bytes.
+ */
+static inline void _emit_tail(uint8_t* out, const uint8_t* rb);
+
+/**
+ * @brief Write the ms, version and sequence bytes (0..7) of a reserved word.
+ * @param out   16-byte output.
+ * @param word  Reserved (ms << 12) | seq.
+ */
+static inline void _emit_prefix(uint8_t* out, uint64_t word);
+
+/**
+ * @brief Packed (ms << 12) | seq word of a UUIDv7.
+ * @param val  16-byte UUID.
+ * @return Word.
+ */
+static inline uint64_t _word_of(const uint8_t* val);
+
+/**
+ * @brief In-flight slot of the calling thread, claimed on first use and
+ * released (open IDs dropped) by a thread-exit destructor.
+ * @return Slot, or NULL when all `V7_INFLIGHT_SLOTS` are taken.
+ */
+static v7_inflight_slot_t* _inflight_slot(void);
+
+/**
+ * @brief Slot of the calling thread, claimed on first use and released by a
+ * thread-exit destructor.
+ * @return Slot, or NULL when all `V7_FC_SLOTS` are taken.
+ */
+static v7_fc_slot_t* _fc_slot(void);
+
+/**
+ * @brief Publish a request and wait for it to be served, combining on
+ * behalf of every waiting thread whenever the combiner lock is free.
+ * @param slot  Slot of the calling thread.
+ * @return Reserved word.
+ */
+static uint64_t _fc_request(v7_fc_slot_t* slot);
+
+/**
+ * @brief Combiner turn: reserve one contiguous block for all pending
+ * requests and hand the words out in slot order. Caller holds the lock.
+ */
+static void _fc_combine(void);
+
+/**
+ * @brief Format 16 bytes as a canonical 36-char string plus NUL.
+ * @param val    16-byte UUID.
+ * @param out    Output buffer of at least 37 chars.
+ * @param upper  Non-zero for upper-case hex digits.
+ */
+static void _format(const uint8_t* val, char* out, int upper);
+
+/**
+ * @brief Write `YYYY-MM-DDT` for a day count since 1970-01-01.
+ *
+ * Civil-from-days over 400-year eras (H. Hinnant): the year, day-of-year
+ * and month fall out of integer divisions by constants, with no loops and
+ * no leap-year branches.
+ * @param day  Days since the epoch, at most that of 9999-12-31.
+ * @param out  Output, `V7_TIME_DAY_CHARS` chars.
+ */
+static void _time_day(uint64_t day, char* out);
+
+/**
+ * @brief Write two decimal digits.
+ * @param out  Output, 2 chars.
+ * @param v    Value below 100.
+ */
+static inline void _put2(char* out, uint32_t v);
+
 /****************************************************************************
  * PUBLIC FUNCTIONS DEFINITIONS
  ****************************************************************************
@@ -171,96 +489,190 @@ int uuid7_gen(uint8_t* out)
 {
     if(!out) return -1;
 
-    uint64_t use_ms;
-    uint16_t seq12;
+    const uint64_t word = atomic_load_explicit(&g_adapt_enabled, memory_order_relaxed) ? _adaptive_next()
+                                                                                       : _reserve(1u, NULL);
+    _emit(out, word);
+    return 0;
+}
 
-    /* Reserve strictly increasing (ms,rand_a) using a CAS loop.
-     * Strategy: sample fresh 12-bit randomness for each candidate. If the
-     * candidate is not greater than the last stored state, increment the
-     * sequence where possible; on overflow advance the millisecond and
-     * re-sample randomness. This keeps rand_a random most of the time but
-     * preserves monotonicity when needed (RFC-compatible approach). */
-    for(;;)
+int uuid7_gen_n(uint8_t* out, size_t n)
+{
+    if(!out && n) return -1;
+
+    uint8_t rb[V7_GEN_N_TAILS * V7_RB_BYTES];
+    while(n)
     {
-        const uint64_t now_ms = _realtime_ms();
+        /* One CAS per block; the block may roll into the next ms */
+        const uint64_t count = n < V7_LEASE_MAX ? (uint64_t)n : V7_LEASE_MAX;
+        const uint64_t base = _reserve(count, NULL);
+        _retire_lease();
+        for(uint64_t k = 0; k < count; ++k)
+        {
+            const uint32_t t = (uint32_t)(k % V7_GEN_N_TAILS);
+            if(t == 0u)
+            {
+                const uint64_t left = count - k;
+                _fill_random(rb, (size_t)(left < V7_GEN_N_TAILS ? left : V7_GEN_N_TAILS) * V7_RB_BYTES);
+            }
+            _emit_prefix(out, base + k);
+            _emit_tail(out, rb + t * V7_RB_BYTES);
+            out += V7_UUID_BYTES;
+        }
+        n -= (size_t)count;
+    }
+    return 0;
+}
 
-        uint64_t prev     = atomic_load_explicit(&g_v7_state, memory_order_relaxed);
-        const uint64_t prev_ms  = V7_UNPACK_MS(prev);
-        const uint16_t prev_seq = V7_UNPACK_SEQ(prev);
+int uuid7_gen_fc(uint8_t* out)
+{
+    if(!out) return -1;
 
-        /* clamp to non-decreasing ms */
-        use_ms = (now_ms >= prev_ms) ? now_ms : prev_ms;
+    v7_fc_slot_t* slot = _fc_slot();
+    _emit(out, slot ? _fc_request(slot) : _reserve(1u, NULL));
+    _retire_lease();
+    return 0;
+}
 
-        /* Sample fresh 12-bit randomness for rand_a */
-        uint16_t rnd = 0;
-        _fill_random(&rnd, sizeof(rnd));
-        rnd &= (uint16_t)V7_SEQ_MASK;
-        if(rnd == 0u) rnd = 1u; /* prefer non-zero start */
+int uuid7_inflight_begin(uint8_t* out)
+{
+    if(!out) return -1;
 
-        uint64_t candidate = V7_PACK(use_ms, rnd);
+    v7_inflight_t* t = &t_inflight;
+    if(t->n == UUID7_INFLIGHT_MAX) return -1;
+    v7_inflight_slot_t* slot = _inflight_slot();
+    if(!slot) return -1;
 
-        if(candidate <= prev)
-        {
-            /* Need to produce a strictly greater value.
-                * If prev_seq hasn't overflowed, increment prev.
-                * Otherwise advance ms by 1 and re-randomize seq. */
-            if(prev_seq != (uint16_t)V7_SEQ_MASK)
-            {
-                candidate = prev + 1ull; /* increment seq, preserves monotonicity */
-            }
-            else
-            {
-                /* Overflow: move to next millisecond and sample a non-zero seq */
-                uint64_t next_ms = prev_ms + 1ull;
-                uint16_t rnd2 = 0;
-                _fill_random(&rnd2, sizeof(rnd2));
-                rnd2 &= (uint16_t)V7_SEQ_MASK;
-                if(rnd2 == 0u) rnd2 = 1u;
-                candidate = V7_PACK(next_ms, rnd2);
-            }
-        }
+    if(t->n == 0u)
+    {
+        /* Announce a floor before reserving. The fence pairs with the one in
+         * uuid7_low_watermark(): a reader either sees this floor, or loaded
+         * the state before our CAS and so bounds our word from below. */
+        const uint64_t state = atomic_load_explicit(&g_v7_state, memory_order_relaxed);
+        atomic_store_explicit(&slot->floor, state + 1u, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+    }
 
-        if(atomic_compare_exchange_weak_explicit(&g_v7_state, &prev, candidate, memory_order_acq_rel,
-                                                    memory_order_relaxed))
-        {
-            seq12 = (uint16_t)(candidate & V7_SEQ_MASK);
-            use_ms = V7_UNPACK_MS(candidate);
-            break;
-        }
-    /* else: CAS failed, loop and try again */
+    /* Later words only grow, so an existing floor stays valid */
+    const uint64_t word = _reserve(1u, NULL);
+    _retire_lease();
+    t->words[t->n++] = word;
+    if(t->n == 1u) atomic_store_explicit(&slot->floor, word, memory_order_release);
+    _emit(out, word);
+    return 0;
+}
+
+int uuid7_inflight_commit(const uint8_t* val)
+{
+    if(!val) return -1;
+
+    v7_inflight_t* t = &t_inflight;
+    const uint64_t word = _word_of(val);
+    uint32_t i = 0;
+    while(i < t->n && t->words[i] != word) ++i;
+    if(i == t->n) return -1;
+    t->words[i] = t->words[--t->n];
+
+    uint64_t floor = 0u;
+    for(uint32_t k = 0; k < t->n; ++k)
+    {
+        if(floor == 0u || t->words[k] < floor) floor = t->words[k];
     }
+    /* Release: a reader that sees the floor move also sees the row */
+    atomic_store_explicit(&t->slot->floor, floor, memory_order_release);
+    return 0;
+}
 
-    /* random tail: V7_RB_BYTES bytes of CSPRNG entropy. Some bits are
-     * consumed by the version/variant fields above, the remainder form the
-     * variable/random tail of the UUID. */
-    uint8_t rb[V7_RB_BYTES];
-    _fill_random(rb, V7_RB_BYTES);
+int uuid7_low_watermark(uint8_t* out)
+{
+    if(!out) return -1;
+    /* Leases hold words below the state that uuid7_gen() may still issue:
+     * no bound derived from the state holds for them */
+    if(atomic_load_explicit(&g_adapt_enabled, memory_order_acquire)) return -1;
 
-    /* UUIDv7 (RFC4122bis):
-       - bytes 0..5 : 48-bit unix ms (big-endian)
-       - byte    6  : version (0b0111) in high nibble | high 4 bits of seq
-       - byte    7  : low 8 bits of seq
-       - byte    8  : variant (10xxxxxx) | top 6 bits of rb[0]
-       - bytes 9..15: remaining 7 bytes from rb[1..7]
-    */
-    for(uint8_t i = 0; i < V7_MS_BYTES; ++i)
+    /* Nothing issued from now on is below the next word of the state */
+    uint64_t low = atomic_load_explicit(&g_v7_state, memory_order_relaxed) + 1u;
+    atomic_thread_fence(memory_order_seq_cst);
+
+    const uint32_t hwm = atomic_load_explicit(&g_inflight_hwm, memory_order_acquire);
+    for(uint32_t i = 0; i < hwm; ++i)
     {
-        out[i] = V7_MS_BYTE(use_ms, i);
+        const uint64_t floor = atomic_load_explicit(&g_inflight_slots[i].floor, memory_order_acquire);
+        if(floor != 0u && floor < low) low = floor;
     }
 
-    /* version 7 in high nibble | top 4 bits of sequence */
-    out[6] = (uint8_t)(((0x7u & V7_BYTE_MASK) << 4) | ((uint8_t)((seq12 >> V7_SEQ_HIGH_SHIFT) & V7_SEQ_HIGH_MASK)));
-    out[7] = (uint8_t)((uint8_t)seq12 & V7_SEQ_LOW_MASK);
+    /* A floor announced from a stale state may sit below a bound already
+     * handed out; that bound still holds, so never go back */
+    uint64_t prev = atomic_load_explicit(&g_inflight_low, memory_order_relaxed);
+    while(prev < low && !atomic_compare_exchange_weak_explicit(&g_inflight_low, &prev, low, memory_order_relaxed,
+                                                               memory_order_relaxed))
+    {
+        /* prev reloaded by the failed CAS */
+    }
+    if(prev > low) low = prev;
 
-    /* variant (10xxxxxx) | top 6 bits of rb[0] */
-    out[8] = (uint8_t)((rb[0] & V7_RB0_LOW6_MASK) | V7_VARIANT_TOP);
+    _emit_prefix(out, low);
+    out[V7_MS_BYTES + 2u] = V7_VARIANT_TOP;
+    memset(out + V7_MS_BYTES + 3u, 0, V7_RB_BYTES - 1u);
+    return 0;
+}
 
-    /* Remaining tail: copy rb[1..7] into bytes 9..15 without clobbering variant */
-    for(uint8_t i = 0; i < V7_RB_BYTES - 1u; ++i)
+int uuid7_adapt_config_init(uuid7_adapt_config_t* cfg)
+{
+    if(!cfg) return -1;
+    cfg->window = 256u;
+    cfg->enter_pct = 25u;
+    cfg->exit_pct = 5u;
+    cfg->enter_windows = 2u;
+    cfg->exit_windows = 8u;
+    cfg->lease_size = 64u;
+    return 0;
+}
+
+int uuid7_set_adaptive(const uuid7_adapt_config_t* cfg)
+{
+    if(cfg)
     {
-        out[V7_MS_BYTES + 3u + i] = rb[1 + i];
+        if(cfg->window == 0u || cfg->enter_pct > 100u || cfg->exit_pct > cfg->enter_pct ||
+           cfg->enter_windows == 0u || cfg->exit_windows == 0u || cfg->lease_size < 2u ||
+           cfg->lease_size > V7_LEASE_MAX)
+        {
+            return -1;
+        }
+        atomic_store_explicit(&g_adapt_window, cfg->window, memory_order_relaxed);
+        atomic_store_explicit(&g_adapt_enter_pct, cfg->enter_pct, memory_order_relaxed);
+        atomic_store_explicit(&g_adapt_exit_pct, cfg->exit_pct, memory_order_relaxed);
+        atomic_store_explicit(&g_adapt_enter_windows, cfg->enter_windows, memory_order_relaxed);
+        atomic_store_explicit(&g_adapt_exit_windows, cfg->exit_windows, memory_order_relaxed);
+        atomic_store_explicit(&g_adapt_lease_size, cfg->lease_size, memory_order_relaxed);
     }
 
+    /* Back to shared in a new epoch: outstanding leases become invalid */
+    const uint64_t mode = atomic_load_explicit(&g_adapt_mode, memory_order_relaxed);
+    atomic_store_explicit(&g_adapt_mode, (mode & ~(uint64_t)V7_MODE_BIT) + V7_EPOCH_STEP, memory_order_relaxed);
+    atomic_store_explicit(&g_adapt_enabled, cfg ? 1u : 0u, memory_order_release);
+    return 0;
+}
+
+int uuid7_get_adapt_stats(uuid7_adapt_stats_t* st)
+{
+    if(!st) return -1;
+    st->cas_attempts = atomic_load_explicit(&g_adapt_attempts, memory_order_relaxed);
+    st->cas_retries = atomic_load_explicit(&g_adapt_retries, memory_order_relaxed);
+    st->ids = atomic_load_explicit(&g_adapt_ids, memory_order_relaxed);
+    st->leases = atomic_load_explicit(&g_adapt_leases, memory_order_relaxed);
+    st->to_leased = atomic_load_explicit(&g_adapt_to_leased, memory_order_relaxed);
+    st->to_shared = atomic_load_explicit(&g_adapt_to_shared, memory_order_relaxed);
+    st->leased = (int)(atomic_load_explicit(&g_adapt_mode, memory_order_relaxed) & V7_MODE_BIT);
+    return 0;
+}
+
+int uuid7_gen_v4(uint8_t* out)
+{
+    if(!out) return -1;
+
+    _fill_random(out, V7_UUID_BYTES);
+    out[6] = (uint8_t)((out[6] & V4_VERSION_MASK) | V4_VERSION_NIBBLE);
+    out[8] = (uint8_t)((out[8] & V7_RB0_LOW6_MASK) | V7_VARIANT_TOP);
     return 0;
 }
 
@@ -282,6 +694,13 @@ int uuid7_set_rng(uuid_rng_fn_t fn)
     return 0;
 }
 
+int uuid7_set_clock(uuid_clock_fn_t fn)
+{
+    /* NULL stores 0, which `_now_ms()` maps to the built-in clock */
+    atomic_store_explicit(&g_uuid_clock_ptr, (uintptr_t)fn, memory_order_release);
+    return 0;
+}
+
 int uuid7_init(uuid_rng_fn_t fn)
 {
     /* If caller provided an RNG, install it atomically. Otherwise attempt to
@@ -301,58 +720,619 @@ int uuid7_init(uuid_rng_fn_t fn)
     return 0;
 }
 
-/****************************************************************************
- * PRIVATE FUNCTIONS DEFINITIONS
- ****************************************************************************
- */
-
-static inline uint64_t _realtime_ms(void)
+void uuid7_rng_buffered(void* buf, const size_t n)
 {
-    struct timespec ts;
-    clock_gettime(CLOCK_REALTIME, &ts);
-    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)(ts.tv_nsec / 1000000u);
+    if(!buf || n == 0) return;
+    if(n > V7_RNG_POOL_BYTES / 2u)
+    {
+        _default_rng(buf, n);
+        return;
+    }
+
+    v7_rng_pool_t* pool = &t_rng_pool;
+    const uint32_t gen = atomic_load_explicit(&g_fork_gen, memory_order_relaxed);
+    if((pool->fork_gen != gen || pool->avail < n) && _refill_pool(pool, gen) != 0)
+    {
+        /* No pool this time: never hand out stale or wiped bytes */
+        _default_rng(buf, n);
+        return;
+    }
+
+    /* Hand out from the end and wipe, so used bytes never linger */
+    pool->avail -= (uint32_t)n;
+    memcpy(buf, pool->buf + pool->avail, n);
+    memset(pool->buf + pool->avail, 0, n);
 }
 
-static void _default_rng(void* buf, size_t n)
+int uuid7_warmup(unsigned flags)
 {
-    if(!buf || n == 0) return;
-#if defined(__linux__)
-    /* Try getrandom(2) in a loop */
-    size_t off = 0;
-    while(off < n)
+#if defined(__linux__) && defined(AT_RANDOM)
+    if(flags & UUID7_WARMUP_AT_RANDOM)
     {
-        ssize_t r = syscall(SYS_getrandom, (char*)buf + off, n - off, 0);
-        if(r < 0)
-        {
-            if(errno == EINTR) continue;
-            break; /* fall back to /dev/urandom */
-        }
-        off += (size_t)r;
+        const uintptr_t at_random = (uintptr_t)getauxval(AT_RANDOM);
+        if(at_random) atomic_store_explicit(&g_at_random_ptr, at_random, memory_order_release);
     }
-    if(off == n) return;
+#else
+    (void)flags;
 #endif
-    /* Fallback: read from /dev/urandom */
-    int fd = open("/dev/urandom", O_RDONLY);
-    if(fd < 0) return;
-    size_t off2 = 0;
-    while(off2 < n)
+
+    /* Process-wide: the lazy RNG install and the fork hook */
+    uintptr_t expected = (uintptr_t)0;
+    atomic_compare_exchange_strong_explicit(&g_uuid_rng_ptr, &expected, (uintptr_t)_default_rng,
+                                           memory_order_acq_rel, memory_order_relaxed);
+    pthread_once(&g_atfork_once, _register_atfork);
+
+    /* Per-thread: TLS block, first entropy read, clock and state lines */
+    int rc = 0;
+    if(load_uuid_rng() == uuid7_rng_buffered)
     {
-        ssize_t r = read(fd, (char*)buf + off2, n - off2);
-        if(r < 0)
-        {
-            if(errno == EINTR) continue;
-            close(fd);
-            return;
-        }
+        const uint32_t gen = atomic_load_explicit(&g_fork_gen, memory_order_relaxed);
+        rc = _refill_pool(&t_rng_pool, gen);
+    }
+    (void)_now_ms();
+    (void)atomic_load_explicit(&g_v7_state, memory_order_relaxed);
+    return rc;
+}
+
+int uuid7_get_ms(const uint8_t* val, uint64_t* ms)
+{
+    if(!val || !ms) return -1;
+
+    uint64_t acc = 0;
+    for(uint8_t i = 0; i < V7_MS_BYTES; ++i)
+    {
+        acc = (acc << 8) | val[i];
+    }
+    *ms = acc;
+    return 0;
+}
+
+int uuid7_str_ms(const char* str, uint64_t* ms)
+{
+    if(!str || !ms) return -1;
+
+    /* Layout of the prefix: 8 hex digits, '-', 4 hex digits. */
+    if(str[V7_STR_DASH0] != '-') return -1;
+
+    uint64_t acc = 0;
+    for(uint8_t i = 0; i < V7_STR_MS_PREFIX; ++i)
+    {
+        if(i == V7_STR_DASH0) continue;
+        const int v = _hex_nibble(str[i]);
+        if(v < 0) return -1;
+        acc = (acc << 4) | (uint64_t)v;
+    }
+    *ms = acc;
+    return 0;
+}
+
+int uuid7_time_str(const uint8_t* val, char* out)
+{
+    if(!val || !out) return -1;
+    if(uuid7_time_str_n(val, 1u, out) != 0) return -1;
+    out[UUID7_TIME_STR_LEN] = '\0';
+    return 0;
+}
+
+int uuid7_time_str_n(const uint8_t* vals, size_t n, char* out)
+{
+    if(!vals || !out) return -1;
+
+    /* prefix holds `YYYY-MM-DDTHH:MM:SS.` of the second cached in `sec` */
+    char prefix[V7_TIME_SEC_CHARS];
+    uint64_t sec = UINT64_MAX;
+    uint64_t day = UINT64_MAX;
+    for(size_t i = 0; i < n; ++i, vals += V7_UUID_BYTES, out += UUID7_TIME_STR_LEN)
+    {
+        uint64_t ms = 0;
+        for(uint8_t b = 0; b < V7_MS_BYTES; ++b) ms = (ms << 8) | vals[b];
+        if(ms > V7_TIME_MAX_MS) return -1;
+
+        const uint64_t s = ms / V7_MS_PER_SEC;
+        if(s != sec)
+        {
+            const uint64_t d = s / V7_SEC_PER_DAY;
+            if(d != day)
+            {
+                _time_day(d, prefix);
+                day = d;
+            }
+            const uint32_t sod = (uint32_t)(s - d * V7_SEC_PER_DAY);
+            _put2(prefix + 11, sod / 3600u);
+            prefix[13] = ':';
+            _put2(prefix + 14, sod / 60u % 60u);
+            prefix[16] = ':';
+            _put2(prefix + 17, sod % 60u);
+            prefix[19] = '.';
+            sec = s;
+        }
+
+        const uint32_t frac = (uint32_t)(ms - s * V7_MS_PER_SEC);
+        memcpy(out, prefix, V7_TIME_SEC_CHARS);
+        out[20] = (char)('0' + frac / 100u);
+        _put2(out + 21, frac % 100u);
+        out[23] = 'Z';
+    }
+    return 0;
+}
+
+int uuid7_to_str(const uint8_t* val, char* out)
+{
+    if(!val || !out) return -1;
+    _format(val, out, 0);
+    return 0;
+}
+
+int uuid7_to_str_upper(const uint8_t* val, char* out)
+{
+    if(!val || !out) return -1;
+    _format(val, out, 1);
+    return 0;
+}
+
+int uuid7_from_str(const char* str, uint8_t* val)
+{
+    if(!str || !val) return -1;
+    if(str[V7_STR_DASH0] != '-' || str[V7_STR_DASH1] != '-' || str[V7_STR_DASH2] != '-' ||
+       str[V7_STR_DASH3] != '-')
+    {
+        return -1;
+    }
+
+    /* Drop the dashes: 32 contiguous hex digits */
+    char hex[V7_HEX_CHARS];
+    memcpy(hex, str, 8);
+    memcpy(hex + 8, str + 9, 4);
+    memcpy(hex + 12, str + 14, 4);
+    memcpy(hex + 16, str + 19, 4);
+    memcpy(hex + 20, str + 24, 12);
+
+#if defined(__SSE2__)
+    __m128i halves[2];
+    for(int k = 0; k < 2; ++k)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(const void*)(hex + 16 * k));
+        const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        const __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                               _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+        const __m128i is_alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                               _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+        if(_mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) != 0xFFFF) return -1;
+
+        const __m128i digit = _mm_and_si128(_mm_sub_epi8(v, _mm_set1_epi8('0')), is_digit);
+        const __m128i alpha = _mm_and_si128(_mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)), is_alpha);
+        const __m128i nib = _mm_or_si128(digit, alpha);
+
+        /* 16-bit lane = n0 | n1 << 8  ->  byte (n0 << 4) | n1 */
+        const __m128i pair = _mm_or_si128(_mm_slli_epi16(nib, 4), _mm_srli_epi16(nib, 8));
+        halves[k] = _mm_and_si128(pair, _mm_set1_epi16(0x00FF));
+    }
+    _mm_storeu_si128((__m128i*)(void*)val, _mm_packus_epi16(halves[0], halves[1]));
+#else
+    for(uint8_t i = 0; i < V7_UUID_BYTES; ++i)
+    {
+        const int hi = _hex_nibble(hex[2 * i]);
+        const int lo = _hex_nibble(hex[2 * i + 1]);
+        if(hi < 0 || lo < 0) return -1;
+        val[i] = (uint8_t)((hi << 4) | lo);
+    }
+#endif
+    return 0;
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static inline uint64_t _realtime_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)(ts.tv_nsec / 1000000u);
+}
+
+static inline uint64_t _now_ms(void)
+{
+    const uintptr_t p = atomic_load_explicit(&g_uuid_clock_ptr, memory_order_acquire);
+    if(!p) return _realtime_ms();
+    return ((uuid_clock_fn_t)p)();
+}
+
+static void _default_rng(void* buf, size_t n)
+{
+    (void)_read_entropy(buf, n);
+}
+
+static int _read_entropy(void* buf, size_t n)
+{
+    if(!buf || n == 0) return 0;
+#if defined(__linux__)
+    /* Try getrandom(2) in a loop */
+    size_t off = 0;
+    while(off < n)
+    {
+        ssize_t r = syscall(SYS_getrandom, (char*)buf + off, n - off, 0);
+        if(r < 0)
+        {
+            if(errno == EINTR) continue;
+            break; /* fall back to /dev/urandom */
+        }
+        off += (size_t)r;
+    }
+    if(off == n) return 0;
+#endif
+    /* Fallback: read from /dev/urandom */
+    int fd = open("/dev/urandom", O_RDONLY);
+    if(fd < 0) return -1;
+    size_t off2 = 0;
+    while(off2 < n)
+    {
+        ssize_t r = read(fd, (char*)buf + off2, n - off2);
+        if(r < 0)
+        {
+            if(errno == EINTR) continue;
+            close(fd);
+            return -1;
+        }
         if(r == 0)
         {
             close(fd);
-            return;
+            return -1;
         }
         off2 += (size_t)r;
     }
     close(fd);
-    return;
+    return 0;
+}
+
+static void _atfork_child(void)
+{
+    atomic_fetch_add_explicit(&g_fork_gen, 1u, memory_order_relaxed);
+
+    /* Only the forking thread survives: free the other combining slots and
+     * a combiner lock that one of them may have held. */
+    for(uint32_t i = 0; i < V7_FC_SLOTS; ++i)
+    {
+        if(&g_fc_slots[i] == t_fc_slot) continue;
+        atomic_store_explicit(&g_fc_slots[i].state, V7_FC_IDLE, memory_order_relaxed);
+        atomic_store_explicit(&g_fc_slots[i].owned, 0u, memory_order_relaxed);
+    }
+    atomic_store_explicit(&g_fc_lock, 0u, memory_order_relaxed);
+
+    /* Their in-flight IDs will never be committed here either */
+    for(uint32_t i = 0; i < V7_INFLIGHT_SLOTS; ++i)
+    {
+        if(&g_inflight_slots[i] == t_inflight.slot) continue;
+        atomic_store_explicit(&g_inflight_slots[i].floor, 0u, memory_order_relaxed);
+        atomic_store_explicit(&g_inflight_slots[i].owned, 0u, memory_order_relaxed);
+    }
+}
+
+static void _register_atfork(void)
+{
+    (void)pthread_atfork(NULL, NULL, _atfork_child);
+}
+
+static inline uint64_t _reserve(uint64_t count, uint32_t* retries)
+{
+    /* Reserve strictly increasing (ms,rand_a) using a CAS loop.
+     * Strategy: sample fresh 12-bit randomness for each candidate. If the
+     * candidate is not greater than the last stored state, increment the
+     * sequence where possible; on overflow advance the millisecond and
+     * re-sample randomness. This keeps rand_a random most of the time but
+     * preserves monotonicity when needed (RFC-compatible approach).
+     * A block of @p count words simply carries on from the first one; a
+     * sequence overflow inside the block rolls into the next millisecond. */
+    for(;;)
+    {
+        const uint64_t now_ms = _now_ms();
+
+        uint64_t prev     = atomic_load_explicit(&g_v7_state, memory_order_relaxed);
+        const uint64_t prev_ms  = V7_UNPACK_MS(prev);
+        const uint16_t prev_seq = V7_UNPACK_SEQ(prev);
+
+        /* clamp to non-decreasing ms */
+        const uint64_t use_ms = (now_ms >= prev_ms) ? now_ms : prev_ms;
+
+        /* Sample fresh 12-bit randomness for rand_a */
+        uint16_t rnd = 0;
+        _fill_random(&rnd, sizeof(rnd));
+        rnd &= (uint16_t)V7_SEQ_MASK;
+        if(rnd == 0u) rnd = 1u; /* prefer non-zero start */
+
+        uint64_t candidate = V7_PACK(use_ms, rnd);
+
+        if(candidate <= prev)
+        {
+            /* Need to produce a strictly greater value.
+                * If prev_seq hasn't overflowed, increment prev.
+                * Otherwise advance ms by 1 and re-randomize seq. */
+            if(prev_seq != (uint16_t)V7_SEQ_MASK)
+            {
+                candidate = prev + 1ull; /* increment seq, preserves monotonicity */
+            }
+            else
+            {
+                /* Overflow: move to next millisecond and sample a non-zero seq */
+                uint64_t next_ms = prev_ms + 1ull;
+                uint16_t rnd2 = 0;
+                _fill_random(&rnd2, sizeof(rnd2));
+                rnd2 &= (uint16_t)V7_SEQ_MASK;
+                if(rnd2 == 0u) rnd2 = 1u;
+                candidate = V7_PACK(next_ms, rnd2);
+            }
+        }
+
+        if(atomic_compare_exchange_weak_explicit(&g_v7_state, &prev, candidate + count - 1u,
+                                                 memory_order_acq_rel, memory_order_relaxed))
+        {
+            return candidate;
+        }
+        /* else: CAS failed, loop and try again */
+        if(retries) (*retries)++;
+    }
+}
+
+static uint64_t _adaptive_next(void)
+{
+    v7_lease_t* l = &t_lease;
+    const uint64_t mode = atomic_load_explicit(&g_adapt_mode, memory_order_relaxed);
+
+    uint32_t retries = 0;
+    uint64_t word;
+    if(mode & V7_MODE_BIT)
+    {
+        /* Leases never outlive their epoch or their millisecond */
+        if(l->epoch == mode && l->next <= l->end && V7_UNPACK_MS(l->next) >= _now_ms())
+        {
+            l->ids++;
+            return l->next++;
+        }
+        const uint64_t size = atomic_load_explicit(&g_adapt_lease_size, memory_order_relaxed);
+        word = _reserve(size, &retries);
+        l->next = word + 1u;
+        l->end = word + size - 1u;
+        l->epoch = mode;
+        l->leases++;
+    }
+    else
+    {
+        word = _reserve(1u, &retries);
+    }
+
+    l->ids++;
+    l->attempts += 1u + retries;
+    l->retries += retries;
+    if(l->attempts >= atomic_load_explicit(&g_adapt_window, memory_order_relaxed)) _adapt_window(l, mode);
+    return word;
+}
+
+static inline void _retire_lease(void)
+{
+    t_lease.next = t_lease.end + 1u;
+}
+
+static void _adapt_window(v7_lease_t* l, uint64_t mode)
+{
+    const uint32_t pct = (uint32_t)((uint64_t)l->retries * 100u / l->attempts);
+
+    /* Shared: contended when the retry share is high. Leased: calm when
+     * refills rarely collide *and* leases go mostly unused before their
+     * millisecond ends, i.e. threads no longer need a block per ms. */
+    uint32_t need;
+    bool vote;
+    if(mode & V7_MODE_BIT)
+    {
+        const uint64_t capacity =
+            (uint64_t)l->leases * atomic_load_explicit(&g_adapt_lease_size, memory_order_relaxed);
+        vote = pct <= atomic_load_explicit(&g_adapt_exit_pct, memory_order_relaxed) &&
+               (uint64_t)l->ids * 2u < capacity;
+        need = atomic_load_explicit(&g_adapt_exit_windows, memory_order_relaxed);
+    }
+    else
+    {
+        vote = pct >= atomic_load_explicit(&g_adapt_enter_pct, memory_order_relaxed);
+        need = atomic_load_explicit(&g_adapt_enter_windows, memory_order_relaxed);
+    }
+    l->streak = vote ? l->streak + 1u : 0u;
+
+    if(l->streak >= need)
+    {
+        /* Flip the mode and open a new epoch; losing the race is fine */
+        uint64_t expected = mode;
+        const uint64_t desired = ((mode & ~(uint64_t)V7_MODE_BIT) + V7_EPOCH_STEP) | ((mode & V7_MODE_BIT) ^ 1u);
+        if(atomic_compare_exchange_strong_explicit(&g_adapt_mode, &expected, desired, memory_order_relaxed,
+                                                   memory_order_relaxed))
+        {
+            atomic_fetch_add_explicit((mode & V7_MODE_BIT) ? &g_adapt_to_shared : &g_adapt_to_leased, 1u,
+                                      memory_order_relaxed);
+        }
+        l->streak = 0;
+    }
+
+    atomic_fetch_add_explicit(&g_adapt_attempts, l->attempts, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_adapt_retries, l->retries, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_adapt_ids, l->ids, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_adapt_leases, l->leases, memory_order_relaxed);
+    l->attempts = l->retries = l->ids = l->leases = 0;
+}
+
+static void _fc_release(void* p)
+{
+    v7_fc_slot_t* slot = (v7_fc_slot_t*)p;
+    atomic_store_explicit(&slot->state, V7_FC_IDLE, memory_order_relaxed);
+    atomic_store_explicit(&slot->owned, 0u, memory_order_release);
+}
+
+static void _fc_make_key(void)
+{
+    (void)pthread_key_create(&g_fc_key, _fc_release);
+}
+
+static v7_fc_slot_t* _fc_slot(void)
+{
+    if(t_fc_slot || t_fc_none) return t_fc_slot;
+
+    pthread_once(&g_fc_key_once, _fc_make_key);
+    pthread_once(&g_atfork_once, _register_atfork);
+    for(uint32_t i = 0; i < V7_FC_SLOTS; ++i)
+    {
+        uint32_t expected = 0u;
+        if(atomic_load_explicit(&g_fc_slots[i].owned, memory_order_relaxed) == 0u &&
+           atomic_compare_exchange_strong_explicit(&g_fc_slots[i].owned, &expected, 1u, memory_order_acquire,
+                                                   memory_order_relaxed))
+        {
+            uint32_t hwm = atomic_load_explicit(&g_fc_hwm, memory_order_relaxed);
+            while(hwm < i + 1u &&
+                  !atomic_compare_exchange_weak_explicit(&g_fc_hwm, &hwm, i + 1u, memory_order_release,
+                                                         memory_order_relaxed))
+            {
+                /* hwm reloaded by the failed CAS */
+            }
+            (void)pthread_setspecific(g_fc_key, &g_fc_slots[i]);
+            t_fc_slot = &g_fc_slots[i];
+            return t_fc_slot;
+        }
+    }
+    t_fc_none = true;
+    return NULL;
+}
+
+static void _inflight_release(void* p)
+{
+    v7_inflight_slot_t* slot = (v7_inflight_slot_t*)p;
+    atomic_store_explicit(&slot->floor, 0u, memory_order_release);
+    atomic_store_explicit(&slot->owned, 0u, memory_order_release);
+}
+
+static void _inflight_make_key(void)
+{
+    (void)pthread_key_create(&g_inflight_key, _inflight_release);
+}
+
+static v7_inflight_slot_t* _inflight_slot(void)
+{
+    v7_inflight_t* t = &t_inflight;
+    if(t->slot || t->none) return t->slot;
+
+    pthread_once(&g_inflight_key_once, _inflight_make_key);
+    pthread_once(&g_atfork_once, _register_atfork);
+    for(uint32_t i = 0; i < V7_INFLIGHT_SLOTS; ++i)
+    {
+        uint32_t expected = 0u;
+        if(atomic_load_explicit(&g_inflight_slots[i].owned, memory_order_relaxed) == 0u &&
+           atomic_compare_exchange_strong_explicit(&g_inflight_slots[i].owned, &expected, 1u,
+                                                   memory_order_acquire, memory_order_relaxed))
+        {
+            uint32_t hwm = atomic_load_explicit(&g_inflight_hwm, memory_order_relaxed);
+            while(hwm < i + 1u &&
+                  !atomic_compare_exchange_weak_explicit(&g_inflight_hwm, &hwm, i + 1u, memory_order_release,
+                                                         memory_order_relaxed))
+            {
+                /* hwm reloaded by the failed CAS */
+            }
+            (void)pthread_setspecific(g_inflight_key, &g_inflight_slots[i]);
+            t->slot = &g_inflight_slots[i];
+            return t->slot;
+        }
+    }
+    t->none = true;
+    return NULL;
+}
+
+static uint64_t _fc_request(v7_fc_slot_t* slot)
+{
+    atomic_store_explicit(&slot->state, V7_FC_PENDING, memory_order_release);
+    for(uint32_t spins = 0;; ++spins)
+    {
+        const uint64_t word = atomic_load_explicit(&slot->state, memory_order_acquire);
+        if(word != V7_FC_PENDING)
+        {
+            atomic_store_explicit(&slot->state, V7_FC_IDLE, memory_order_relaxed);
+            return word;
+        }
+        if(atomic_load_explicit(&g_fc_lock, memory_order_relaxed) == 0u &&
+           atomic_exchange_explicit(&g_fc_lock, 1u, memory_order_acquire) == 0u)
+        {
+            _fc_combine();
+            atomic_store_explicit(&g_fc_lock, 0u, memory_order_release);
+            continue;
+        }
+        /* The combiner may be descheduled: do not burn its time slice */
+        if(spins >= V7_FC_SPINS)
+        {
+            sched_yield();
+            spins = 0;
+        }
+        else
+        {
+            _cpu_relax();
+        }
+    }
+}
+
+static void _fc_combine(void)
+{
+    uint16_t pending[V7_FC_SLOTS];
+    for(uint32_t pass = 0; pass < V7_FC_PASSES; ++pass)
+    {
+        const uint32_t hwm = atomic_load_explicit(&g_fc_hwm, memory_order_acquire);
+        uint32_t n = 0;
+        for(uint32_t i = 0; i < hwm; ++i)
+        {
+            if(atomic_load_explicit(&g_fc_slots[i].state, memory_order_acquire) == V7_FC_PENDING)
+            {
+                pending[n++] = (uint16_t)i;
+            }
+        }
+        if(n == 0) return;
+
+        /* Blocks larger than one ms of sequence simply roll into the next */
+        const uint64_t base = _reserve(n, NULL);
+        for(uint32_t k = 0; k < n; ++k)
+        {
+            atomic_store_explicit(&g_fc_slots[pending[k]].state, base + k, memory_order_release);
+        }
+    }
+}
+
+static int _refill_pool(v7_rng_pool_t* pool, uint32_t gen)
+{
+    /* Register the fork hook before the first pool exists */
+    pthread_once(&g_atfork_once, _register_atfork);
+    const int rc = _read_entropy(pool->buf, V7_RNG_POOL_BYTES);
+    if(rc != 0)
+    {
+        memset(pool->buf, 0, sizeof(pool->buf));
+        pool->avail = 0u;
+        return rc;
+    }
+
+    /* AT_RANDOM doubles as libc's stack-protector secret: it is only ever
+     * mixed over kernel output, never handed out on its own. */
+    const uintptr_t at_random = atomic_load_explicit(&g_at_random_ptr, memory_order_acquire);
+    if(at_random)
+    {
+        uint64_t x[2];
+        memcpy(x, (const void*)at_random, sizeof(x));
+        uint64_t key = x[0] ^ (x[1] * 0x9E3779B97F4A7C15ull) ^ (uint64_t)gen;
+        for(size_t off = 0; off < V7_RNG_POOL_BYTES; off += sizeof(uint64_t))
+        {
+            /* splitmix64 stream keyed by the auxv bytes */
+            uint64_t z = (key += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            z ^= z >> 31;
+            uint64_t w;
+            memcpy(&w, pool->buf + off, sizeof(w));
+            w ^= z;
+            memcpy(pool->buf + off, &w, sizeof(w));
+        }
+    }
+    pool->avail = V7_RNG_POOL_BYTES;
+    pool->fork_gen = gen;
+    return 0;
 }
 
 static inline void _fill_random(void* buf, size_t n)
@@ -378,3 +1358,138 @@ static inline void _fill_random(void* buf, size_t n)
     fn(buf, n);
     return;
 }
+
+static inline int _hex_nibble(char c)
+{
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static void _format(const uint8_t* val, char* out, int upper)
+{
+    char hex[V7_HEX_CHARS];
+#if defined(__SSE2__)
+    /* nibble -> ASCII: n + '0', plus the gap to 'a'/'A' when n > 9 */
+    const __m128i v = _mm_loadu_si128((const __m128i*)(const void*)val);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+    const __m128i lo = _mm_and_si128(v, mask);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i gap = _mm_set1_epi8((char)((upper ? 'A' : 'a') - '0' - 10));
+    const __m128i hi_c = _mm_add_epi8(_mm_add_epi8(hi, zero), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), gap));
+    const __m128i lo_c = _mm_add_epi8(_mm_add_epi8(lo, zero), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), gap));
+    _mm_storeu_si128((__m128i*)(void*)hex, _mm_unpacklo_epi8(hi_c, lo_c));
+    _mm_storeu_si128((__m128i*)(void*)(hex + 16), _mm_unpackhi_epi8(hi_c, lo_c));
+#else
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    for(uint8_t i = 0; i < V7_UUID_BYTES; ++i)
+    {
+        hex[2 * i] = digits[val[i] >> 4];
+        hex[2 * i + 1] = digits[val[i] & 0x0F];
+    }
+#endif
+    memcpy(out, hex, 8);
+    out[V7_STR_DASH0] = '-';
+    memcpy(out + 9, hex + 8, 4);
+    out[V7_STR_DASH1] = '-';
+    memcpy(out + 14, hex + 12, 4);
+    out[V7_STR_DASH2] = '-';
+    memcpy(out + 19, hex + 16, 4);
+    out[V7_STR_DASH3] = '-';
+    memcpy(out + 24, hex + 20, 12);
+    out[V7_STR_CHARS] = '\0';
+}
+
+static inline void _emit(uint8_t* out, uint64_t word)
+{
+    /* random tail: V7_RB_BYTES bytes of CSPRNG entropy. Some bits are
+     * consumed by the version/variant fields above, the remainder form the
+     * variable/random tail of the UUID. */
+    uint8_t rb[V7_RB_BYTES];
+    _fill_random(rb, V7_RB_BYTES);
+
+    /* UUIDv7 (RFC4122bis):
+       - bytes 0..5 : 48-bit unix ms (big-endian)
+       - byte    6  : version (0b0111) in high nibble | high 4 bits of seq
+       - byte    7  : low 8 bits of seq
+       - byte    8  : variant (10xxxxxx) | top 6 bits of rb[0]
+       - bytes 9..15: remaining 7 bytes from rb[1..7]
+    */
+    _emit_prefix(out, word);
+    _emit_tail(out, rb);
+}
+
+static inline void _emit_tail(uint8_t* out, const uint8_t* rb)
+{
+    /* variant (10xxxxxx) | top 6 bits of rb[0] */
+    out[8] = (uint8_t)((rb[0] & V7_RB0_LOW6_MASK) | V7_VARIANT_TOP);
+
+    /* Remaining tail: copy rb[1..7] into bytes 9..15 without clobbering variant */
+    for(uint8_t i = 0; i < V7_RB_BYTES - 1u; ++i)
+    {
+        out[V7_MS_BYTES + 3u + i] = rb[1 + i];
+    }
+}
+
+static inline void _emit_prefix(uint8_t* out, uint64_t word)
+{
+    const uint64_t use_ms = V7_UNPACK_MS(word);
+    const uint16_t seq12 = V7_UNPACK_SEQ(word);
+
+    for(uint8_t i = 0; i < V7_MS_BYTES; ++i)
+    {
+        out[i] = V7_MS_BYTE(use_ms, i);
+    }
+
+    /* version 7 in high nibble | top 4 bits of sequence */
+    out[6] = (uint8_t)(((0x7u & V7_BYTE_MASK) << 4) | ((uint8_t)((seq12 >> V7_SEQ_HIGH_SHIFT) & V7_SEQ_HIGH_MASK)));
+    out[7] = (uint8_t)((uint8_t)seq12 & V7_SEQ_LOW_MASK);
+}
+
+static inline uint64_t _word_of(const uint8_t* val)
+{
+    uint64_t ms = 0;
+    for(uint8_t i = 0; i < V7_MS_BYTES; ++i) ms = (ms << 8) | val[i];
+    const uint16_t seq12 = (uint16_t)(((val[6] & V7_SEQ_HIGH_MASK) << V7_SEQ_HIGH_SHIFT) | val[7]);
+    return V7_PACK(ms, seq12);
+}
+
+static void _time_day(uint64_t day, char* out)
+{
+    /* Shift the epoch to 0000-03-01 so the leap day ends each cycle */
+    const uint32_t z = (uint32_t)day + 719468u;
+    const uint32_t era = z / 146097u;
+    const uint32_t doe = z - era * 146097u; /* day of era, [0, 146096] */
+    const uint32_t yoe = (doe - doe / 1460u + doe / 36524u - doe / 146096u) / 365u;
+    const uint32_t doy = doe - (365u * yoe + yoe / 4u - yoe / 100u); /* from Mar 1 */
+    const uint32_t mp = (5u * doy + 2u) / 153u;                       /* Mar = 0 */
+    const uint32_t d = doy - (153u * mp + 2u) / 5u + 1u;
+    const uint32_t m = mp + 3u - 12u * (mp >= 10u);
+    const uint32_t y = yoe + era * 400u + (m <= 2u);
+
+    _put2(out, y / 100u);
+    _put2(out + 2, y % 100u);
+    out[4] = '-';
+    _put2(out + 5, m);
+    out[7] = '-';
+    _put2(out + 8, d);
+    out[10] = 'T';
+}
+
+static inline void _put2(char* out, uint32_t v)
+{
+    static const char digits[200] = "00010203040506070809"
+                                    "10111213141516171819"
+                                    "20212223242526272829"
+                                    "30313233343536373839"
+                                    "40414243444546474849"
+                                    "50515253545556575859"
+                                    "60616263646566676869"
+                                    "70717273747576777879"
+                                    "80818283848586878889"
+                                    "90919293949596979899";
+    memcpy(out, &digits[2u * v], 2);
+}
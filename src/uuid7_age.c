@@ -0,0 +1,361 @@
+/**
+ * @file uuid7_age.c
+ * @brief Streaming quantile sketch of ID age, for end-to-end pipeline timing.
+ *
+ * Bucket of an age `v` (HDR log-linear, 7 significant bits): `v` itself
+ * below 128, otherwise `(s << 6) + (v >> s)` with `s = msb(v) - 6`, which
+ * keeps the top 7 bits of `v` and so 64 buckets per power of two. The index
+ * is a count-leading-zeros, a shift and an add; no logarithm, no table.
+ *
+ * A shard is a cache-line aligned counter array owned by the threads that
+ * map to it (by `_thread_stripe()`, modulo the shard count). Recording is a
+ * relaxed fetch-add; with no more threads than shards it is never
+ * contended. Batches decode the 48-bit ms of each ID with one byte swap
+ * and skip even that while the raw prefix repeats: IDs arrive in bursts
+ * from the same ms, and a run in one bucket is flushed as one add.
+ *
+ * Readers sum the shards; the sums are not a snapshot across buckets, which
+ * only matters to a reader racing a recorder and costs at most the records
+ * in flight.
+ *
+ * @author: Roman Horshkov <roman.horshkov@gmail.com>
+ * @date:   2025
+ */
+
+#include "uuid7_age.h"
+#include "uuid7_internal.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/****************************************************************************
+ * PRIVATE DEFINES
+ ****************************************************************************
+ */
+
+#define AGE_DEFAULT_SHARDS 16u
+#define AGE_MAX_SHARDS     256u
+#define AGE_SUB_BITS       7u                          /* significant bits kept per age */
+#define AGE_HALF           (1u << (AGE_SUB_BITS - 1u)) /* buckets per power of two */
+#define AGE_MAX_BITS       40u                         /* ages >= 2^40 ms share the last bucket */
+#define AGE_MAX_MS         ((1ull << AGE_MAX_BITS) - 1u)
+#define AGE_ID_BYTES       16u
+#define AGE_MS_SHIFT       16u /* unix ms in the top 48 bits of the high word */
+#define AGE_CACHE_LINE     64u
+
+_Static_assert(UUID7_AGE_BUCKETS == (AGE_MAX_BITS - AGE_SUB_BITS + 2u) * AGE_HALF, "bucket count");
+
+/****************************************************************************
+ * PRIVATE STUCTURED VARIABLES
+ ****************************************************************************
+ */
+
+/* Counters of the threads mapped to one shard */
+typedef struct age_shard
+{
+    _Alignas(AGE_CACHE_LINE) _Atomic uint64_t counts[UUID7_AGE_BUCKETS];
+    _Atomic uint64_t future;
+} age_shard_t;
+
+struct uuid7_age
+{
+    uuid7_age_config_t cfg;
+    age_shard_t* shards;
+};
+
+/****************************************************************************
+ * PRIVATE VARIABLES
+ ****************************************************************************
+ */
+
+/* None */
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS PROTOTYPES
+ ****************************************************************************
+ */
+
+/**
+ * @brief The calling thread's shard.
+ */
+static age_shard_t* _shard(uuid7_age_t* age);
+
+/**
+ * @brief Bucket of an age in ms.
+ */
+static inline uint32_t _bucket(uint64_t age_ms);
+
+/**
+ * @brief Smallest and largest age of bucket @p b.
+ */
+static uint64_t _bucket_low(uint32_t b);
+static uint64_t _bucket_high(uint32_t b);
+
+/**
+ * @brief Sum the shards into @p counts; returns the total.
+ */
+static uint64_t _sum(const uuid7_age_t* age, uint64_t* counts);
+
+/**
+ * @brief Future count summed over the shards.
+ */
+static uint64_t _future(const uuid7_age_t* age);
+
+/**
+ * @brief Bucket holding the 0-based @p rank of the sorted ages.
+ */
+static uint32_t _rank_bucket(const uint64_t* counts, uint64_t rank);
+
+/**
+ * @brief Age reported for quantile @p q of the summed @p counts.
+ */
+static uint64_t _quantile(const uint64_t* counts, uint64_t total, double q);
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+void uuid7_age_config_init(uuid7_age_config_t* cfg)
+{
+    if(!cfg) return;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->shards = AGE_DEFAULT_SHARDS;
+}
+
+uuid7_age_t* uuid7_age_create(const uuid7_age_config_t* cfg)
+{
+    if(!cfg || cfg->shards == 0u || cfg->shards > AGE_MAX_SHARDS) return NULL;
+
+    uuid7_age_t* age = calloc(1, sizeof(*age));
+    if(!age) return NULL;
+    age->cfg = *cfg;
+    age->shards = aligned_alloc(AGE_CACHE_LINE, cfg->shards * sizeof(age_shard_t));
+    if(!age->shards)
+    {
+        free(age);
+        return NULL;
+    }
+    memset(age->shards, 0, cfg->shards * sizeof(age_shard_t));
+    return age;
+}
+
+void uuid7_age_destroy(uuid7_age_t* age)
+{
+    if(!age) return;
+    free(age->shards);
+    free(age);
+}
+
+int uuid7_age_record(uuid7_age_t* age, const uint8_t* id)
+{
+    if(!age || !id) return -1;
+    return uuid7_age_record_at(age, id, 1u, _clock_ms(age->cfg.clock_fn));
+}
+
+int uuid7_age_record_n(uuid7_age_t* age, const uint8_t* ids, size_t n)
+{
+    if(!age || (!ids && n > 0)) return -1;
+    if(n == 0) return 0;
+    return uuid7_age_record_at(age, ids, n, _clock_ms(age->cfg.clock_fn));
+}
+
+int uuid7_age_record_at(uuid7_age_t* age, const uint8_t* ids, size_t n, uint64_t now_ms)
+{
+    if(!age || (!ids && n > 0)) return -1;
+    if(n == 0) return 0;
+
+    age_shard_t* shard = _shard(age);
+    uint64_t prev_raw = 0;
+    uint32_t run_bucket = 0;
+    uint64_t run = 0;
+    uint64_t future = 0;
+    bool prev_future = false;
+    for(size_t i = 0; i < n; ++i)
+    {
+        const uint8_t* id = ids + i * AGE_ID_BYTES;
+        uint64_t raw;
+        memcpy(&raw, id, sizeof(raw));
+        /* Same 48-bit ms as the previous ID: same bucket. The two version
+         * and seq bytes differ between IDs, so compare the ms bytes only */
+        uint8_t* rb = (uint8_t*)&raw;
+        rb[6] = 0;
+        rb[7] = 0;
+        if(run > 0 && raw == prev_raw)
+        {
+            ++run;
+            future += prev_future;
+            continue;
+        }
+
+        const uint64_t ms = _load_be64(id) >> AGE_MS_SHIFT;
+        prev_future = ms > now_ms;
+        future += prev_future;
+        const uint32_t b = _bucket(prev_future ? 0u : now_ms - ms);
+        prev_raw = raw;
+        if(run > 0 && b == run_bucket)
+        {
+            ++run;
+            continue;
+        }
+        if(run > 0) atomic_fetch_add_explicit(&shard->counts[run_bucket], run, memory_order_relaxed);
+        run_bucket = b;
+        run = 1;
+    }
+    atomic_fetch_add_explicit(&shard->counts[run_bucket], run, memory_order_relaxed);
+    if(future) atomic_fetch_add_explicit(&shard->future, future, memory_order_relaxed);
+    return 0;
+}
+
+int uuid7_age_quantile(const uuid7_age_t* age, double q, uint64_t* ms)
+{
+    if(!age || !ms || !(q >= 0.0 && q <= 1.0)) return -1;
+    uint64_t counts[UUID7_AGE_BUCKETS];
+    const uint64_t total = _sum(age, counts);
+    if(total == 0) return -1;
+    *ms = _quantile(counts, total, q);
+    return 0;
+}
+
+int uuid7_age_get_stats(const uuid7_age_t* age, uuid7_age_stats_t* stats)
+{
+    if(!age || !stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+    uint64_t counts[UUID7_AGE_BUCKETS];
+    stats->count = _sum(age, counts);
+    stats->future = _future(age);
+    if(stats->count == 0) return 0;
+
+    stats->p50_ms = _quantile(counts, stats->count, 0.5);
+    stats->p99_ms = _quantile(counts, stats->count, 0.99);
+    stats->p999_ms = _quantile(counts, stats->count, 0.999);
+    uint32_t top = UUID7_AGE_BUCKETS - 1u;
+    while(top > 0 && counts[top] == 0) --top;
+    stats->max_ms = _bucket_high(top);
+    return 0;
+}
+
+int uuid7_age_export(uuid7_age_t* age, uint64_t* counts, uint64_t* future, int reset)
+{
+    if(!age || !counts) return -1;
+    if(!reset)
+    {
+        _sum(age, counts);
+        if(future) *future = _future(age);
+        return 0;
+    }
+    memset(counts, 0, UUID7_AGE_BUCKETS * sizeof(*counts));
+    if(future) *future = 0;
+    for(uint32_t s = 0; s < age->cfg.shards; ++s)
+    {
+        age_shard_t* shard = &age->shards[s];
+        for(uint32_t b = 0; b < UUID7_AGE_BUCKETS; ++b)
+        {
+            /* Plain load first: most buckets are empty, and an exchange
+             * would dirty their lines in every recorder's cache */
+            if(atomic_load_explicit(&shard->counts[b], memory_order_relaxed) == 0) continue;
+            counts[b] += atomic_exchange_explicit(&shard->counts[b], 0u, memory_order_relaxed);
+        }
+        if(future) *future += atomic_exchange_explicit(&shard->future, 0u, memory_order_relaxed);
+    }
+    return 0;
+}
+
+int uuid7_age_import(uuid7_age_t* age, const uint64_t* counts, uint64_t future)
+{
+    if(!age || !counts) return -1;
+    age_shard_t* shard = _shard(age);
+    for(uint32_t b = 0; b < UUID7_AGE_BUCKETS; ++b)
+    {
+        if(counts[b]) atomic_fetch_add_explicit(&shard->counts[b], counts[b], memory_order_relaxed);
+    }
+    if(future) atomic_fetch_add_explicit(&shard->future, future, memory_order_relaxed);
+    return 0;
+}
+
+int uuid7_age_merge(uuid7_age_t* dst, const uuid7_age_t* src)
+{
+    if(!dst || !src || dst == src) return -1;
+    uint64_t counts[UUID7_AGE_BUCKETS];
+    _sum(src, counts);
+    return uuid7_age_import(dst, counts, _future(src));
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static age_shard_t* _shard(uuid7_age_t* age)
+{
+    return &age->shards[_thread_stripe() % age->cfg.shards];
+}
+
+static inline uint32_t _bucket(uint64_t age_ms)
+{
+    if(age_ms < 2u * AGE_HALF) return (uint32_t)age_ms;
+    if(age_ms > AGE_MAX_MS) age_ms = AGE_MAX_MS;
+    const uint32_t shift = 63u - (uint32_t)__builtin_clzll(age_ms) - (AGE_SUB_BITS - 1u);
+    return (shift << (AGE_SUB_BITS - 1u)) + (uint32_t)(age_ms >> shift);
+}
+
+static uint64_t _bucket_low(uint32_t b)
+{
+    if(b < 2u * AGE_HALF) return b;
+    const uint32_t shift = b / AGE_HALF - 1u;
+    return (uint64_t)(b - shift * AGE_HALF) << shift;
+}
+
+static uint64_t _bucket_high(uint32_t b)
+{
+    if(b < 2u * AGE_HALF) return b;
+    const uint32_t shift = b / AGE_HALF - 1u;
+    return _bucket_low(b) + (1ull << shift) - 1u;
+}
+
+static uint64_t _sum(const uuid7_age_t* age, uint64_t* counts)
+{
+    memset(counts, 0, UUID7_AGE_BUCKETS * sizeof(*counts));
+    for(uint32_t s = 0; s < age->cfg.shards; ++s)
+    {
+        const age_shard_t* shard = &age->shards[s];
+        for(uint32_t b = 0; b < UUID7_AGE_BUCKETS; ++b)
+        {
+            counts[b] += atomic_load_explicit(&shard->counts[b], memory_order_relaxed);
+        }
+    }
+    uint64_t total = 0;
+    for(uint32_t b = 0; b < UUID7_AGE_BUCKETS; ++b) total += counts[b];
+    return total;
+}
+
+static uint64_t _future(const uuid7_age_t* age)
+{
+    uint64_t future = 0;
+    for(uint32_t s = 0; s < age->cfg.shards; ++s)
+    {
+        future += atomic_load_explicit(&age->shards[s].future, memory_order_relaxed);
+    }
+    return future;
+}
+
+static uint32_t _rank_bucket(const uint64_t* counts, uint64_t rank)
+{
+    uint64_t seen = 0;
+    for(uint32_t b = 0; b < UUID7_AGE_BUCKETS; ++b)
+    {
+        seen += counts[b];
+        if(seen > rank) return b;
+    }
+    return UUID7_AGE_BUCKETS - 1u;
+}
+
+static uint64_t _quantile(const uint64_t* counts, uint64_t total, double q)
+{
+    const uint64_t rank = (uint64_t)(q * (double)(total - 1u));
+    const uint32_t b = _rank_bucket(counts, rank);
+    const uint64_t low = _bucket_low(b);
+    return low + (_bucket_high(b) - low) / 2u;
+}
@@ -0,0 +1,483 @@
+/**
+ * @file uuid7_arena.c
+ * @brief Time-bucketed arena allocator for objects keyed by UUIDv7.
+ *
+ * Windows live in a ring of `max_windows` slots, rounded up to a power of
+ * two, indexed by window number (ms / bucket_ms). A slot holds the number
+ * of the window occupying it, or ARENA_EMPTY, the list of its chunks, and
+ * one current chunk per thread stripe. Allocating loads the stripe's
+ * current chunk of the window and bumps its `used` offset with a CAS;
+ * threads are spread over the stripes by `_thread_stripe()`, so the CAS is
+ * uncontended until there are more threads than stripes. The chunk
+ * carries its window number, so a stale pointer from a recycled slot is
+ * recognized and never used for a different window.
+ *
+ * Claiming a window and mapping a chunk take the arena mutex; both are
+ * rare next to the bump, and mapping is a system call anyway. Releasing
+ * raises `horizon` first, so no new allocation enters a released window,
+ * then detaches the windows' chunks onto a deferred list. Allocators
+ * announce themselves in per-stripe counters (`_stripe_enter()`);
+ * deferred chunks are unmapped, or reset into the spare list, only once
+ * every counter is back to 0.
+ *
+ * @author: Roman Horshkov <roman.horshkov@gmail.com>
+ * @date:   2025
+ */
+
+#include "uuid7_arena.h"
+#include "uuid7_internal.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/****************************************************************************
+ * PRIVATE DEFINES
+ ****************************************************************************
+ */
+
+#define ARENA_DEFAULT_BUCKET_MS 1000u
+#define ARENA_DEFAULT_CHUNK     ((size_t)1 << 20)
+#define ARENA_DEFAULT_WINDOWS   1024u
+#define ARENA_DEFAULT_SPARE     16u
+#define ARENA_MIN_CHUNK         ((size_t)4096)
+#define ARENA_MAX_CHUNK         ((size_t)1 << 30)
+#define ARENA_MAX_WINDOWS       65536u
+#define ARENA_STRIPES           16u /* current chunks and active counters, by thread */
+#define ARENA_CACHE_LINE        64u
+#define ARENA_EMPTY             UINT64_MAX /* free window slot */
+#define ARENA_MS_SHIFT          16u        /* unix ms in the top 48 bits of the high word */
+
+/****************************************************************************
+ * PRIVATE STUCTURED VARIABLES
+ ****************************************************************************
+ */
+
+/* Chunk header; the objects follow it in the same mapping */
+typedef struct arena_chunk
+{
+    _Alignas(ARENA_CACHE_LINE) _Atomic size_t used;
+    uint64_t window;
+    size_t cap;   /* payload bytes */
+    size_t bytes; /* mapping bytes */
+    struct arena_chunk* next;
+} arena_chunk_t;
+
+typedef struct arena_window
+{
+    _Atomic uint64_t window; /* occupant, ARENA_EMPTY if free */
+    arena_chunk_t* chunks;   /* every chunk of the window, under the lock */
+    uint64_t n_chunks;
+    _Atomic(arena_chunk_t*) cur[ARENA_STRIPES];
+} arena_window_t;
+
+/* Threads inside the arena and their counters, one line per stripe */
+typedef struct arena_stripe
+{
+    _Alignas(ARENA_CACHE_LINE) _Atomic uint64_t active;
+    _Atomic uint64_t rejected;
+} arena_stripe_t;
+
+struct uuid7_arena
+{
+    uuid7_arena_config_t cfg;
+    arena_window_t* win;
+    uint64_t mask; /* slots - 1 */
+
+    _Alignas(ARENA_CACHE_LINE) _Atomic uint64_t horizon; /* windows below are released */
+
+    _Alignas(ARENA_CACHE_LINE) pthread_mutex_t lock;
+    arena_chunk_t* deferred;
+    arena_chunk_t* spare;
+    uint32_t spare_n;
+    _Atomic uint64_t windows;
+    _Atomic uint64_t released;
+    _Atomic uint64_t chunks;
+    _Atomic uint64_t mapped;
+
+    arena_stripe_t stripes[ARENA_STRIPES];
+};
+
+/****************************************************************************
+ * PRIVATE VARIABLES
+ ****************************************************************************
+ */
+
+/* Last window computed by this thread: consecutive IDs mostly share it,
+ * which saves the division */
+static _Thread_local struct
+{
+    uint64_t bucket_ms;
+    uint64_t lo_ms;
+    uint64_t window;
+} t_arena_window;
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS PROTOTYPES
+ ****************************************************************************
+ */
+
+/**
+ * @brief Window number of @p ms.
+ */
+static inline uint64_t _window_of(const uuid7_arena_t* a, uint64_t ms);
+
+/**
+ * @brief Announce the calling thread inside the arena; chunks it can reach
+ * stay mapped until the matching `_stripe_leave()`.
+ * @return The thread's stripe.
+ */
+static arena_stripe_t* _enter(uuid7_arena_t* a);
+
+/**
+ * @brief Take @p need bytes from @p c, or NULL if it is full.
+ */
+static inline void* _bump(arena_chunk_t* c, size_t need);
+
+/**
+ * @brief Allocate under the lock: claim the window if needed, then bump a
+ * fresh chunk (or a dedicated one for objects larger than a chunk).
+ */
+static void* _alloc_slow(uuid7_arena_t* a, uint64_t window, size_t need, arena_stripe_t* s);
+
+/**
+ * @brief A chunk with @p cap payload bytes for @p window, from the spares
+ * when it has the standard size. Caller holds the lock.
+ */
+static arena_chunk_t* _chunk_new(uuid7_arena_t* a, uint64_t window, size_t cap);
+
+/**
+ * @brief Unmap a chunk.
+ */
+static void _chunk_free(uuid7_arena_t* a, arena_chunk_t* c);
+
+/**
+ * @brief Release the windows ending at or before @p before_ms. Caller
+ * holds the lock; @p self is its stripe if it is inside the arena.
+ * @return Number of windows released.
+ */
+static size_t _release_locked(uuid7_arena_t* a, uint64_t before_ms, const arena_stripe_t* self);
+
+/**
+ * @brief Unmap or recycle deferred chunks if no other thread is inside.
+ */
+static void _reclaim(uuid7_arena_t* a, const arena_stripe_t* self);
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+void uuid7_arena_config_init(uuid7_arena_config_t* cfg)
+{
+    if(!cfg) return;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->bucket_ms = ARENA_DEFAULT_BUCKET_MS;
+    cfg->chunk_size = ARENA_DEFAULT_CHUNK;
+    cfg->max_windows = ARENA_DEFAULT_WINDOWS;
+    cfg->spare_chunks = ARENA_DEFAULT_SPARE;
+}
+
+uuid7_arena_t* uuid7_arena_create(const uuid7_arena_config_t* cfg)
+{
+    if(!cfg || cfg->bucket_ms == 0u || cfg->chunk_size < ARENA_MIN_CHUNK || cfg->chunk_size > ARENA_MAX_CHUNK ||
+       cfg->max_windows == 0u || cfg->max_windows > ARENA_MAX_WINDOWS)
+    {
+        return NULL;
+    }
+
+    uint64_t slots = 1u;
+    while(slots < cfg->max_windows) slots <<= 1;
+
+    uuid7_arena_t* a = aligned_alloc(ARENA_CACHE_LINE, sizeof(*a));
+    if(!a) return NULL;
+    memset(a, 0, sizeof(*a));
+    a->cfg = *cfg;
+    a->mask = slots - 1u;
+    a->win = calloc(slots, sizeof(*a->win));
+    if(!a->win || pthread_mutex_init(&a->lock, NULL) != 0)
+    {
+        free(a->win);
+        free(a);
+        return NULL;
+    }
+    for(uint64_t i = 0; i < slots; ++i) atomic_init(&a->win[i].window, ARENA_EMPTY);
+    return a;
+}
+
+void uuid7_arena_destroy(uuid7_arena_t* a)
+{
+    if(!a) return;
+    for(uint64_t i = 0; i <= a->mask; ++i)
+    {
+        while(a->win[i].chunks)
+        {
+            arena_chunk_t* c = a->win[i].chunks;
+            a->win[i].chunks = c->next;
+            _chunk_free(a, c);
+        }
+    }
+    arena_chunk_t* lists[2] = {a->deferred, a->spare};
+    for(int l = 0; l < 2; ++l)
+    {
+        while(lists[l])
+        {
+            arena_chunk_t* c = lists[l];
+            lists[l] = c->next;
+            _chunk_free(a, c);
+        }
+    }
+    pthread_mutex_destroy(&a->lock);
+    free(a->win);
+    free(a);
+}
+
+void* uuid7_arena_alloc(uuid7_arena_t* a, const uint8_t* id, size_t size)
+{
+    if(!a || !id || size > ARENA_MAX_CHUNK) return NULL;
+    const size_t need = size ? (size + UUID7_ARENA_ALIGN - 1u) & ~(size_t)(UUID7_ARENA_ALIGN - 1u) : UUID7_ARENA_ALIGN;
+    const uint64_t window = _window_of(a, _load_be64(id) >> ARENA_MS_SHIFT);
+
+    arena_stripe_t* s = _enter(a);
+    void* p = NULL;
+    if(window >= atomic_load(&a->horizon))
+    {
+        arena_chunk_t* c = atomic_load(&a->win[window & a->mask].cur[s - a->stripes]);
+        if(c && c->window == window) p = _bump(c, need);
+        if(!p) p = _alloc_slow(a, window, need, s);
+
+        /* A release may have raised the horizon and detached the chunk
+         * since the check above; the object must not escape then */
+        if(p && window < atomic_load(&a->horizon))
+        {
+            p = NULL;
+            atomic_fetch_add_explicit(&s->rejected, 1u, memory_order_relaxed);
+        }
+    }
+    else
+    {
+        atomic_fetch_add_explicit(&s->rejected, 1u, memory_order_relaxed);
+    }
+    _stripe_leave(&s->active);
+    return p;
+}
+
+void* uuid7_arena_gen(uuid7_arena_t* a, uint8_t* id, size_t size)
+{
+    if(!a || !id) return NULL;
+    if(uuid7_gen(id) != 0) return NULL;
+    return uuid7_arena_alloc(a, id, size);
+}
+
+size_t uuid7_arena_release(uuid7_arena_t* a, uint64_t before_ms)
+{
+    if(!a) return 0;
+    pthread_mutex_lock(&a->lock);
+    const size_t n = _release_locked(a, before_ms, NULL);
+    pthread_mutex_unlock(&a->lock);
+    return n;
+}
+
+int uuid7_arena_get_stats(uuid7_arena_t* a, uuid7_arena_stats_t* stats)
+{
+    if(!a || !stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+    for(uint32_t i = 0; i < ARENA_STRIPES; ++i)
+    {
+        stats->rejected += atomic_load_explicit(&a->stripes[i].rejected, memory_order_relaxed);
+    }
+    /* Summed from the chunks, so the bump path keeps no counters of its own */
+    pthread_mutex_lock(&a->lock);
+    for(uint64_t i = 0; i <= a->mask; ++i)
+    {
+        for(const arena_chunk_t* c = a->win[i].chunks; c; c = c->next)
+        {
+            stats->bytes += atomic_load_explicit(&c->used, memory_order_relaxed);
+        }
+    }
+    pthread_mutex_unlock(&a->lock);
+    stats->windows = atomic_load_explicit(&a->windows, memory_order_relaxed);
+    stats->released = atomic_load_explicit(&a->released, memory_order_relaxed);
+    stats->chunks = atomic_load_explicit(&a->chunks, memory_order_relaxed);
+    stats->mapped_bytes = atomic_load_explicit(&a->mapped, memory_order_relaxed);
+    return 0;
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static inline uint64_t _window_of(const uuid7_arena_t* a, uint64_t ms)
+{
+    const uint64_t bucket = a->cfg.bucket_ms;
+    if(t_arena_window.bucket_ms != bucket || ms - t_arena_window.lo_ms >= bucket)
+    {
+        t_arena_window.bucket_ms = bucket;
+        t_arena_window.window = ms / bucket;
+        t_arena_window.lo_ms = t_arena_window.window * bucket;
+    }
+    return t_arena_window.window;
+}
+
+static arena_stripe_t* _enter(uuid7_arena_t* a)
+{
+    arena_stripe_t* s = &a->stripes[_thread_stripe() % ARENA_STRIPES];
+    /* Ordered before the horizon and chunk loads */
+    _stripe_enter(&s->active);
+    return s;
+}
+
+static inline void* _bump(arena_chunk_t* c, size_t need)
+{
+    /* CAS rather than fetch-add: a refused object leaves the rest of the
+     * chunk to smaller ones */
+    size_t off = atomic_load_explicit(&c->used, memory_order_relaxed);
+    do
+    {
+        if(need > c->cap - off) return NULL;
+    } while(!atomic_compare_exchange_weak_explicit(&c->used, &off, off + need, memory_order_relaxed,
+                                                   memory_order_relaxed));
+    return (uint8_t*)c + sizeof(*c) + off;
+}
+
+static void* _alloc_slow(uuid7_arena_t* a, uint64_t window, size_t need, arena_stripe_t* s)
+{
+    const size_t stripe = (size_t)(s - a->stripes);
+    const size_t std_cap = a->cfg.chunk_size - sizeof(arena_chunk_t);
+    void* p = NULL;
+
+    pthread_mutex_lock(&a->lock);
+    if(a->cfg.retain_ms)
+    {
+        const uint64_t now = _clock_ms(a->cfg.clock_fn);
+        if(now > a->cfg.retain_ms) _release_locked(a, now - a->cfg.retain_ms, s);
+    }
+
+    arena_window_t* w = &a->win[window & a->mask];
+    const uint64_t occupant = atomic_load(&w->window);
+    if(window < atomic_load(&a->horizon) || (occupant != ARENA_EMPTY && occupant != window))
+    {
+        atomic_fetch_add_explicit(&s->rejected, 1u, memory_order_relaxed);
+        goto out;
+    }
+    if(occupant == ARENA_EMPTY)
+    {
+        atomic_store(&w->window, window);
+        atomic_fetch_add_explicit(&a->windows, 1u, memory_order_relaxed);
+    }
+
+    /* A thread sharing the stripe may have installed a fresh chunk */
+    arena_chunk_t* c = atomic_load(&w->cur[stripe]);
+    if(c && c->window == window && (p = _bump(c, need)) != NULL) goto out;
+
+    c = _chunk_new(a, window, need > std_cap ? need : std_cap);
+    if(!c) goto out;
+    c->next = w->chunks;
+    w->chunks = c;
+    w->n_chunks++;
+    p = _bump(c, need);
+    /* An oversized object gets a chunk of its own; the current one stays */
+    if(c->cap == std_cap) atomic_store(&w->cur[stripe], c);
+
+out:
+    pthread_mutex_unlock(&a->lock);
+    return p;
+}
+
+static arena_chunk_t* _chunk_new(uuid7_arena_t* a, uint64_t window, size_t cap)
+{
+    arena_chunk_t* c = NULL;
+    if(cap == a->cfg.chunk_size - sizeof(arena_chunk_t) && a->spare)
+    {
+        c = a->spare;
+        a->spare = c->next;
+        a->spare_n--;
+    }
+    else
+    {
+        const size_t bytes = sizeof(arena_chunk_t) + cap;
+        void* m = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(m == MAP_FAILED) return NULL;
+        c = m;
+        c->cap = cap;
+        c->bytes = bytes;
+        atomic_fetch_add_explicit(&a->mapped, bytes, memory_order_relaxed);
+    }
+    atomic_store_explicit(&c->used, 0u, memory_order_relaxed);
+    c->window = window;
+    c->next = NULL;
+    atomic_fetch_add_explicit(&a->chunks, 1u, memory_order_relaxed);
+    return c;
+}
+
+static void _chunk_free(uuid7_arena_t* a, arena_chunk_t* c)
+{
+    atomic_fetch_sub_explicit(&a->mapped, c->bytes, memory_order_relaxed);
+    munmap(c, c->bytes);
+}
+
+static size_t _release_locked(uuid7_arena_t* a, uint64_t before_ms, const arena_stripe_t* self)
+{
+    const uint64_t horizon = before_ms / a->cfg.bucket_ms;
+    size_t n = 0;
+    if(horizon > atomic_load(&a->horizon))
+    {
+        /* seq_cst: an allocator entering after this sees the new horizon */
+        atomic_store(&a->horizon, horizon);
+        for(uint64_t i = 0; i <= a->mask; ++i)
+        {
+            arena_window_t* w = &a->win[i];
+            const uint64_t occupant = atomic_load(&w->window);
+            if(occupant == ARENA_EMPTY || occupant >= horizon) continue;
+
+            for(uint32_t s = 0; s < ARENA_STRIPES; ++s) atomic_store(&w->cur[s], NULL);
+            arena_chunk_t* last = w->chunks;
+            while(last && last->next) last = last->next;
+            if(last)
+            {
+                last->next = a->deferred;
+                a->deferred = w->chunks;
+            }
+            atomic_fetch_sub_explicit(&a->chunks, w->n_chunks, memory_order_relaxed);
+            w->chunks = NULL;
+            w->n_chunks = 0;
+            atomic_store(&w->window, ARENA_EMPTY);
+            ++n;
+        }
+        atomic_fetch_sub_explicit(&a->windows, n, memory_order_relaxed);
+        atomic_fetch_add_explicit(&a->released, n, memory_order_relaxed);
+    }
+    _reclaim(a, self);
+    return n;
+}
+
+static void _reclaim(uuid7_arena_t* a, const arena_stripe_t* self)
+{
+    if(!a->deferred) return;
+    for(uint32_t i = 0; i < ARENA_STRIPES; ++i)
+    {
+        /* The caller itself holds no chunk pointer across the lock */
+        const uint64_t own = &a->stripes[i] == self ? 1u : 0u;
+        if(atomic_load(&a->stripes[i].active) != own) return;
+    }
+    const size_t std_bytes = a->cfg.chunk_size;
+    while(a->deferred)
+    {
+        arena_chunk_t* c = a->deferred;
+        a->deferred = c->next;
+        if(c->bytes == std_bytes && a->spare_n < a->cfg.spare_chunks)
+        {
+            c->next = a->spare;
+            a->spare = c;
+            a->spare_n++;
+        }
+        else
+        {
+            _chunk_free(a, c);
+        }
+    }
+}
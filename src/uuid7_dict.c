@@ -0,0 +1,487 @@
+/**
+ * @file uuid7_dict.c
+ * @brief Dictionary encoding for columns of repeated UUIDv7 values.
+ *
+ * The dictionary keeps the distinct IDs twice: as 16-byte entries for the
+ * decoder to copy out, and as (hi, lo) native-endian key pairs for lookups,
+ * where comparing big-endian halves as integers matches the byte order of
+ * the IDs.
+ *
+ * Building exploits time order: a value larger than everything seen so far
+ * is appended to the sorted array, so a column in generation order builds
+ * in a single pass. Smaller values are searched in the sorted array; the
+ * ones not found wait in a pending list that is sorted and merged in once
+ * it grows to a fraction of the dictionary, keeping the total cost
+ * O(n log d). Repeats of the previous value, the common shape of exported
+ * FK columns, skip the search entirely.
+ *
+ * Encoding looks values up in an open-addressing table of indexes rather
+ * than by binary search: the random tail of a v7 ID is already uniform, so
+ * the slot is the low word folded with a multiply of the high word, and a
+ * lookup is one or two cache misses instead of log2(d) dependent ones. The
+ * multiply keeps synthetic IDs with a constant tail from piling up.
+ *
+ * Decoding unpacks four indexes at a time and then copies their entries,
+ * so the four 16-byte loads are independent and overlap in the pipeline.
+ * Hardware gathers only fetch 32/64-bit lanes, so for 16-byte entries one
+ * unaligned vector load per index is the gather.
+ *
+ * @author: Roman Horshkov <roman.horshkov@gmail.com>
+ * @date:   2025
+ */
+
+#include "uuid7_dict.h"
+#include "uuid7_internal.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+/****************************************************************************
+ * PRIVATE DEFINES
+ ****************************************************************************
+ */
+
+#define DICT_ID_BYTES     16u
+#define DICT_MAX_SIZE     ((uint64_t)UINT32_MAX) /* UINT32_MAX itself marks a free slot */
+#define DICT_PENDING_MIN  1024u /* pending values before the first merge */
+#define DICT_PENDING_FRAC 8u    /* ... then merge at size / 8 */
+#define DICT_GATHER       4u    /* indexes unpacked per decode step */
+#define DICT_SLOT_EMPTY   UINT32_MAX
+#define DICT_SLOT_MUL     0x9E3779B97F4A7C15ull
+
+/****************************************************************************
+ * PRIVATE STUCTURED VARIABLES
+ ****************************************************************************
+ */
+
+/* An ID as two big-endian halves, so (hi, lo) order is byte order */
+typedef struct dict_key
+{
+    uint64_t hi;
+    uint64_t lo;
+} dict_key_t;
+
+/* Growable key array of the builder */
+typedef struct dict_vec
+{
+    dict_key_t* k;
+    size_t n;
+    size_t cap;
+} dict_vec_t;
+
+struct uuid7_dict
+{
+    uint8_t* entries; /* size * 16 bytes, sorted */
+    uint64_t* hi;
+    uint64_t* lo;
+    uint32_t* slots; /* index table, 2-4 slots per entry, DICT_SLOT_EMPTY if free */
+    uint64_t slot_mask;
+    size_t size;
+    unsigned bits;
+};
+
+/****************************************************************************
+ * PRIVATE VARIABLES
+ ****************************************************************************
+ */
+/* None */
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS PROTOTYPES
+ ****************************************************************************
+ */
+
+/**
+ * @brief Key of a 16-byte ID.
+ */
+static inline dict_key_t _key_of(const uint8_t* id);
+
+/**
+ * @brief Strict order of two keys.
+ */
+static inline bool _dkey_less(dict_key_t a, dict_key_t b);
+
+/**
+ * @brief qsort comparator over dict_key_t.
+ */
+static int _key_cmp(const void* a, const void* b);
+
+/**
+ * @brief Append a key, growing the array geometrically.
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int _vec_push(dict_vec_t* v, dict_key_t k);
+
+/**
+ * @brief Whether a sorted key array holds @p k.
+ */
+static bool _vec_has(const dict_vec_t* v, dict_key_t k);
+
+/**
+ * @brief Sort and dedup @p pend, then merge it into @p sorted. Every
+ * pending key is smaller than the last sorted one and absent from it.
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int _merge_pending(dict_vec_t* sorted, dict_vec_t* pend);
+
+/**
+ * @brief Dictionary over @p n strictly ascending keys.
+ */
+static uuid7_dict_t* _dict_from_keys(const dict_key_t* keys, size_t n);
+
+/**
+ * @brief Home slot of a key in the index table.
+ */
+static inline uint64_t _slot_of(const uuid7_dict_t* d, uint64_t hi, uint64_t lo);
+
+/**
+ * @brief Index of @p k through the index table, or -1 if absent.
+ */
+static inline int64_t _probe(const uuid7_dict_t* d, uint64_t hi, uint64_t lo);
+
+/**
+ * @brief Copy the entries of four indexes to consecutive outputs.
+ */
+static inline void _gather4(const uint8_t* entries, const uint32_t* idx, uint8_t* out);
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+uuid7_dict_t* uuid7_dict_build(const uint8_t* ids, size_t n)
+{
+    if(!ids && n) return NULL;
+
+    dict_vec_t sorted = {0};
+    dict_vec_t pend = {0};
+    dict_key_t prev = {0};
+    bool ok = true;
+    for(size_t i = 0; ok && i < n; ++i)
+    {
+        const dict_key_t k = _key_of(ids + i * DICT_ID_BYTES);
+        if(i > 0 && k.hi == prev.hi && k.lo == prev.lo) continue;
+        prev = k;
+
+        if(sorted.n == 0 || _dkey_less(sorted.k[sorted.n - 1], k))
+        {
+            ok = _vec_push(&sorted, k) == 0;
+        }
+        else if(!_vec_has(&sorted, k))
+        {
+            ok = _vec_push(&pend, k) == 0;
+            const size_t limit = sorted.n / DICT_PENDING_FRAC;
+            if(ok && pend.n >= (limit > DICT_PENDING_MIN ? limit : DICT_PENDING_MIN))
+            {
+                ok = _merge_pending(&sorted, &pend) == 0;
+            }
+        }
+    }
+    if(ok && pend.n) ok = _merge_pending(&sorted, &pend) == 0;
+
+    uuid7_dict_t* d = (ok && sorted.n <= DICT_MAX_SIZE) ? _dict_from_keys(sorted.k, sorted.n) : NULL;
+    free(sorted.k);
+    free(pend.k);
+    return d;
+}
+
+uuid7_dict_t* uuid7_dict_load(const uint8_t* entries, size_t n)
+{
+    if((!entries && n) || n > DICT_MAX_SIZE) return NULL;
+
+    dict_key_t* keys = malloc((n ? n : 1u) * sizeof(*keys));
+    if(!keys) return NULL;
+    for(size_t i = 0; i < n; ++i)
+    {
+        keys[i] = _key_of(entries + i * DICT_ID_BYTES);
+        if(i > 0 && !_dkey_less(keys[i - 1], keys[i]))
+        {
+            free(keys);
+            return NULL;
+        }
+    }
+    uuid7_dict_t* d = _dict_from_keys(keys, n);
+    free(keys);
+    return d;
+}
+
+void uuid7_dict_destroy(uuid7_dict_t* d)
+{
+    if(!d) return;
+    free(d->entries);
+    free(d->hi);
+    free(d->lo);
+    free(d->slots);
+    free(d);
+}
+
+size_t uuid7_dict_size(const uuid7_dict_t* d)
+{
+    return d ? d->size : 0u;
+}
+
+unsigned uuid7_dict_bits(const uuid7_dict_t* d)
+{
+    return d ? d->bits : 0u;
+}
+
+const uint8_t* uuid7_dict_entries(const uuid7_dict_t* d)
+{
+    return d ? d->entries : NULL;
+}
+
+size_t uuid7_dict_packed_words(const uuid7_dict_t* d, size_t n)
+{
+    if(!d) return 0u;
+    return (size_t)(((uint64_t)n * d->bits + 63u) / 64u);
+}
+
+int uuid7_dict_find(const uuid7_dict_t* d, const uint8_t* id, uint32_t* index)
+{
+    if(!d || !id || !index) return -1;
+    const int64_t at = _probe(d, _load_be64(id), _load_be64(id + 8));
+    if(at < 0) return -1;
+    *index = (uint32_t)at;
+    return 0;
+}
+
+int uuid7_dict_encode(const uuid7_dict_t* d, const uint8_t* ids, size_t n, uint64_t* packed)
+{
+    if(!d || ((!ids || !packed) && n)) return -1;
+
+    const unsigned bits = d->bits;
+    uint64_t acc = 0;
+    unsigned fill = 0;
+    uint64_t prev_hi = 0, prev_lo = 0;
+    int64_t prev = -1;
+    for(size_t i = 0; i < n; ++i, ids += DICT_ID_BYTES)
+    {
+        const uint64_t hi = _load_be64(ids);
+        const uint64_t lo = _load_be64(ids + 8);
+        if(prev < 0 || hi != prev_hi || lo != prev_lo)
+        {
+            prev = _probe(d, hi, lo);
+            if(prev < 0) return -1;
+            prev_hi = hi;
+            prev_lo = lo;
+        }
+
+        const uint64_t v = (uint64_t)prev;
+        acc |= v << fill;
+        fill += bits;
+        if(fill >= 64u)
+        {
+            *packed++ = acc;
+            fill -= 64u;
+            acc = fill ? v >> (bits - fill) : 0u;
+        }
+    }
+    if(fill) *packed = acc;
+    return 0;
+}
+
+int uuid7_dict_decode(const uuid7_dict_t* d, const uint64_t* packed, size_t n, uint8_t* ids)
+{
+    if(!d || ((!packed || !ids) && n)) return -1;
+
+    const unsigned bits = d->bits;
+    const uint64_t mask = ((uint64_t)1 << bits) - 1u;
+    const uint64_t size = d->size;
+    size_t word = 0;
+    unsigned off = 0;
+    uint32_t idx[DICT_GATHER];
+    for(size_t i = 0; i < n;)
+    {
+        const size_t k = (n - i < DICT_GATHER) ? n - i : DICT_GATHER;
+        uint64_t over = 0;
+        for(size_t j = 0; j < k; ++j)
+        {
+            /* An index straddles two words when it runs past bit 63 */
+            uint64_t v = packed[word] >> off;
+            if(off + bits > 64u) v |= packed[word + 1u] << (64u - off);
+            v &= mask;
+            over |= (uint64_t)(v >= size);
+            idx[j] = (uint32_t)v;
+            off += bits;
+            word += off >> 6;
+            off &= 63u;
+        }
+        if(over) return -1;
+
+        if(k == DICT_GATHER)
+        {
+            _gather4(d->entries, idx, ids);
+        }
+        else
+        {
+            for(size_t j = 0; j < k; ++j)
+            {
+                memcpy(ids + j * DICT_ID_BYTES, d->entries + (size_t)idx[j] * DICT_ID_BYTES, DICT_ID_BYTES);
+            }
+        }
+        ids += k * DICT_ID_BYTES;
+        i += k;
+    }
+    return 0;
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static inline dict_key_t _key_of(const uint8_t* id)
+{
+    return (dict_key_t){_load_be64(id), _load_be64(id + 8)};
+}
+
+static inline bool _dkey_less(dict_key_t a, dict_key_t b)
+{
+    return _key_less(a.hi, a.lo, b.hi, b.lo);
+}
+
+static int _key_cmp(const void* a, const void* b)
+{
+    const dict_key_t* x = a;
+    const dict_key_t* y = b;
+    if(_dkey_less(*x, *y)) return -1;
+    return _dkey_less(*y, *x) ? 1 : 0;
+}
+
+static int _vec_push(dict_vec_t* v, dict_key_t k)
+{
+    if(v->n == v->cap)
+    {
+        const size_t cap = v->cap ? v->cap * 2u : 256u;
+        dict_key_t* grown = realloc(v->k, cap * sizeof(*grown));
+        if(!grown) return -1;
+        v->k = grown;
+        v->cap = cap;
+    }
+    v->k[v->n++] = k;
+    return 0;
+}
+
+static bool _vec_has(const dict_vec_t* v, dict_key_t k)
+{
+    size_t base = 0, len = v->n;
+    while(len > 1u)
+    {
+        const size_t half = len / 2u;
+        base = _dkey_less(k, v->k[base + half]) ? base : base + half;
+        len -= half;
+    }
+    return v->n && v->k[base].hi == k.hi && v->k[base].lo == k.lo;
+}
+
+static int _merge_pending(dict_vec_t* sorted, dict_vec_t* pend)
+{
+    qsort(pend->k, pend->n, sizeof(*pend->k), _key_cmp);
+    size_t u = 0;
+    for(size_t i = 0; i < pend->n; ++i)
+    {
+        if(u == 0 || _dkey_less(pend->k[u - 1], pend->k[i])) pend->k[u++] = pend->k[i];
+    }
+
+    const size_t total = sorted->n + u;
+    dict_key_t* merged = malloc(total * sizeof(*merged));
+    if(!merged) return -1;
+    size_t a = 0, b = 0, o = 0;
+    while(a < sorted->n && b < u)
+    {
+        merged[o++] = _dkey_less(pend->k[b], sorted->k[a]) ? pend->k[b++] : sorted->k[a++];
+    }
+    while(a < sorted->n) merged[o++] = sorted->k[a++];
+    while(b < u) merged[o++] = pend->k[b++];
+
+    free(sorted->k);
+    sorted->k = merged;
+    sorted->n = sorted->cap = total;
+    pend->n = 0;
+    return 0;
+}
+
+static uuid7_dict_t* _dict_from_keys(const dict_key_t* keys, size_t n)
+{
+    uuid7_dict_t* d = calloc(1, sizeof(*d));
+    if(!d) return NULL;
+    const size_t alloc_n = n ? n : 1u;
+    d->entries = malloc(alloc_n * DICT_ID_BYTES);
+    d->hi = malloc(alloc_n * sizeof(*d->hi));
+    d->lo = malloc(alloc_n * sizeof(*d->lo));
+    if(!d->entries || !d->hi || !d->lo)
+    {
+        uuid7_dict_destroy(d);
+        return NULL;
+    }
+
+    for(size_t i = 0; i < n; ++i)
+    {
+        d->hi[i] = keys[i].hi;
+        d->lo[i] = keys[i].lo;
+        for(unsigned b = 0; b < 8u; ++b)
+        {
+            d->entries[i * DICT_ID_BYTES + b] = (uint8_t)(keys[i].hi >> (56u - 8u * b));
+            d->entries[i * DICT_ID_BYTES + 8u + b] = (uint8_t)(keys[i].lo >> (56u - 8u * b));
+        }
+    }
+    d->size = n;
+    d->bits = n > 1u ? 64u - (unsigned)__builtin_clzll((uint64_t)n - 1u) : 1u;
+
+    /* Next power of two at least twice the size: load factor <= 1/2 */
+    const uint64_t nslots = (uint64_t)2 << d->bits;
+    d->slot_mask = nslots - 1u;
+    d->slots = malloc((size_t)nslots * sizeof(*d->slots));
+    if(!d->slots)
+    {
+        uuid7_dict_destroy(d);
+        return NULL;
+    }
+    memset(d->slots, 0xFF, (size_t)nslots * sizeof(*d->slots));
+    for(size_t i = 0; i < n; ++i)
+    {
+        uint64_t s = _slot_of(d, d->hi[i], d->lo[i]);
+        while(d->slots[s] != DICT_SLOT_EMPTY) s = (s + 1u) & d->slot_mask;
+        d->slots[s] = (uint32_t)i;
+    }
+    return d;
+}
+
+static inline uint64_t _slot_of(const uuid7_dict_t* d, uint64_t hi, uint64_t lo)
+{
+    return (lo ^ (hi * DICT_SLOT_MUL)) & d->slot_mask;
+}
+
+static inline int64_t _probe(const uuid7_dict_t* d, uint64_t hi, uint64_t lo)
+{
+    for(uint64_t s = _slot_of(d, hi, lo);; s = (s + 1u) & d->slot_mask)
+    {
+        const uint32_t i = d->slots[s];
+        if(i == DICT_SLOT_EMPTY) return -1;
+        if(d->hi[i] == hi && d->lo[i] == lo) return (int64_t)i;
+    }
+}
+
+static inline void _gather4(const uint8_t* entries, const uint32_t* idx, uint8_t* out)
+{
+#if defined(__SSE2__)
+    const __m128i a = _mm_loadu_si128((const __m128i*)(const void*)(entries + (size_t)idx[0] * DICT_ID_BYTES));
+    const __m128i b = _mm_loadu_si128((const __m128i*)(const void*)(entries + (size_t)idx[1] * DICT_ID_BYTES));
+    const __m128i c = _mm_loadu_si128((const __m128i*)(const void*)(entries + (size_t)idx[2] * DICT_ID_BYTES));
+    const __m128i e = _mm_loadu_si128((const __m128i*)(const void*)(entries + (size_t)idx[3] * DICT_ID_BYTES));
+    _mm_storeu_si128((__m128i*)(void*)out, a);
+    _mm_storeu_si128((__m128i*)(void*)(out + 16), b);
+    _mm_storeu_si128((__m128i*)(void*)(out + 32), c);
+    _mm_storeu_si128((__m128i*)(void*)(out + 48), e);
+#else
+    for(unsigned j = 0; j < DICT_GATHER; ++j)
+    {
+        memcpy(out + j * DICT_ID_BYTES, entries + (size_t)idx[j] * DICT_ID_BYTES, DICT_ID_BYTES);
+    }
+#endif
+}
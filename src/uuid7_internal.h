@@ -0,0 +1,133 @@
+/**
+ * @file uuid7_internal.h
+ * @brief Private helpers shared by the library's translation units.
+ *
+ * Not installed and not part of the API. Everything here is `static inline`,
+ * so each module gets its own copy and nothing is exported.
+ *
+ * @author  Roman Horshkov <roman.horshkov@gmail.com>
+ * @date    2025
+ * (c) 2025
+ */
+
+#ifndef UUID7_INTERNAL_H
+#define UUID7_INTERNAL_H
+
+#include "uuid7.h" /* uuid_clock_fn_t */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+/**
+ * @brief Read 8 bytes as a big-endian integer (one half of a 128-bit key).
+ */
+static inline uint64_t _load_be64(const uint8_t* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    v = __builtin_bswap64(v);
+#elif !defined(__BYTE_ORDER__) || (__BYTE_ORDER__ != __ORDER_BIG_ENDIAN__)
+    v = 0;
+    for(int i = 0; i < 8; ++i) v = (v << 8) | p[i];
+#endif
+    return v;
+}
+
+/**
+ * @brief Write @p v as 8 big-endian bytes.
+ */
+static inline void _store_be64(uint8_t* p, uint64_t v)
+{
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    v = __builtin_bswap64(v);
+    memcpy(p, &v, sizeof(v));
+#elif defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    memcpy(p, &v, sizeof(v));
+#else
+    for(int i = 7; i >= 0; --i)
+    {
+        p[i] = (uint8_t)v;
+        v >>= 8;
+    }
+#endif
+}
+
+/**
+ * @brief 128-bit key order: (ahi, alo) < (bhi, blo), i.e. ID byte order.
+ */
+static inline bool _key_less(uint64_t ahi, uint64_t alo, uint64_t bhi, uint64_t blo)
+{
+    return ahi < bhi || (ahi == bhi && alo < blo);
+}
+
+/**
+ * @brief Spin-wait hint for busy loops.
+ */
+static inline void _cpu_relax(void)
+{
+#if defined(__SSE2__)
+    _mm_pause();
+#endif
+}
+
+/**
+ * @brief Current unix time in ms from @p clock_fn, or CLOCK_REALTIME when
+ * it is NULL (the modules' `clock_fn` configuration).
+ */
+static inline uint64_t _clock_ms(uuid_clock_fn_t clock_fn)
+{
+    if(clock_fn) return clock_fn();
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)(ts.tv_nsec / 1000000u);
+}
+
+/**
+ * @brief Small number of the calling thread, assigned on first use.
+ *
+ * Modules spread threads over per-thread stripes or shards with it (modulo
+ * their count), so threads do not share a counter until there are more of
+ * them than stripes. Numbers are not reused after a thread exits.
+ */
+static inline uint32_t _thread_stripe(void)
+{
+    static _Atomic uint32_t seq = 0u;
+    static _Thread_local uint32_t self; /* number + 1, 0 until assigned */
+    if(self == 0u) self = atomic_fetch_add_explicit(&seq, 1u, memory_order_relaxed) + 1u;
+    return self - 1u;
+}
+
+/**
+ * @brief Announce the calling thread in a stripe's @p active counter.
+ *
+ * seq_cst: the increment is ordered before every shared pointer the thread
+ * loads afterwards, so a reclaimer that unlinked memory and then reads 0
+ * from every counter knows no thread can still reach it.
+ */
+static inline void _stripe_enter(_Atomic uint64_t* active)
+{
+    atomic_fetch_add(active, 1u);
+}
+
+/**
+ * @brief Undo `_stripe_enter()`.
+ */
+static inline void _stripe_leave(_Atomic uint64_t* active)
+{
+    atomic_fetch_sub(active, 1u);
+}
+
+#endif  // UUID7_INTERNAL_H
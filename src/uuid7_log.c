@@ -0,0 +1,717 @@
+/**
+ * @file uuid7_log.c
+ * @brief Lock-free append-only in-memory event log indexed by UUIDv7.
+ *
+ * Each segment owns one 64-bit state word packing the ID sequence and the
+ * slot allocator: `[ms delta : 32][seq : 12][reserved slots : 20]`, the ms
+ * being relative to the segment's base. An append is one CAS on that word
+ * that advances (ms, seq) the way `uuid7_gen()` does and takes the next
+ * slot, so slot order and ID order cannot disagree. The slot is then filled
+ * and published by storing the key's high word, which is never 0 for a v7
+ * ID; `committed`, the readable prefix, is advanced past every published
+ * slot by whichever appender finds it can move it.
+ *
+ * A full segment (all slots reserved) is followed by a new one whose state
+ * continues the old sequence, or starts at the current ms if that is later.
+ * If a segment sits idle until its 32-bit ms delta would overflow (49
+ * days), it is sealed early and its unused slots become holes: keys with
+ * the last real high word and an all-ones low word (a v7 tail always has
+ * the variant bits 10), which keep the keys sorted and are skipped by
+ * reads.
+ *
+ * Segments live in a directory ring indexed by segment number. A free entry
+ * holds the odd marker `(number << 1) | 1` of the segment it awaits, so a
+ * delayed roller can never install a segment into a later lap of the ring.
+ * Retiring replaces the entry with the marker for `number + max_segments`
+ * before advancing `head`; the memory goes to a deferred list and is
+ * unmapped once the per-stripe counters of threads inside the log sum to 0.
+ *
+ * Searches bisect the segments by their first key and interpolate on the
+ * high word inside one: IDs are close to uniform in time, so a probe
+ * usually lands next to the target; each probe is followed by a bisection
+ * step, which bounds the worst case at twice the binary search.
+ *
+ * @author: Roman Horshkov <roman.horshkov@gmail.com>
+ * @date:   2025
+ */
+
+#include "uuid7_log.h"
+#include "uuid7_internal.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/****************************************************************************
+ * PRIVATE DEFINES
+ ****************************************************************************
+ */
+
+#define LOG_DEFAULT_RECORD   64u
+#define LOG_DEFAULT_SEG      65536u
+#define LOG_DEFAULT_SEGMENTS 1024u
+#define LOG_MAX_RECORD       ((size_t)1 << 24)
+#define LOG_MAX_SEG          ((1u << 20) - 1u)
+#define LOG_MAX_SEGMENTS     (1u << 20)
+#define LOG_UUID_BYTES       16u
+#define LOG_CACHE_LINE       64u
+#define LOG_STRIPES          16u /* active-thread counters, by thread */
+#define LOG_SCAN             8u  /* search intervals this short are scanned */
+#define LOG_HOLE_LO          UINT64_MAX
+
+/* Segment state word */
+#define LOG_SLOT_BITS     20u
+#define LOG_SEQ_BITS      12u
+#define LOG_DELTA_SHIFT   (LOG_SLOT_BITS + LOG_SEQ_BITS)
+#define LOG_SLOT_MASK     ((1ull << LOG_SLOT_BITS) - 1u)
+#define LOG_SEQ_MASK      ((1ull << LOG_SEQ_BITS) - 1u)
+#define LOG_DELTA_MAX     UINT32_MAX
+#define LOG_PACK(d, q, n) (((uint64_t)(d) << LOG_DELTA_SHIFT) | ((uint64_t)(q) << LOG_SLOT_BITS) | (uint64_t)(n))
+#define LOG_DELTA(s)      ((uint64_t)(s) >> LOG_DELTA_SHIFT)
+#define LOG_SEQ(s)        (((uint64_t)(s) >> LOG_SLOT_BITS) & LOG_SEQ_MASK)
+#define LOG_SLOT(s)       ((uint64_t)(s) & LOG_SLOT_MASK)
+
+/* High word of an ID: 48-bit ms, version 7, 12-bit seq */
+#define LOG_HI(ms, q)  (((uint64_t)(ms) << 16) | 0x7000u | (uint64_t)(q))
+#define LOG_HI_MS(hi)  ((uint64_t)(hi) >> 16)
+#define LOG_MS_LIMIT   (1ull << 48)
+
+/* Directory entry of a free slot awaiting segment @p no */
+#define LOG_MARKER(no) (((uint64_t)(no) << 1) | 1u)
+
+/****************************************************************************
+ * PRIVATE STUCTURED VARIABLES
+ ****************************************************************************
+ */
+
+/* ID of a slot as two big-endian halves; hi is 0 until published */
+typedef struct log_key
+{
+    _Atomic uint64_t hi;
+    uint64_t lo;
+} log_key_t;
+
+/* Segment header, at the start of its mapping */
+typedef struct log_seg
+{
+    _Alignas(LOG_CACHE_LINE) _Atomic uint64_t state;
+    _Alignas(LOG_CACHE_LINE) _Atomic uint64_t committed;
+    uint64_t no;
+    uint64_t base_ms;
+    size_t bytes;
+    struct log_seg* next; /* deferred list */
+    log_key_t* keys;
+    uint8_t* data;
+} log_seg_t;
+
+/* Threads inside the log, one counter per line */
+typedef struct log_stripe
+{
+    _Alignas(LOG_CACHE_LINE) _Atomic uint64_t active;
+} log_stripe_t;
+
+struct uuid7_log
+{
+    uuid7_log_config_t cfg;
+    _Atomic uint64_t* dir; /* max_segments entries: segment pointer or marker */
+
+    _Alignas(LOG_CACHE_LINE) _Atomic uint64_t head; /* oldest live segment */
+    _Atomic uint64_t tail;                          /* segment taking appends */
+    _Atomic uint32_t deferred_n;
+
+    _Alignas(LOG_CACHE_LINE) _Atomic uint32_t lock; /* retire try-lock */
+    log_seg_t* deferred;
+    _Atomic uint64_t retired;
+    _Atomic uint64_t rejected;
+    _Atomic uint64_t mapped;
+
+    log_stripe_t stripes[LOG_STRIPES];
+};
+
+/****************************************************************************
+ * PRIVATE VARIABLES
+ ****************************************************************************
+ */
+
+/* None */
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS PROTOTYPES
+ ****************************************************************************
+ */
+
+/**
+ * @brief Announce the calling thread inside the log; segments it can reach
+ * stay mapped until the matching `_stripe_leave()`.
+ * @return The thread's stripe.
+ */
+static log_stripe_t* _enter(uuid7_log_t* log);
+
+/**
+ * @brief Map and initialize a segment continuing the sequence at
+ * (@p base_ms, @p seq).
+ * @return Segment, or NULL if the mapping failed.
+ */
+static log_seg_t* _seg_new(uuid7_log_t* log, uint64_t no, uint64_t base_ms, uint64_t seq);
+
+/**
+ * @brief Unmap a segment.
+ */
+static void _seg_free(uuid7_log_t* log, log_seg_t* seg);
+
+/**
+ * @brief Segment @p no if it is in the directory, else NULL.
+ */
+static inline log_seg_t* _seg_at(uuid7_log_t* log, uint64_t no);
+
+/**
+ * @brief Move `committed` past every published slot.
+ */
+static void _advance(log_seg_t* seg, uint64_t cap);
+
+/**
+ * @brief Turn the unused slots of a segment sealed at state @p s into holes.
+ */
+static void _fill_holes(log_seg_t* seg, uint64_t s, uint64_t cap);
+
+/**
+ * @brief Install the segment after the full @p seg and move the tail to it.
+ * @return 0 when the caller should retry, -1 if the directory is full.
+ */
+static int _roll(uuid7_log_t* log, log_seg_t* seg, uint64_t now_ms);
+
+/**
+ * @brief First slot below @p n whose key is >= (hi, lo), or @p n.
+ */
+static uint64_t _lower_bound(const log_seg_t* seg, uint64_t n, uint64_t hi, uint64_t lo);
+
+/**
+ * @brief Whether segment @p no has a first record below (hi, lo).
+ */
+static bool _starts_below(uuid7_log_t* log, uint64_t no, uint64_t hi, uint64_t lo);
+
+/**
+ * @brief Point @p cur at the first record with key >= (hi, lo). The
+ * position may be early, never late: the cursor skips what is below.
+ */
+static void _seek(uuid7_log_t* log, uint64_t hi, uint64_t lo, uuid7_log_cursor_t* cur);
+
+/**
+ * @brief Try-lock guarding retirement and the deferred list.
+ */
+static bool _try_lock(uuid7_log_t* log);
+static void _unlock(uuid7_log_t* log);
+
+/**
+ * @brief Unlink full segments older than @p before_ms. Lock held.
+ * @return Segments unlinked.
+ */
+static size_t _unlink_old(uuid7_log_t* log, uint64_t before_ms);
+
+/**
+ * @brief Unmap the deferred segments if no thread is inside. Lock held.
+ */
+static void _reclaim(uuid7_log_t* log);
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+void uuid7_log_config_init(uuid7_log_config_t* cfg)
+{
+    if(!cfg) return;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->record_size = LOG_DEFAULT_RECORD;
+    cfg->segment_records = LOG_DEFAULT_SEG;
+    cfg->max_segments = LOG_DEFAULT_SEGMENTS;
+}
+
+uuid7_log_t* uuid7_log_create(const uuid7_log_config_t* cfg)
+{
+    if(!cfg || cfg->record_size > LOG_MAX_RECORD || cfg->segment_records == 0u ||
+       cfg->segment_records > LOG_MAX_SEG || cfg->max_segments < 2u || cfg->max_segments > LOG_MAX_SEGMENTS)
+    {
+        return NULL;
+    }
+
+    uuid7_log_t* log = calloc(1, sizeof(*log));
+    if(!log) return NULL;
+    log->cfg = *cfg;
+    log->dir = malloc(cfg->max_segments * sizeof(*log->dir));
+    log_seg_t* first = log->dir ? _seg_new(log, 0u, _clock_ms(log->cfg.clock_fn), 0u) : NULL;
+    if(!first)
+    {
+        free(log->dir);
+        free(log);
+        return NULL;
+    }
+    atomic_init(&log->dir[0], (uint64_t)(uintptr_t)first);
+    for(uint32_t i = 1; i < cfg->max_segments; ++i) atomic_init(&log->dir[i], LOG_MARKER(i));
+    return log;
+}
+
+void uuid7_log_destroy(uuid7_log_t* log)
+{
+    if(!log) return;
+    const uint64_t tail = atomic_load(&log->tail);
+    for(uint64_t no = atomic_load(&log->head); no <= tail; ++no)
+    {
+        log_seg_t* seg = _seg_at(log, no);
+        if(seg) _seg_free(log, seg);
+    }
+    while(log->deferred)
+    {
+        log_seg_t* seg = log->deferred;
+        log->deferred = seg->next;
+        _seg_free(log, seg);
+    }
+    free(log->dir);
+    free(log);
+}
+
+int uuid7_log_append(uuid7_log_t* log, const void* record, uint8_t* id)
+{
+    if(!log || !id || (!record && log->cfg.record_size)) return -1;
+
+    /* Random tail first, to keep the CAS window short */
+    uint8_t rnd[LOG_UUID_BYTES];
+    if(uuid7_gen_v4(rnd) != 0) return -1;
+    const uint64_t lo = _load_be64(rnd + 8);
+    const uint64_t now = _clock_ms(log->cfg.clock_fn);
+    const uint64_t cap = log->cfg.segment_records;
+
+    log_stripe_t* stripe = _enter(log);
+    int rc = -1;
+    for(;;)
+    {
+        log_seg_t* seg = _seg_at(log, atomic_load(&log->tail));
+        if(!seg) continue; /* tail moved between the two loads */
+
+        uint64_t s = atomic_load_explicit(&seg->state, memory_order_acquire);
+        const uint64_t n = LOG_SLOT(s);
+        if(n >= cap)
+        {
+            if(_roll(log, seg, now) != 0) break;
+            continue;
+        }
+
+        /* Same rule as the generator: a new ms restarts the sequence, the
+         * same (or an earlier) ms increments it, and a full ms borrows the
+         * next one */
+        const uint64_t d = LOG_DELTA(s);
+        const uint64_t q = LOG_SEQ(s);
+        const uint64_t elapsed = now > seg->base_ms ? now - seg->base_ms : 0u;
+        uint64_t nd = d, nq = q + 1u;
+        if(elapsed > d)
+        {
+            nd = elapsed;
+            nq = 0u;
+        }
+        else if(nq > LOG_SEQ_MASK)
+        {
+            nd = d + 1u;
+            nq = 0u;
+        }
+        if(nd > LOG_DELTA_MAX || seg->base_ms + nd >= LOG_MS_LIMIT)
+        {
+            /* Seal the segment at its last ID and let the roll continue */
+            if(atomic_compare_exchange_strong(&seg->state, &s, LOG_PACK(d, q, cap))) _fill_holes(seg, s, cap);
+            continue;
+        }
+        if(!atomic_compare_exchange_weak(&seg->state, &s, LOG_PACK(nd, nq, n + 1u))) continue;
+
+        const uint64_t hi = LOG_HI(seg->base_ms + nd, nq);
+        _store_be64(id, hi);
+        memcpy(id + 8, rnd + 8, 8);
+        seg->keys[n].lo = lo;
+        if(log->cfg.record_size) memcpy(seg->data + n * log->cfg.record_size, record, log->cfg.record_size);
+        atomic_store(&seg->keys[n].hi, hi);
+        _advance(seg, cap);
+        rc = 0;
+        break;
+    }
+    _stripe_leave(&stripe->active);
+
+    if(rc != 0) atomic_fetch_add_explicit(&log->rejected, 1u, memory_order_relaxed);
+    if(atomic_load_explicit(&log->deferred_n, memory_order_relaxed) && _try_lock(log))
+    {
+        _reclaim(log);
+        _unlock(log);
+    }
+    return rc;
+}
+
+int uuid7_log_since(uuid7_log_t* log, const uint8_t* id, uuid7_log_cursor_t* cur)
+{
+    if(!log || !cur) return -1;
+    if(!id)
+    {
+        _seek(log, 0u, 0u, cur);
+        return 0;
+    }
+
+    /* Smallest key above the ID; past the largest key nothing qualifies */
+    uint64_t hi = _load_be64(id);
+    uint64_t lo = _load_be64(id + 8) + 1u;
+    if(lo == 0u && ++hi == 0u)
+    {
+        hi = lo = UINT64_MAX;
+    }
+    _seek(log, hi, lo, cur);
+    return 0;
+}
+
+int uuid7_log_since_ms(uuid7_log_t* log, uint64_t ms, uuid7_log_cursor_t* cur)
+{
+    if(!log || !cur) return -1;
+    if(ms >= LOG_MS_LIMIT)
+    {
+        _seek(log, UINT64_MAX, UINT64_MAX, cur);
+    }
+    else
+    {
+        _seek(log, ms << 16, 0u, cur);
+    }
+    return 0;
+}
+
+size_t uuid7_log_read(uuid7_log_t* log, uuid7_log_cursor_t* cur, uint64_t end_ms, uint8_t* ids, void* records,
+                      size_t max)
+{
+    if(!log || !cur) return 0u;
+
+    const uint64_t cap = log->cfg.segment_records;
+    const size_t rs = log->cfg.record_size;
+    const uint64_t end_hi = end_ms < LOG_MS_LIMIT ? end_ms << 16 : UINT64_MAX;
+    uint8_t* rec_out = records;
+    size_t out = 0;
+    bool stop = false;
+
+    log_stripe_t* stripe = _enter(log);
+    while(out < max && !stop)
+    {
+        uint64_t no = cur->pos / cap;
+        const uint64_t head = atomic_load(&log->head);
+        if(no < head)
+        {
+            no = head;
+            cur->pos = head * cap;
+        }
+        const log_seg_t* seg = _seg_at(log, no);
+        if(!seg) break; /* not created yet, or retired under us: next call */
+
+        const uint64_t n = atomic_load_explicit(&seg->committed, memory_order_acquire);
+        uint64_t idx = cur->pos - no * cap;
+        if(idx >= n)
+        {
+            if(n < cap) break;
+            cur->pos = (no + 1u) * cap;
+            continue;
+        }
+
+        for(; idx < n && out < max; ++idx)
+        {
+            const uint64_t hi = atomic_load_explicit(&seg->keys[idx].hi, memory_order_relaxed);
+            const uint64_t lo = seg->keys[idx].lo;
+            if(hi >= end_hi)
+            {
+                stop = true;
+                break;
+            }
+            if(lo == LOG_HOLE_LO || _key_less(hi, lo, cur->min_hi, cur->min_lo)) continue;
+
+            /* Positions are in key order: once one passes, all later do */
+            cur->min_hi = cur->min_lo = 0u;
+            if(ids)
+            {
+                _store_be64(ids + out * LOG_UUID_BYTES, hi);
+                _store_be64(ids + out * LOG_UUID_BYTES + 8u, lo);
+            }
+            if(rec_out && rs) memcpy(rec_out + out * rs, seg->data + idx * rs, rs);
+            ++out;
+        }
+        cur->pos = no * cap + idx;
+    }
+    _stripe_leave(&stripe->active);
+    return out;
+}
+
+size_t uuid7_log_retire(uuid7_log_t* log, uint64_t before_ms)
+{
+    if(!log || !_try_lock(log)) return 0u;
+    const size_t n = _unlink_old(log, before_ms);
+    _reclaim(log);
+    _unlock(log);
+    return n;
+}
+
+int uuid7_log_get_stats(uuid7_log_t* log, uuid7_log_stats_t* stats)
+{
+    if(!log || !stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+
+    log_stripe_t* stripe = _enter(log);
+    const uint64_t head = atomic_load(&log->head);
+    const uint64_t tail = atomic_load(&log->tail);
+    for(uint64_t no = head; no <= tail; ++no)
+    {
+        const log_seg_t* seg = _seg_at(log, no);
+        if(!seg) continue;
+        stats->segments++;
+        stats->records += atomic_load_explicit(&seg->committed, memory_order_relaxed);
+    }
+    _stripe_leave(&stripe->active);
+    stats->retired = atomic_load_explicit(&log->retired, memory_order_relaxed);
+    stats->rejected = atomic_load_explicit(&log->rejected, memory_order_relaxed);
+    stats->mapped_bytes = atomic_load_explicit(&log->mapped, memory_order_relaxed);
+    return 0;
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static log_stripe_t* _enter(uuid7_log_t* log)
+{
+    log_stripe_t* s = &log->stripes[_thread_stripe() % LOG_STRIPES];
+    /* Ordered before every segment pointer this thread loads */
+    _stripe_enter(&s->active);
+    return s;
+}
+
+static log_seg_t* _seg_new(uuid7_log_t* log, uint64_t no, uint64_t base_ms, uint64_t seq)
+{
+    const size_t cap = log->cfg.segment_records;
+    const size_t hdr = (sizeof(log_seg_t) + LOG_CACHE_LINE - 1u) & ~(size_t)(LOG_CACHE_LINE - 1u);
+    const size_t bytes = hdr + cap * sizeof(log_key_t) + cap * log->cfg.record_size;
+    void* p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(p == MAP_FAILED) return NULL;
+
+    /* Fresh anonymous pages are zero: every key starts unpublished */
+    log_seg_t* seg = p;
+    atomic_init(&seg->state, LOG_PACK(0u, seq, 0u));
+    atomic_init(&seg->committed, 0u);
+    seg->no = no;
+    seg->base_ms = base_ms;
+    seg->bytes = bytes;
+    seg->next = NULL;
+    seg->keys = (log_key_t*)(void*)((uint8_t*)p + hdr);
+    seg->data = (uint8_t*)(seg->keys + cap);
+    atomic_fetch_add_explicit(&log->mapped, bytes, memory_order_relaxed);
+    return seg;
+}
+
+static void _seg_free(uuid7_log_t* log, log_seg_t* seg)
+{
+    atomic_fetch_sub_explicit(&log->mapped, seg->bytes, memory_order_relaxed);
+    munmap(seg, seg->bytes);
+}
+
+static inline log_seg_t* _seg_at(uuid7_log_t* log, uint64_t no)
+{
+    const uint64_t v = atomic_load(&log->dir[no % log->cfg.max_segments]);
+    if(v & 1u) return NULL;
+    log_seg_t* seg = (log_seg_t*)(uintptr_t)v;
+    return seg->no == no ? seg : NULL;
+}
+
+static void _advance(log_seg_t* seg, uint64_t cap)
+{
+    /* seq_cst on both sides: of two appenders finishing adjacent slots, at
+     * least one sees the other's publish and carries `committed` past it */
+    uint64_t c = atomic_load(&seg->committed);
+    while(c < cap && atomic_load(&seg->keys[c].hi) != 0u)
+    {
+        if(atomic_compare_exchange_weak(&seg->committed, &c, c + 1u)) ++c;
+    }
+}
+
+static void _fill_holes(log_seg_t* seg, uint64_t s, uint64_t cap)
+{
+    const uint64_t hi = LOG_HI(seg->base_ms + LOG_DELTA(s), LOG_SEQ(s));
+    for(uint64_t i = LOG_SLOT(s); i < cap; ++i)
+    {
+        seg->keys[i].lo = LOG_HOLE_LO;
+        atomic_store(&seg->keys[i].hi, hi);
+    }
+    _advance(seg, cap);
+}
+
+static int _roll(uuid7_log_t* log, log_seg_t* seg, uint64_t now_ms)
+{
+    const uint64_t no = seg->no;
+    if(atomic_load(&log->tail) != no) return 0;
+
+    if(!_seg_at(log, no + 1u))
+    {
+        const uint32_t max = log->cfg.max_segments;
+        if(log->cfg.retain_ms && now_ms > log->cfg.retain_ms && _try_lock(log))
+        {
+            _unlink_old(log, now_ms - log->cfg.retain_ms);
+            _unlock(log);
+        }
+        if(no + 1u - atomic_load(&log->head) >= max) return -1;
+
+        /* Continue after the last ID, or restart the sequence at the current
+         * time if it is later (an idle-sealed segment must not carry its old
+         * base forward) */
+        const uint64_t s = atomic_load(&seg->state);
+        const uint64_t last_ms = seg->base_ms + LOG_DELTA(s);
+        log_seg_t* next = now_ms > last_ms ? _seg_new(log, no + 1u, now_ms, 0u)
+                                           : _seg_new(log, no + 1u, last_ms, LOG_SEQ(s));
+        if(!next) return -1;
+        uint64_t expected = LOG_MARKER(no + 1u);
+        if(!atomic_compare_exchange_strong(&log->dir[(no + 1u) % max], &expected, (uint64_t)(uintptr_t)next))
+        {
+            _seg_free(log, next); /* another roller won; ours was never visible */
+        }
+    }
+    uint64_t expected = no;
+    atomic_compare_exchange_strong(&log->tail, &expected, no + 1u);
+    return 0;
+}
+
+static uint64_t _lower_bound(const log_seg_t* seg, uint64_t n, uint64_t hi, uint64_t lo)
+{
+    /* Invariant: keys below a are < target, keys from b on are >= target */
+    uint64_t a = 0, b = n;
+    while(b - a > LOG_SCAN)
+    {
+        const uint64_t ka = atomic_load_explicit(&seg->keys[a].hi, memory_order_relaxed);
+        const uint64_t kb = atomic_load_explicit(&seg->keys[b - 1u].hi, memory_order_relaxed);
+        if(hi > kb) return b;
+
+        uint64_t m = a;
+        if(hi > ka) m = a + (uint64_t)((double)(hi - ka) / (double)(kb - ka) * (double)(b - 1u - a));
+        if(_key_less(atomic_load_explicit(&seg->keys[m].hi, memory_order_relaxed), seg->keys[m].lo, hi, lo))
+        {
+            a = m + 1u;
+        }
+        else
+        {
+            b = m;
+        }
+        if(b - a <= LOG_SCAN) break;
+
+        const uint64_t mid = a + (b - a) / 2u;
+        if(_key_less(atomic_load_explicit(&seg->keys[mid].hi, memory_order_relaxed), seg->keys[mid].lo, hi, lo))
+        {
+            a = mid + 1u;
+        }
+        else
+        {
+            b = mid;
+        }
+    }
+    while(a < b && _key_less(atomic_load_explicit(&seg->keys[a].hi, memory_order_relaxed), seg->keys[a].lo, hi, lo))
+    {
+        ++a;
+    }
+    return a;
+}
+
+static bool _starts_below(uuid7_log_t* log, uint64_t no, uint64_t hi, uint64_t lo)
+{
+    const log_seg_t* seg = _seg_at(log, no);
+    if(!seg) return true; /* retired under us: older than everything live */
+    if(atomic_load_explicit(&seg->committed, memory_order_acquire) == 0u) return false;
+    return _key_less(atomic_load_explicit(&seg->keys[0].hi, memory_order_relaxed), seg->keys[0].lo, hi, lo);
+}
+
+static void _seek(uuid7_log_t* log, uint64_t hi, uint64_t lo, uuid7_log_cursor_t* cur)
+{
+    const uint64_t cap = log->cfg.segment_records;
+    cur->min_hi = hi;
+    cur->min_lo = lo;
+
+    log_stripe_t* stripe = _enter(log);
+    const uint64_t head = atomic_load(&log->head);
+    const uint64_t tail = atomic_load(&log->tail);
+
+    /* Last segment starting below the target: it holds the lower bound, or
+     * the bound is the start of the next segment. Recent targets hit the
+     * tail; otherwise bisect over the segment numbers. */
+    uint64_t a = head, b = tail + 1u;
+    if(_starts_below(log, tail, hi, lo)) a = b;
+    while(a < b)
+    {
+        const uint64_t mid = a + (b - a) / 2u;
+        if(_starts_below(log, mid, hi, lo))
+        {
+            a = mid + 1u;
+        }
+        else
+        {
+            b = mid;
+        }
+    }
+
+    uint64_t pos = head * cap;
+    if(a > head)
+    {
+        const uint64_t no = a - 1u;
+        const log_seg_t* seg = _seg_at(log, no);
+        pos = seg ? no * cap + _lower_bound(seg, atomic_load_explicit(&seg->committed, memory_order_acquire), hi, lo)
+                  : (no + 1u) * cap;
+    }
+    _stripe_leave(&stripe->active);
+    cur->pos = pos;
+}
+
+static bool _try_lock(uuid7_log_t* log)
+{
+    uint32_t expected = 0u;
+    return atomic_compare_exchange_strong_explicit(&log->lock, &expected, 1u, memory_order_acquire,
+                                                   memory_order_relaxed);
+}
+
+static void _unlock(uuid7_log_t* log)
+{
+    atomic_store_explicit(&log->lock, 0u, memory_order_release);
+}
+
+static size_t _unlink_old(uuid7_log_t* log, uint64_t before_ms)
+{
+    const uint64_t cap = log->cfg.segment_records;
+    const uint32_t max = log->cfg.max_segments;
+    size_t n = 0;
+    for(;;)
+    {
+        const uint64_t h = atomic_load(&log->head);
+        if(h >= atomic_load(&log->tail)) break; /* never the open segment */
+        log_seg_t* seg = _seg_at(log, h);
+        if(!seg || atomic_load(&seg->committed) != cap) break;
+        if(LOG_HI_MS(atomic_load(&seg->keys[cap - 1u].hi)) >= before_ms) break;
+
+        /* Free the entry for the segment one lap later, then publish the new
+         * head: a roller that sees the head moved also sees the marker */
+        atomic_store(&log->dir[h % max], LOG_MARKER(h + max));
+        atomic_store(&log->head, h + 1u);
+        seg->next = log->deferred;
+        log->deferred = seg;
+        atomic_fetch_add(&log->deferred_n, 1u);
+        atomic_fetch_add_explicit(&log->retired, 1u, memory_order_relaxed);
+        ++n;
+    }
+    return n;
+}
+
+static void _reclaim(uuid7_log_t* log)
+{
+    if(!log->deferred) return;
+    for(uint32_t i = 0; i < LOG_STRIPES; ++i)
+    {
+        if(atomic_load(&log->stripes[i].active) != 0u) return;
+    }
+    while(log->deferred)
+    {
+        log_seg_t* seg = log->deferred;
+        log->deferred = seg->next;
+        _seg_free(log, seg);
+    }
+    atomic_store(&log->deferred_n, 0u);
+}
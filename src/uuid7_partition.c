@@ -0,0 +1,629 @@
+/**
+ * @file uuid7_partition.c
+ * @brief Time-bucket partitioner for UUIDv7-keyed record streams.
+ *
+ * Each input block is processed in two phases:
+ *
+ * - Parse (parallel): the block is cut at record boundaries into one chunk
+ *   per worker. Workers locate every record and compute its bucket
+ *   (`ms / bucket_ms`) from the embedded timestamp only, producing a compact
+ *   (offset, length, bucket) list per chunk.
+ * - Route (sequential): the lists are walked in chunk order and each record is
+ *   copied into the write buffer of its bucket. This is a plain memcpy loop
+ *   and keeps per-bucket output in input order.
+ *
+ * Writers: a bucket owns a write buffer only while its file is open. Open
+ * writers live in a fixed pool of `max_open_files` slots found through an
+ * open-addressing map (bucket -> slot) and ordered by an intrusive LRU list.
+ * When the pool is full the least recently used writer is flushed, closed and
+ * reused, so both open descriptors and buffered memory stay bounded
+ * (`max_open_files * buffer_size`). Sorted or nearly sorted input hits the
+ * one-entry "last bucket" cache for almost every record.
+ *
+ * @author: Roman Horshkov <roman.horshkov@gmail.com>
+ * @date:   2025
+ */
+#ifndef _GNU_SOURCE
+#    define _GNU_SOURCE
+#endif
+
+#include "uuid7_partition.h"
+#include "uuid7.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/****************************************************************************
+ * PRIVATE DEFINES
+ ****************************************************************************
+ */
+
+#define PART_DEFAULT_MAX_OPEN  64u
+#define PART_DEFAULT_BUF       (1u << 20)
+#define PART_MAX_THREADS       64u
+#define PART_MIN_CHUNK         (1u << 20) /* below this, one thread is faster */
+#define PART_UUID_BYTES        16u
+#define PART_INVALID_BUCKET    UINT64_MAX
+#define PART_NONE              UINT32_MAX
+#define PART_NAME_MAX          4096u
+#define PART_RECS_INITIAL      4096u
+
+/****************************************************************************
+ * PRIVATE STUCTURED VARIABLES
+ ****************************************************************************
+ */
+
+/* One parsed record of a chunk */
+typedef struct part_rec
+{
+    size_t off;
+    size_t len;
+    uint64_t bucket;
+} part_rec_t;
+
+/* Parse job for one chunk of a block */
+typedef struct part_chunk
+{
+    const uuid7_part_t* p;
+    const uint8_t* base;
+    size_t begin;
+    size_t end;
+    part_rec_t* recs;
+    size_t nrecs;
+    size_t cap;
+    int err;
+} part_chunk_t;
+
+/* Open bucket writer */
+typedef struct part_slot
+{
+    uint64_t bucket;
+    int fd;
+    uint8_t* buf;
+    size_t len;
+    uint32_t prev; /* LRU neighbours, PART_NONE-terminated */
+    uint32_t next;
+} part_slot_t;
+
+struct uuid7_part
+{
+    uuid7_part_config_t cfg;
+    part_slot_t* slots;
+    uint32_t nslots;   /* slots in use */
+    uint32_t* map;     /* open addressing: slot index or PART_NONE */
+    size_t map_mask;
+    uint32_t lru_head; /* most recently used */
+    uint32_t lru_tail; /* eviction candidate */
+    uint32_t last;     /* one-entry lookup cache */
+    uuid7_part_stats_t stats;
+};
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS PROTOTYPES
+ ****************************************************************************
+ */
+
+/**
+ * @brief Parse worker: fill the record list of one chunk.
+ * @param arg  part_chunk_t*.
+ * @return NULL.
+ */
+static void* _parse_chunk(void* arg);
+
+/**
+ * @brief Bucket of a binary ID, or `PART_INVALID_BUCKET` unless it carries
+ * the v7 version and variant bits.
+ */
+static uint64_t _id_bucket(const uint8_t* id, uint64_t bucket_ms);
+
+/**
+ * @brief Find or open the writer of @p bucket, evicting the LRU if needed.
+ * @return Slot index, or PART_NONE on error.
+ */
+static uint32_t _slot_get(uuid7_part_t* p, uint64_t bucket);
+
+/**
+ * @brief Write the buffered bytes of a slot to its file.
+ * @return 0 on success, -1 on error.
+ */
+static int _slot_flush(uuid7_part_t* p, part_slot_t* s);
+
+/**
+ * @brief Append one record (plus an optional newline) to its bucket.
+ * @return 0 on success, -1 on error.
+ */
+static int _route(uuid7_part_t* p, uint64_t bucket, const uint8_t* rec, size_t len, bool add_nl);
+
+/**
+ * @brief write(2) the whole buffer, retrying on EINTR and short writes.
+ * @return 0 on success, -1 on error.
+ */
+static int _write_all(int fd, const uint8_t* buf, size_t len);
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+void uuid7_part_config_init(uuid7_part_config_t* cfg)
+{
+    if(!cfg) return;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->bucket_ms = UUID7_PART_HOUR_MS;
+    cfg->format = UUID7_PART_TEXT;
+    cfg->delimiter = ',';
+    cfg->max_open_files = PART_DEFAULT_MAX_OPEN;
+    cfg->buffer_size = PART_DEFAULT_BUF;
+}
+
+uuid7_part_t* uuid7_part_create(const uuid7_part_config_t* cfg)
+{
+    if(!cfg || !cfg->out_dir || cfg->bucket_ms == 0 || cfg->max_open_files == 0 ||
+       cfg->max_open_files >= PART_NONE / 2u || cfg->buffer_size == 0)
+    {
+        return NULL;
+    }
+    if(cfg->format == UUID7_PART_BINARY &&
+       (cfg->record_size < PART_UUID_BYTES || cfg->id_offset > cfg->record_size - PART_UUID_BYTES))
+    {
+        return NULL;
+    }
+
+    uuid7_part_t* p = calloc(1, sizeof(*p));
+    if(!p) return NULL;
+    p->cfg = *cfg;
+    if(p->cfg.threads == 0)
+    {
+        long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        p->cfg.threads = (ncpu > 0) ? (unsigned)ncpu : 1u;
+    }
+    if(p->cfg.threads > PART_MAX_THREADS) p->cfg.threads = PART_MAX_THREADS;
+
+    size_t map_cap = 1;
+    while(map_cap < 2u * cfg->max_open_files) map_cap <<= 1;
+
+    p->slots = calloc(cfg->max_open_files, sizeof(*p->slots));
+    p->map = malloc(map_cap * sizeof(*p->map));
+    if(!p->slots || !p->map)
+    {
+        free(p->slots);
+        free(p->map);
+        free(p);
+        return NULL;
+    }
+    for(size_t i = 0; i < map_cap; ++i) p->map[i] = PART_NONE;
+    p->map_mask = map_cap - 1u;
+    p->lru_head = PART_NONE;
+    p->lru_tail = PART_NONE;
+    p->last = PART_NONE;
+    return p;
+}
+
+int uuid7_part_write(uuid7_part_t* p, const void* data, size_t len, int last, size_t* consumed)
+{
+    if(consumed) *consumed = 0;
+    if(!p || (!data && len))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    const uint8_t* base = (const uint8_t*)data;
+    const bool text = p->cfg.format == UUID7_PART_TEXT;
+
+    /* Whole records only; the final block may end in a partial record */
+    size_t whole;
+    if(text)
+    {
+        const uint8_t* nl = len ? memrchr(base, '\n', len) : NULL;
+        whole = nl ? (size_t)(nl - base) + 1u : 0u;
+        if(last) whole = len;
+    }
+    else
+    {
+        whole = len - (len % p->cfg.record_size);
+    }
+
+    unsigned nthreads = p->cfg.threads;
+    if(whole / PART_MIN_CHUNK < nthreads) nthreads = (unsigned)(whole / PART_MIN_CHUNK);
+    if(nthreads == 0) nthreads = 1;
+
+    part_chunk_t chunks[PART_MAX_THREADS];
+    pthread_t tids[PART_MAX_THREADS];
+    bool started[PART_MAX_THREADS];
+
+    size_t start = 0;
+    for(unsigned t = 0; t < nthreads; ++t)
+    {
+        size_t end = (t + 1u == nthreads) ? whole : (whole / nthreads) * (t + 1u);
+        if(end < start) end = start;
+        if(end < whole)
+        {
+            if(text)
+            {
+                const uint8_t* nl = memchr(base + end, '\n', whole - end);
+                end = nl ? (size_t)(nl - base) + 1u : whole;
+            }
+            else
+            {
+                end -= end % p->cfg.record_size;
+            }
+        }
+        chunks[t] = (part_chunk_t){.p = p, .base = base, .begin = start, .end = end};
+        start = end;
+    }
+
+    for(unsigned t = 1; t < nthreads; ++t)
+    {
+        started[t] = pthread_create(&tids[t], NULL, _parse_chunk, &chunks[t]) == 0;
+        if(!started[t]) _parse_chunk(&chunks[t]);
+    }
+    _parse_chunk(&chunks[0]);
+    for(unsigned t = 1; t < nthreads; ++t)
+    {
+        if(started[t]) pthread_join(tids[t], NULL);
+    }
+
+    int rc = 0;
+    for(unsigned t = 0; t < nthreads; ++t)
+    {
+        if(chunks[t].err) rc = -1;
+        for(size_t i = 0; rc == 0 && i < chunks[t].nrecs; ++i)
+        {
+            const part_rec_t* r = &chunks[t].recs[i];
+            const bool add_nl = text && (r->len == 0 || base[r->off + r->len - 1u] != '\n');
+            rc = _route(p, r->bucket, base + r->off, r->len, add_nl);
+        }
+        free(chunks[t].recs);
+    }
+    if(rc != 0) return -1;
+
+    if(!text && last && whole < len)
+    {
+        /* A truncated trailing record cannot be routed by its ID */
+        if(_route(p, PART_INVALID_BUCKET, base + whole, len - whole, false) != 0) return -1;
+        whole = len;
+    }
+
+    if(consumed) *consumed = whole;
+    return 0;
+}
+
+int uuid7_part_flush(uuid7_part_t* p)
+{
+    if(!p)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    int rc = 0;
+    for(uint32_t i = 0; i < p->nslots; ++i)
+    {
+        if(_slot_flush(p, &p->slots[i]) != 0) rc = -1;
+    }
+    return rc;
+}
+
+int uuid7_part_get_stats(const uuid7_part_t* p, uuid7_part_stats_t* stats)
+{
+    if(!p || !stats) return -1;
+    *stats = p->stats;
+    return 0;
+}
+
+int uuid7_part_close(uuid7_part_t* p)
+{
+    if(!p) return 0;
+    int rc = uuid7_part_flush(p);
+    for(uint32_t i = 0; i < p->nslots; ++i)
+    {
+        if(close(p->slots[i].fd) != 0) rc = -1;
+        free(p->slots[i].buf);
+    }
+    free(p->slots);
+    free(p->map);
+    free(p);
+    return rc;
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static inline size_t _hash_bucket(uint64_t bucket)
+{
+    /* Fibonacci hashing: consecutive buckets spread over the table */
+    return (size_t)((bucket * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+static bool _push_rec(part_chunk_t* c, size_t off, size_t len, uint64_t bucket)
+{
+    if(c->nrecs == c->cap)
+    {
+        size_t cap = c->cap ? c->cap * 2u : PART_RECS_INITIAL;
+        part_rec_t* nr = realloc(c->recs, cap * sizeof(*nr));
+        if(!nr) return false;
+        c->recs = nr;
+        c->cap = cap;
+    }
+    c->recs[c->nrecs++] = (part_rec_t){.off = off, .len = len, .bucket = bucket};
+    return true;
+}
+
+static uint64_t _id_bucket(const uint8_t* id, uint64_t bucket_ms)
+{
+    /* A v4 or garbage ID would decode to a random bucket, often far away */
+    if((id[6] >> 4) != 7u || (id[8] & 0xC0u) != 0x80u) return PART_INVALID_BUCKET;
+    uint64_t ms = 0;
+    (void)uuid7_get_ms(id, &ms);
+    return ms / bucket_ms;
+}
+
+static void* _parse_chunk(void* arg)
+{
+    part_chunk_t* c = (part_chunk_t*)arg;
+    const uuid7_part_config_t* cfg = &c->p->cfg;
+    const uint8_t* base = c->base;
+
+    if(cfg->format == UUID7_PART_BINARY)
+    {
+        const size_t n = (c->end - c->begin) / cfg->record_size;
+        c->recs = malloc((n ? n : 1u) * sizeof(*c->recs));
+        if(!c->recs)
+        {
+            c->err = ENOMEM;
+            return NULL;
+        }
+        c->cap = n;
+        for(size_t off = c->begin; off < c->end; off += cfg->record_size)
+        {
+            const uint64_t bucket = _id_bucket(base + off + cfg->id_offset, cfg->bucket_ms);
+            c->recs[c->nrecs++] = (part_rec_t){.off = off, .len = cfg->record_size, .bucket = bucket};
+        }
+        return NULL;
+    }
+
+    size_t off = c->begin;
+    while(off < c->end)
+    {
+        const uint8_t* nl = memchr(base + off, '\n', c->end - off);
+        const size_t line_end = nl ? (size_t)(nl - base) : c->end;
+
+        /* Skip to the configured column */
+        size_t f = off;
+        for(unsigned col = 0; col < cfg->id_column && f < line_end; ++col)
+        {
+            const uint8_t* d = memchr(base + f, (unsigned char)cfg->delimiter, line_end - f);
+            f = d ? (size_t)(d - base) + 1u : line_end;
+        }
+
+        /* The whole 36-char canonical ID must lie inside the line */
+        uint64_t bucket = PART_INVALID_BUCKET;
+        uint8_t id[16];
+        if(line_end - f >= 36u && uuid7_from_str((const char*)base + f, id) == 0)
+        {
+            bucket = _id_bucket(id, cfg->bucket_ms);
+        }
+
+        const size_t rec_end = nl ? line_end + 1u : line_end;
+        if(!_push_rec(c, off, rec_end - off, bucket))
+        {
+            c->err = ENOMEM;
+            return NULL;
+        }
+        off = rec_end;
+    }
+    return NULL;
+}
+
+static void _lru_unlink(uuid7_part_t* p, uint32_t i)
+{
+    part_slot_t* s = &p->slots[i];
+    if(s->prev != PART_NONE) p->slots[s->prev].next = s->next;
+    else p->lru_head = s->next;
+    if(s->next != PART_NONE) p->slots[s->next].prev = s->prev;
+    else p->lru_tail = s->prev;
+}
+
+static void _lru_push_front(uuid7_part_t* p, uint32_t i)
+{
+    part_slot_t* s = &p->slots[i];
+    s->prev = PART_NONE;
+    s->next = p->lru_head;
+    if(p->lru_head != PART_NONE) p->slots[p->lru_head].prev = i;
+    p->lru_head = i;
+    if(p->lru_tail == PART_NONE) p->lru_tail = i;
+}
+
+/* Map position holding @p bucket, or the empty position where it belongs */
+static size_t _map_find(const uuid7_part_t* p, uint64_t bucket)
+{
+    size_t pos = _hash_bucket(bucket) & p->map_mask;
+    while(p->map[pos] != PART_NONE && p->slots[p->map[pos]].bucket != bucket)
+    {
+        pos = (pos + 1u) & p->map_mask;
+    }
+    return pos;
+}
+
+/* Linear-probing erase with backward shift (no tombstones) */
+static void _map_erase(uuid7_part_t* p, size_t hole)
+{
+    size_t j = hole;
+    for(;;)
+    {
+        j = (j + 1u) & p->map_mask;
+        if(p->map[j] == PART_NONE) break;
+        const size_t home = _hash_bucket(p->slots[p->map[j]].bucket) & p->map_mask;
+        /* Entry stays if its home lies cyclically in (hole, j] */
+        const bool stays = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+        if(stays) continue;
+        p->map[hole] = p->map[j];
+        hole = j;
+    }
+    p->map[hole] = PART_NONE;
+}
+
+static void _bucket_name(const uuid7_part_t* p, uint64_t bucket, char* out, size_t cap)
+{
+    const char* prefix = p->cfg.prefix ? p->cfg.prefix : "";
+    const char* suffix = p->cfg.suffix ? p->cfg.suffix : "";
+    if(bucket == PART_INVALID_BUCKET)
+    {
+        snprintf(out, cap, "%s/%sinvalid%s", p->cfg.out_dir, prefix, suffix);
+        return;
+    }
+
+    const uint64_t start_ms = bucket * p->cfg.bucket_ms;
+    const time_t secs = (time_t)(start_ms / 1000u);
+    struct tm tm;
+    gmtime_r(&secs, &tm);
+
+    const char* fmt = "%Y-%m-%dT%H%M%S";
+    if(p->cfg.bucket_ms % UUID7_PART_DAY_MS == 0) fmt = "%Y-%m-%d";
+    else if(p->cfg.bucket_ms % UUID7_PART_HOUR_MS == 0) fmt = "%Y-%m-%dT%H";
+    else if(p->cfg.bucket_ms % UUID7_PART_MINUTE_MS == 0) fmt = "%Y-%m-%dT%H%M";
+
+    char stamp[40];
+    size_t n = strftime(stamp, sizeof(stamp), fmt, &tm);
+    if(p->cfg.bucket_ms % 1000u != 0)
+    {
+        snprintf(stamp + n, sizeof(stamp) - n, ".%03u", (unsigned)(start_ms % 1000u));
+    }
+    snprintf(out, cap, "%s/%s%s%s", p->cfg.out_dir, prefix, stamp, suffix);
+}
+
+static uint32_t _slot_get(uuid7_part_t* p, uint64_t bucket)
+{
+    const size_t pos = _map_find(p, bucket);
+    if(p->map[pos] != PART_NONE)
+    {
+        const uint32_t i = p->map[pos];
+        _lru_unlink(p, i);
+        _lru_push_front(p, i);
+        return i;
+    }
+
+    uint32_t i;
+    if(p->nslots < p->cfg.max_open_files)
+    {
+        i = p->nslots;
+        p->slots[i].buf = malloc(p->cfg.buffer_size);
+        if(!p->slots[i].buf) return PART_NONE;
+        p->slots[i].len = 0;
+        p->nslots++;
+    }
+    else
+    {
+        /* Evict the least recently used writer */
+        i = p->lru_tail;
+        part_slot_t* victim = &p->slots[i];
+        if(_slot_flush(p, victim) != 0) return PART_NONE;
+        if(close(victim->fd) != 0) return PART_NONE;
+        _lru_unlink(p, i);
+        _map_erase(p, _map_find(p, victim->bucket));
+        p->stats.evictions++;
+    }
+
+    char path[PART_NAME_MAX];
+    _bucket_name(p, bucket, path, sizeof(path));
+    const int fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if(fd < 0)
+    {
+        /* Keep the slot reusable: it is simply not mapped nor in the LRU */
+        const int saved = errno;
+        p->nslots--;
+        if(i != p->nslots)
+        {
+            /* Move the last slot into the hole so slots stay dense */
+            const uint32_t last = p->nslots;
+            uint8_t* buf = p->slots[i].buf;
+            p->slots[i] = p->slots[last];
+            p->slots[last].buf = buf;
+            if(p->slots[i].prev != PART_NONE) p->slots[p->slots[i].prev].next = i;
+            else p->lru_head = i;
+            if(p->slots[i].next != PART_NONE) p->slots[p->slots[i].next].prev = i;
+            else p->lru_tail = i;
+            p->map[_map_find(p, p->slots[i].bucket)] = i;
+        }
+        p->last = PART_NONE;
+        free(p->slots[p->nslots].buf);
+        p->slots[p->nslots].buf = NULL;
+        errno = saved;
+        return PART_NONE;
+    }
+
+    p->slots[i].bucket = bucket;
+    p->slots[i].fd = fd;
+    p->slots[i].len = 0;
+    p->map[_map_find(p, bucket)] = i;
+    _lru_push_front(p, i);
+    p->stats.files_opened++;
+    return i;
+}
+
+static int _write_all(int fd, const uint8_t* buf, size_t len)
+{
+    while(len)
+    {
+        const ssize_t r = write(fd, buf, len);
+        if(r < 0)
+        {
+            if(errno == EINTR) continue;
+            return -1;
+        }
+        buf += r;
+        len -= (size_t)r;
+    }
+    return 0;
+}
+
+static int _slot_flush(uuid7_part_t* p, part_slot_t* s)
+{
+    if(s->len == 0) return 0;
+    if(_write_all(s->fd, s->buf, s->len) != 0) return -1;
+    p->stats.bytes_written += s->len;
+    s->len = 0;
+    return 0;
+}
+
+static int _route(uuid7_part_t* p, uint64_t bucket, const uint8_t* rec, size_t len, bool add_nl)
+{
+    uint32_t i = p->last;
+    if(i == PART_NONE || p->slots[i].bucket != bucket)
+    {
+        i = _slot_get(p, bucket);
+        if(i == PART_NONE) return -1;
+        p->last = i;
+    }
+    part_slot_t* s = &p->slots[i];
+
+    const size_t need = len + (add_nl ? 1u : 0u);
+    if(s->len + need > p->cfg.buffer_size && _slot_flush(p, s) != 0) return -1;
+
+    if(need > p->cfg.buffer_size)
+    {
+        /* Oversized record: bypass the buffer */
+        if(_write_all(s->fd, rec, len) != 0) return -1;
+        if(add_nl && _write_all(s->fd, (const uint8_t*)"\n", 1u) != 0) return -1;
+        p->stats.bytes_written += need;
+    }
+    else
+    {
+        memcpy(s->buf + s->len, rec, len);
+        s->len += len;
+        if(add_nl) s->buf[s->len++] = '\n';
+    }
+
+    if(bucket == PART_INVALID_BUCKET) p->stats.rejected++;
+    else p->stats.records++;
+    return 0;
+}
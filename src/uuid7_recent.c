@@ -0,0 +1,320 @@
+/**
+ * @file uuid7_recent.c
+ * @brief Direct-mapped table of recently issued UUIDv7 values.
+ *
+ * Set of an ID: `(ms & (window_ms - 1)) * seq_sets + (seq & (seq_sets - 1))`.
+ * Within a ms the generator's sequence starts at a random value and then
+ * either jumps to a larger random value or increments, so sequence bits
+ * spread evenly but may collide; the second way of each set absorbs most of
+ * that. When both ways are live, the older ID (smaller key, i.e. an earlier
+ * lap of the ring or an earlier sequence) is displaced. Each slot stores
+ * the full ID, so a stale or foreign occupant is never mistaken for a hit.
+ *
+ * Slots are 32 bytes and a set is one aligned 64-byte line, so a lookup
+ * touches one cache line. Each slot is guarded by its own sequence lock:
+ * writers make the version odd with one CAS, store, and make it even again;
+ * readers retry if the version was odd or changed under them. Lookups never
+ * write shared memory on a hit.
+ *
+ * @author: Roman Horshkov <roman.horshkov@gmail.com>
+ * @date:   2025
+ */
+
+#include "uuid7_recent.h"
+#include "uuid7.h"
+#include "uuid7_internal.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/****************************************************************************
+ * PRIVATE DEFINES
+ ****************************************************************************
+ */
+
+#define RECENT_DEFAULT_WINDOW_MS 2048u
+#define RECENT_DEFAULT_SEQ_SETS  32u
+#define RECENT_MAX_SEQ_SETS      4096u
+#define RECENT_WAYS              2u
+#define RECENT_MAX_SLOTS         ((uint64_t)1 << 28)
+#define RECENT_CACHE_LINE        64u
+#define RECENT_READ_RETRIES      16u
+
+/****************************************************************************
+ * PRIVATE STUCTURED VARIABLES
+ ****************************************************************************
+ */
+
+/* One slot, guarded by `ver` (odd while a writer is inside). The payload is
+ * atomic too, so torn reads are detected rather than undefined. */
+typedef struct recent_slot
+{
+    _Atomic uint64_t ver;
+    _Atomic uint64_t hi;
+    _Atomic uint64_t lo;
+    _Atomic uintptr_t obj; /* 0: empty */
+} recent_slot_t;
+
+/* One cache line: the ways an ID may occupy */
+typedef struct recent_set
+{
+    _Alignas(RECENT_CACHE_LINE) recent_slot_t way[RECENT_WAYS];
+} recent_set_t;
+
+struct uuid7_recent
+{
+    uuid7_recent_config_t cfg;
+    recent_set_t* sets;
+    uint32_t ms_mask;
+    uint32_t seq_mask;
+    uint32_t seq_shift; /* log2(seq_sets) */
+    _Atomic uint64_t evictions;
+    _Atomic uint64_t misses;
+};
+
+/****************************************************************************
+ * PRIVATE VARIABLES
+ ****************************************************************************
+ */
+/* None */
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS PROTOTYPES
+ ****************************************************************************
+ */
+
+/**
+ * @brief Set of an ID, from the ms and sequence in its first 8 bytes.
+ */
+static inline recent_set_t* _set_of(const uuid7_recent_t* r, uint64_t hi);
+
+/**
+ * @brief Consistent snapshot of a slot.
+ * @return true with the fields filled, false if writers kept it busy.
+ */
+static bool _read_slot(recent_slot_t* s, uint64_t* hi, uint64_t* lo, uintptr_t* obj);
+
+/**
+ * @brief Enter a slot as its writer.
+ * @return Version to publish (even) when leaving.
+ */
+static uint64_t _write_lock(recent_slot_t* s);
+
+/**
+ * @brief Record a miss and run the slow path.
+ */
+static void* _miss(uuid7_recent_t* r, const uint8_t* id);
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+void uuid7_recent_config_init(uuid7_recent_config_t* cfg)
+{
+    if(!cfg) return;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->window_ms = RECENT_DEFAULT_WINDOW_MS;
+    cfg->seq_sets = RECENT_DEFAULT_SEQ_SETS;
+}
+
+uuid7_recent_t* uuid7_recent_create(const uuid7_recent_config_t* cfg)
+{
+    if(!cfg || cfg->window_ms == 0u || (cfg->window_ms & (cfg->window_ms - 1u)) != 0u || cfg->seq_sets == 0u ||
+       (cfg->seq_sets & (cfg->seq_sets - 1u)) != 0u || cfg->seq_sets > RECENT_MAX_SEQ_SETS ||
+       (uint64_t)cfg->window_ms * cfg->seq_sets > RECENT_MAX_SLOTS / RECENT_WAYS)
+    {
+        return NULL;
+    }
+
+    uuid7_recent_t* r = calloc(1, sizeof(*r));
+    if(!r) return NULL;
+    const size_t bytes = (size_t)cfg->window_ms * cfg->seq_sets * sizeof(recent_set_t);
+    r->sets = aligned_alloc(RECENT_CACHE_LINE, bytes);
+    if(!r->sets)
+    {
+        free(r);
+        return NULL;
+    }
+    memset(r->sets, 0, bytes);
+    r->cfg = *cfg;
+    r->ms_mask = cfg->window_ms - 1u;
+    r->seq_mask = cfg->seq_sets - 1u;
+    r->seq_shift = (uint32_t)__builtin_ctz(cfg->seq_sets);
+    return r;
+}
+
+void uuid7_recent_destroy(uuid7_recent_t* r)
+{
+    if(!r) return;
+    free(r->sets);
+    free(r);
+}
+
+int uuid7_recent_gen(uuid7_recent_t* r, uint8_t* id, void* obj)
+{
+    if(!r || !id || !obj) return -1;
+    if(uuid7_gen(id) != 0) return -1;
+    return uuid7_recent_insert(r, id, obj);
+}
+
+int uuid7_recent_insert(uuid7_recent_t* r, const uint8_t* id, void* obj)
+{
+    if(!r || !id || !obj) return -1;
+
+    const uint64_t hi = _load_be64(id);
+    const uint64_t lo = _load_be64(id + 8);
+    recent_set_t* set = _set_of(r, hi);
+
+    /* Pick a way without locking: the same ID, else a free way, else the
+     * older occupant. A racing writer may win it; either result is valid. */
+    recent_slot_t* s = &set->way[0];
+    uint64_t victim_hi = UINT64_MAX;
+    for(uint32_t w = 0; w < RECENT_WAYS; ++w)
+    {
+        const uint64_t whi = atomic_load_explicit(&set->way[w].hi, memory_order_relaxed);
+        const uint64_t wlo = atomic_load_explicit(&set->way[w].lo, memory_order_relaxed);
+        const uintptr_t wobj = atomic_load_explicit(&set->way[w].obj, memory_order_relaxed);
+        if(wobj != 0u && whi == hi && wlo == lo)
+        {
+            s = &set->way[w];
+            break;
+        }
+        const uint64_t age = wobj ? whi : 0u;
+        if(age < victim_hi)
+        {
+            victim_hi = age;
+            s = &set->way[w];
+        }
+    }
+
+    const uint64_t ver = _write_lock(s);
+    if(atomic_load_explicit(&s->obj, memory_order_relaxed) != 0u &&
+       (atomic_load_explicit(&s->hi, memory_order_relaxed) != hi ||
+        atomic_load_explicit(&s->lo, memory_order_relaxed) != lo))
+    {
+        atomic_fetch_add_explicit(&r->evictions, 1u, memory_order_relaxed);
+    }
+    atomic_store_explicit(&s->hi, hi, memory_order_relaxed);
+    atomic_store_explicit(&s->lo, lo, memory_order_relaxed);
+    atomic_store_explicit(&s->obj, (uintptr_t)obj, memory_order_relaxed);
+    atomic_store_explicit(&s->ver, ver, memory_order_release);
+    return 0;
+}
+
+void* uuid7_recent_get(uuid7_recent_t* r, const uint8_t* id)
+{
+    if(!r || !id) return NULL;
+
+    const uint64_t hi = _load_be64(id);
+    const uint64_t lo = _load_be64(id + 8);
+    recent_set_t* set = _set_of(r, hi);
+    for(uint32_t w = 0; w < RECENT_WAYS; ++w)
+    {
+        uint64_t shi, slo;
+        uintptr_t obj;
+        if(_read_slot(&set->way[w], &shi, &slo, &obj) && obj != 0u && shi == hi && slo == lo)
+        {
+            return (void*)obj;
+        }
+    }
+    return _miss(r, id);
+}
+
+int uuid7_recent_remove(uuid7_recent_t* r, const uint8_t* id)
+{
+    if(!r || !id) return -1;
+
+    const uint64_t hi = _load_be64(id);
+    const uint64_t lo = _load_be64(id + 8);
+    recent_set_t* set = _set_of(r, hi);
+    for(uint32_t w = 0; w < RECENT_WAYS; ++w)
+    {
+        recent_slot_t* s = &set->way[w];
+        if(atomic_load_explicit(&s->hi, memory_order_relaxed) != hi) continue;
+
+        const uint64_t ver = _write_lock(s);
+        int rc = -1;
+        if(atomic_load_explicit(&s->obj, memory_order_relaxed) != 0u &&
+           atomic_load_explicit(&s->hi, memory_order_relaxed) == hi &&
+           atomic_load_explicit(&s->lo, memory_order_relaxed) == lo)
+        {
+            atomic_store_explicit(&s->obj, 0u, memory_order_relaxed);
+            rc = 0;
+        }
+        atomic_store_explicit(&s->ver, ver, memory_order_release);
+        if(rc == 0) return 0;
+    }
+    return -1;
+}
+
+int uuid7_recent_get_stats(const uuid7_recent_t* r, uuid7_recent_stats_t* stats)
+{
+    if(!r || !stats) return -1;
+    stats->slots = (uint64_t)r->cfg.window_ms * r->cfg.seq_sets * RECENT_WAYS;
+    stats->evictions = atomic_load_explicit(&r->evictions, memory_order_relaxed);
+    stats->misses = atomic_load_explicit(&r->misses, memory_order_relaxed);
+    return 0;
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static inline recent_set_t* _set_of(const uuid7_recent_t* r, uint64_t hi)
+{
+    /* hi = ms(48) | version(4) | seq(12) */
+    const uint64_t ms = hi >> 16;
+    const uint64_t seq = hi & 0x0FFFu;
+    return &r->sets[((ms & r->ms_mask) << r->seq_shift) | (seq & r->seq_mask)];
+}
+
+static bool _read_slot(recent_slot_t* s, uint64_t* hi, uint64_t* lo, uintptr_t* obj)
+{
+    for(uint32_t attempt = 0; attempt < RECENT_READ_RETRIES; ++attempt)
+    {
+        const uint64_t v1 = atomic_load_explicit(&s->ver, memory_order_acquire);
+        if(v1 & 1u)
+        {
+            _cpu_relax();
+            continue;
+        }
+        *hi = atomic_load_explicit(&s->hi, memory_order_relaxed);
+        *lo = atomic_load_explicit(&s->lo, memory_order_relaxed);
+        *obj = atomic_load_explicit(&s->obj, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if(atomic_load_explicit(&s->ver, memory_order_relaxed) == v1) return true;
+    }
+    return false;
+}
+
+static uint64_t _write_lock(recent_slot_t* s)
+{
+    uint64_t ver = atomic_load_explicit(&s->ver, memory_order_relaxed);
+    for(;;)
+    {
+        if(ver & 1u)
+        {
+            _cpu_relax();
+            ver = atomic_load_explicit(&s->ver, memory_order_relaxed);
+            continue;
+        }
+        if(atomic_compare_exchange_weak_explicit(&s->ver, &ver, ver + 1u, memory_order_acquire,
+                                                 memory_order_relaxed))
+        {
+            /* Standard seqlock writer: the odd version must be visible
+             * before any of the data stores that follow */
+            atomic_thread_fence(memory_order_release);
+            return ver + 2u;
+        }
+    }
+}
+
+static void* _miss(uuid7_recent_t* r, const uint8_t* id)
+{
+    atomic_fetch_add_explicit(&r->misses, 1u, memory_order_relaxed);
+    return r->cfg.miss_fn ? r->cfg.miss_fn(id, r->cfg.miss_ctx) : NULL;
+}
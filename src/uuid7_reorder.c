@@ -0,0 +1,287 @@
+/**
+ * @file uuid7_reorder.c
+ * @brief Bounded-skew reorder buffer over UUIDv7 event IDs.
+ *
+ * Two stages:
+ *
+ * - Ingress (producers): a bounded MPMC ring in the style of D. Vyukov's
+ *   queue. Each cell carries a sequence number; a producer claims a position
+ *   with one CAS on the enqueue counter, fills the cell and publishes it by
+ *   storing `pos + 1` into its sequence. No locks, and producers never touch
+ *   the ordering structure. The enqueue counter doubles as the `pushed`
+ *   statistic.
+ * - Ordering (consumer): drain moves every published cell into a private
+ *   radix heap (uuid7_rheap), then pops while the minimum is at or below the
+ *   watermark. Arrivals are nearly sorted, which is the radix heap's best
+ *   case, so this replaces a global sort stage at amortized O(1) per event.
+ *
+ * Lateness is decided at ingest: an event smaller than the last ID already
+ * emitted can no longer be delivered in order. Everything else is in the
+ * heap before anything larger leaves it, so the output is in strict ID order
+ * apart from the late events, which are counted and either dropped or sent
+ * out ahead of the rest (the heap pops keys below its last pop first).
+ *
+ * @author: Roman Horshkov <roman.horshkov@gmail.com>
+ * @date:   2025
+ */
+
+#include "uuid7_reorder.h"
+#include "uuid7_rheap.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/****************************************************************************
+ * PRIVATE DEFINES
+ ****************************************************************************
+ */
+
+#define REORDER_DEFAULT_SKEW_MS 50u
+#define REORDER_DEFAULT_CAP     65536u
+#define REORDER_MAX_CAP         ((size_t)1 << 30)
+#define REORDER_UUID_BYTES      16u
+#define REORDER_CACHE_LINE      64u
+
+/****************************************************************************
+ * PRIVATE STUCTURED VARIABLES
+ ****************************************************************************
+ */
+
+/* Ingress cell: `seq == pos` free for the producer of pos, `pos + 1` full */
+typedef struct reorder_cell
+{
+    _Atomic size_t seq;
+    uint8_t id[REORDER_UUID_BYTES];
+    void* value;
+} reorder_cell_t;
+
+struct uuid7_reorder
+{
+    uuid7_reorder_config_t cfg;
+    reorder_cell_t* ring;
+    size_t mask;
+
+    /* Producer side, on its own line */
+    _Alignas(REORDER_CACHE_LINE) _Atomic size_t enq;
+    _Atomic uint64_t rejected;
+
+    /* Consumer side */
+    _Alignas(REORDER_CACHE_LINE) size_t deq;
+    uuid7_rheap_t* heap;
+    uint64_t max_ms;
+    uint64_t watermark_ms;
+    uint8_t last[REORDER_UUID_BYTES];
+    bool emitted_any;
+    uint64_t emitted;
+    uint64_t late;
+    uint64_t dropped;
+};
+
+/****************************************************************************
+ * PRIVATE VARIABLES
+ ****************************************************************************
+ */
+/* None */
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS PROTOTYPES
+ ****************************************************************************
+ */
+
+/**
+ * @brief Embedded Unix ms of a UUIDv7 (bytes 0..5, big-endian).
+ */
+static inline uint64_t _id_ms(const uint8_t* id);
+
+/**
+ * @brief Move every published ingress cell into the heap, classifying late
+ * arrivals. Stops early (leaving the cell in place) if the heap cannot grow.
+ */
+static void _ingest(uuid7_reorder_t* r);
+
+/**
+ * @brief Pop up to @p max events whose ms is <= @p wm, late ones included.
+ * @return Number of events written.
+ */
+static size_t _emit(uuid7_reorder_t* r, uint64_t wm, uint8_t* ids, void** values, size_t max);
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+void uuid7_reorder_config_init(uuid7_reorder_config_t* cfg)
+{
+    if(!cfg) return;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->skew_ms = REORDER_DEFAULT_SKEW_MS;
+    cfg->capacity = REORDER_DEFAULT_CAP;
+}
+
+uuid7_reorder_t* uuid7_reorder_create(const uuid7_reorder_config_t* cfg)
+{
+    if(!cfg || cfg->capacity < 2u || cfg->capacity > REORDER_MAX_CAP) return NULL;
+
+    size_t cap = 2u;
+    while(cap < cfg->capacity) cap <<= 1;
+
+    uuid7_reorder_t* r = aligned_alloc(REORDER_CACHE_LINE, sizeof(*r));
+    if(!r) return NULL;
+    memset(r, 0, sizeof(*r));
+    r->cfg = *cfg;
+    r->cfg.capacity = cap;
+    r->mask = cap - 1u;
+    r->ring = malloc(cap * sizeof(*r->ring));
+    r->heap = uuid7_rheap_create();
+    if(!r->ring || !r->heap)
+    {
+        uuid7_reorder_destroy(r);
+        return NULL;
+    }
+    for(size_t i = 0; i < cap; ++i) atomic_init(&r->ring[i].seq, i);
+    atomic_init(&r->enq, 0u);
+    atomic_init(&r->rejected, 0u);
+    return r;
+}
+
+void uuid7_reorder_destroy(uuid7_reorder_t* r)
+{
+    if(!r) return;
+    uuid7_rheap_destroy(r->heap);
+    free(r->ring);
+    free(r);
+}
+
+int uuid7_reorder_push(uuid7_reorder_t* r, const uint8_t* id, void* value)
+{
+    if(!r || !id) return -1;
+
+    size_t pos = atomic_load_explicit(&r->enq, memory_order_relaxed);
+    reorder_cell_t* cell;
+    for(;;)
+    {
+        cell = &r->ring[pos & r->mask];
+        const size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if(diff == 0)
+        {
+            if(atomic_compare_exchange_weak_explicit(&r->enq, &pos, pos + 1u, memory_order_relaxed,
+                                                     memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if(diff < 0)
+        {
+            /* The consumer has not freed this cell yet: ring full */
+            atomic_fetch_add_explicit(&r->rejected, 1u, memory_order_relaxed);
+            return -1;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&r->enq, memory_order_relaxed);
+        }
+    }
+
+    memcpy(cell->id, id, REORDER_UUID_BYTES);
+    cell->value = value;
+    atomic_store_explicit(&cell->seq, pos + 1u, memory_order_release);
+    return 0;
+}
+
+size_t uuid7_reorder_drain(uuid7_reorder_t* r, uint64_t now_ms, uint8_t* ids, void** values, size_t max)
+{
+    if(!r || !ids) return 0;
+    _ingest(r);
+
+    const uint64_t now = now_ms ? now_ms : r->max_ms;
+    const uint64_t wm = now > r->cfg.skew_ms ? now - r->cfg.skew_ms : 0u;
+    if(wm > r->watermark_ms) r->watermark_ms = wm;
+    return _emit(r, r->watermark_ms, ids, values, max);
+}
+
+size_t uuid7_reorder_flush(uuid7_reorder_t* r, uint8_t* ids, void** values, size_t max)
+{
+    if(!r || !ids) return 0;
+    _ingest(r);
+    return _emit(r, UINT64_MAX, ids, values, max);
+}
+
+int uuid7_reorder_get_stats(const uuid7_reorder_t* r, uuid7_reorder_stats_t* stats)
+{
+    if(!r || !stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+    stats->pushed = atomic_load_explicit(&r->enq, memory_order_relaxed);
+    stats->rejected = atomic_load_explicit(&r->rejected, memory_order_relaxed);
+    stats->emitted = r->emitted;
+    stats->late = r->late;
+    stats->dropped = r->dropped;
+    /* Still in the ring, plus waiting in the heap */
+    stats->held = (uint64_t)(stats->pushed - r->deq) + uuid7_rheap_size(r->heap);
+    stats->watermark_ms = r->watermark_ms;
+    return 0;
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static inline uint64_t _id_ms(const uint8_t* id)
+{
+    uint64_t ms = 0;
+    for(int i = 0; i < 6; ++i) ms = (ms << 8) | id[i];
+    return ms;
+}
+
+static void _ingest(uuid7_reorder_t* r)
+{
+    for(;;)
+    {
+        reorder_cell_t* cell = &r->ring[r->deq & r->mask];
+        if(atomic_load_explicit(&cell->seq, memory_order_acquire) != r->deq + 1u) return;
+
+        const bool late = r->emitted_any && memcmp(cell->id, r->last, REORDER_UUID_BYTES) < 0;
+        if(late && r->cfg.drop_late)
+        {
+            r->dropped++;
+        }
+        else
+        {
+            if(uuid7_rheap_push(r->heap, cell->id, cell->value) != 0) return;
+            const uint64_t ms = _id_ms(cell->id);
+            if(ms > r->max_ms) r->max_ms = ms;
+        }
+        if(late) r->late++;
+
+        /* Hand the cell to the producer of the next lap */
+        atomic_store_explicit(&cell->seq, r->deq + r->mask + 1u, memory_order_release);
+        r->deq++;
+    }
+}
+
+static size_t _emit(uuid7_reorder_t* r, uint64_t wm, uint8_t* ids, void** values, size_t max)
+{
+    size_t n = 0;
+    uint8_t id[REORDER_UUID_BYTES];
+    void* value;
+    while(n < max && uuid7_rheap_peek(r->heap, id, &value) == 0)
+    {
+        const bool late = r->emitted_any && memcmp(id, r->last, REORDER_UUID_BYTES) < 0;
+        if(!late && _id_ms(id) > wm) break;
+
+        (void)uuid7_rheap_pop(r->heap, NULL, NULL);
+        memcpy(ids + n * REORDER_UUID_BYTES, id, REORDER_UUID_BYTES);
+        if(values) values[n] = value;
+        n++;
+        if(!late)
+        {
+            memcpy(r->last, id, REORDER_UUID_BYTES);
+            r->emitted_any = true;
+        }
+    }
+    r->emitted += n;
+    return n;
+}
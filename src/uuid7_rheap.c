@@ -0,0 +1,410 @@
+/**
+ * @file uuid7_rheap.c
+ * @brief Radix heap over 128-bit UUIDv7 keys.
+ *
+ * Two-level radix heap (Ahuja, Mehlhorn, Orlin, Tarjan) with byte digits
+ * over 128-bit keys:
+ *
+ * - `last` is the most recently popped key; every stored key is >= last.
+ * - A key equal to last lives in the "equal" bucket. Any other key is filed
+ *   under (p, d): p is the highest byte in which it differs from last, d is
+ *   its own value of that byte (d > last's byte p). That gives 16 x 256
+ *   buckets, and each key is still a few shifts and a clz away.
+ * - Pop takes from the equal bucket. When it is empty, the lowest occupied
+ *   (p, d) - found through a 16-bit position summary and 4-word digit
+ *   bitmaps - is scanned for its minimum, which becomes the new `last`; its
+ *   entries are redistributed to positions < p. A key therefore moves at
+ *   most once per byte position, and generator output, where the queue spans
+ *   a few ms, moves about three times: ms byte, sequence bytes, equal.
+ *   A bit-per-bucket radix heap would move it once per *bit*, which loses
+ *   to a binary heap at scheduler queue sizes.
+ * - Buckets are flat arrays of 24-byte entries, so scans and moves are
+ *   sequential memory traffic.
+ *
+ * Keys older than `last` (late arrivals) cannot enter the radix buckets.
+ * They go to a binary min-heap side queue. All of them are smaller than any
+ * bucket entry, so pop simply drains that queue first.
+ *
+ * @author: Roman Horshkov <roman.horshkov@gmail.com>
+ * @date:   2025
+ */
+
+#include "uuid7_rheap.h"
+#include "uuid7_internal.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/****************************************************************************
+ * PRIVATE DEFINES
+ ****************************************************************************
+ */
+
+#define RHEAP_POSITIONS   16u  /* key bytes, 0 = least significant */
+#define RHEAP_DIGITS      256u
+#define RHEAP_DIGIT_WORDS (RHEAP_DIGITS / 64u)
+#define RHEAP_BUCKETS     (RHEAP_POSITIONS * RHEAP_DIGITS)
+#define RHEAP_EQUAL       RHEAP_BUCKETS /* index of the equal-to-last bucket */
+#define RHEAP_MIN_CAP     16u
+#define RHEAP_UUID_BYTES  16u
+
+/****************************************************************************
+ * PRIVATE STUCTURED VARIABLES
+ ****************************************************************************
+ */
+
+/* Key as two big-endian halves, so integer order is memcmp() order */
+typedef struct rheap_entry
+{
+    uint64_t hi;
+    uint64_t lo;
+    void* value;
+} rheap_entry_t;
+
+/* Growable flat array; also used as the binary heap of late keys */
+typedef struct rheap_bucket
+{
+    rheap_entry_t* e;
+    size_t n;
+    size_t cap;
+    size_t need; /* scratch: entries about to be added by a bulk move */
+} rheap_bucket_t;
+
+struct uuid7_rheap
+{
+    uint64_t last_hi;
+    uint64_t last_lo;
+    size_t size;
+    uint32_t pos_occ;                                      /* bit p: some (p, d) non-empty */
+    uint64_t dig_occ[RHEAP_POSITIONS][RHEAP_DIGIT_WORDS]; /* bit d: (p, d) non-empty */
+    rheap_bucket_t late;
+    rheap_bucket_t b[RHEAP_BUCKETS + 1u]; /* (p, d) at p * 256 + d, then equal */
+};
+
+/****************************************************************************
+ * PRIVATE VARIABLES
+ ****************************************************************************
+ */
+/* None */
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS PROTOTYPES
+ ****************************************************************************
+ */
+
+/**
+ * @brief Bucket of a key relative to last: (highest differing byte, the
+ * key's digit there), or `RHEAP_EQUAL`.
+ */
+static inline unsigned _bucket_of(uint64_t hi, uint64_t lo, uint64_t last_hi, uint64_t last_lo);
+
+/**
+ * @brief Ensure room for @p extra more entries.
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int _reserve(rheap_bucket_t* b, size_t extra);
+
+/**
+ * @brief Reserve room for @p n entries headed to the buckets of @p keys
+ * relative to (last_hi, last_lo). Touches only the target buckets, and only
+ * their capacity, so a failure leaves the contents unchanged.
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int _reserve_targets(uuid7_rheap_t* h, const rheap_entry_t* keys, size_t n, uint64_t last_hi,
+                            uint64_t last_lo);
+
+/**
+ * @brief Append an entry to a radix bucket (capacity already reserved).
+ */
+static inline void _append(uuid7_rheap_t* h, unsigned bucket, const rheap_entry_t* e);
+
+/**
+ * @brief Insert into the late-key binary heap.
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int _late_push(uuid7_rheap_t* h, const rheap_entry_t* e);
+
+/**
+ * @brief Remove the minimum of the (non-empty) late-key binary heap.
+ */
+static rheap_entry_t _late_pop(uuid7_rheap_t* h);
+
+/**
+ * @brief Refill the equal bucket from the lowest non-empty (p, d) bucket.
+ * @return 0 on success, -1 on allocation failure (heap unchanged).
+ */
+static int _refill(uuid7_rheap_t* h);
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+uuid7_rheap_t* uuid7_rheap_create(void)
+{
+    return calloc(1, sizeof(uuid7_rheap_t));
+}
+
+void uuid7_rheap_destroy(uuid7_rheap_t* h)
+{
+    if(!h) return;
+    for(unsigned i = 0; i <= RHEAP_BUCKETS; ++i) free(h->b[i].e);
+    free(h->late.e);
+    free(h);
+}
+
+int uuid7_rheap_push(uuid7_rheap_t* h, const uint8_t* id, void* value)
+{
+    if(!h || !id) return -1;
+    const rheap_entry_t e = {_load_be64(id), _load_be64(id + 8), value};
+
+    if(_key_less(e.hi, e.lo, h->last_hi, h->last_lo))
+    {
+        if(_late_push(h, &e) != 0) return -1;
+    }
+    else
+    {
+        const unsigned bucket = _bucket_of(e.hi, e.lo, h->last_hi, h->last_lo);
+        if(_reserve(&h->b[bucket], 1u) != 0) return -1;
+        _append(h, bucket, &e);
+    }
+    h->size++;
+    return 0;
+}
+
+int uuid7_rheap_push_n(uuid7_rheap_t* h, const uint8_t* ids, void* const* values, size_t n)
+{
+    if(!h || (!ids && n)) return -1;
+
+    /* Reserve for the whole batch first, so a failure inserts nothing */
+    size_t late = 0;
+    int rc = 0;
+    for(size_t i = 0; i < n && rc == 0; ++i)
+    {
+        const uint64_t hi = _load_be64(ids + i * RHEAP_UUID_BYTES);
+        const uint64_t lo = _load_be64(ids + i * RHEAP_UUID_BYTES + 8);
+        if(_key_less(hi, lo, h->last_hi, h->last_lo))
+        {
+            late++;
+            continue;
+        }
+        rheap_bucket_t* b = &h->b[_bucket_of(hi, lo, h->last_hi, h->last_lo)];
+        rc = _reserve(b, ++b->need);
+    }
+    for(size_t i = 0; i < n; ++i)
+    {
+        const uint64_t hi = _load_be64(ids + i * RHEAP_UUID_BYTES);
+        const uint64_t lo = _load_be64(ids + i * RHEAP_UUID_BYTES + 8);
+        if(!_key_less(hi, lo, h->last_hi, h->last_lo)) h->b[_bucket_of(hi, lo, h->last_hi, h->last_lo)].need = 0;
+    }
+    if(rc != 0 || (late && _reserve(&h->late, late) != 0)) return -1;
+
+    for(size_t i = 0; i < n; ++i)
+    {
+        const rheap_entry_t e = {_load_be64(ids + i * RHEAP_UUID_BYTES),
+                                 _load_be64(ids + i * RHEAP_UUID_BYTES + 8), values ? values[i] : NULL};
+        if(_key_less(e.hi, e.lo, h->last_hi, h->last_lo)) (void)_late_push(h, &e);
+        else _append(h, _bucket_of(e.hi, e.lo, h->last_hi, h->last_lo), &e);
+    }
+    h->size += n;
+    return 0;
+}
+
+int uuid7_rheap_pop(uuid7_rheap_t* h, uint8_t* id, void** value)
+{
+    if(!h || h->size == 0) return -1;
+
+    rheap_entry_t e;
+    if(h->late.n)
+    {
+        e = _late_pop(h);
+    }
+    else
+    {
+        rheap_bucket_t* eq = &h->b[RHEAP_EQUAL];
+        if(eq->n == 0 && _refill(h) != 0) return -1;
+        e = eq->e[--eq->n];
+    }
+    h->size--;
+
+    if(id)
+    {
+        _store_be64(id, e.hi);
+        _store_be64(id + 8, e.lo);
+    }
+    if(value) *value = e.value;
+    return 0;
+}
+
+int uuid7_rheap_peek(uuid7_rheap_t* h, uint8_t* id, void** value)
+{
+    if(!h || h->size == 0) return -1;
+
+    /* A refill only moves the minimum into the equal bucket */
+    const rheap_entry_t* e;
+    if(h->late.n)
+    {
+        e = &h->late.e[0];
+    }
+    else
+    {
+        rheap_bucket_t* eq = &h->b[RHEAP_EQUAL];
+        if(eq->n == 0 && _refill(h) != 0) return -1;
+        e = &eq->e[eq->n - 1u];
+    }
+
+    if(id)
+    {
+        _store_be64(id, e->hi);
+        _store_be64(id + 8, e->lo);
+    }
+    if(value) *value = e->value;
+    return 0;
+}
+
+size_t uuid7_rheap_size(const uuid7_rheap_t* h)
+{
+    return h ? h->size : 0u;
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static inline unsigned _bucket_of(uint64_t hi, uint64_t lo, uint64_t last_hi, uint64_t last_lo)
+{
+    const uint64_t dh = hi ^ last_hi;
+    if(dh)
+    {
+        const unsigned byte = (63u - (unsigned)__builtin_clzll(dh)) >> 3;
+        return (8u + byte) * RHEAP_DIGITS + (unsigned)((hi >> (byte * 8u)) & 0xFFu);
+    }
+    const uint64_t dl = lo ^ last_lo;
+    if(dl)
+    {
+        const unsigned byte = (63u - (unsigned)__builtin_clzll(dl)) >> 3;
+        return byte * RHEAP_DIGITS + (unsigned)((lo >> (byte * 8u)) & 0xFFu);
+    }
+    return RHEAP_EQUAL;
+}
+
+static int _reserve(rheap_bucket_t* b, size_t extra)
+{
+    if(b->cap - b->n >= extra) return 0;
+    size_t cap = b->cap ? b->cap : RHEAP_MIN_CAP;
+    while(cap - b->n < extra) cap *= 2u;
+    rheap_entry_t* e = realloc(b->e, cap * sizeof(*e));
+    if(!e) return -1;
+    b->e = e;
+    b->cap = cap;
+    return 0;
+}
+
+static int _reserve_targets(uuid7_rheap_t* h, const rheap_entry_t* keys, size_t n, uint64_t last_hi,
+                            uint64_t last_lo)
+{
+    int rc = 0;
+    for(size_t i = 0; i < n && rc == 0; ++i)
+    {
+        rheap_bucket_t* b = &h->b[_bucket_of(keys[i].hi, keys[i].lo, last_hi, last_lo)];
+        rc = _reserve(b, ++b->need);
+    }
+    for(size_t i = 0; i < n; ++i) h->b[_bucket_of(keys[i].hi, keys[i].lo, last_hi, last_lo)].need = 0;
+    return rc;
+}
+
+static inline void _append(uuid7_rheap_t* h, unsigned bucket, const rheap_entry_t* e)
+{
+    rheap_bucket_t* b = &h->b[bucket];
+    b->e[b->n++] = *e;
+    if(bucket == RHEAP_EQUAL) return;
+    const unsigned pos = bucket / RHEAP_DIGITS;
+    const unsigned dig = bucket % RHEAP_DIGITS;
+    h->dig_occ[pos][dig >> 6] |= 1ull << (dig & 63u);
+    h->pos_occ |= 1u << pos;
+}
+
+static int _late_push(uuid7_rheap_t* h, const rheap_entry_t* e)
+{
+    rheap_bucket_t* q = &h->late;
+    if(_reserve(q, 1u) != 0) return -1;
+    size_t i = q->n++;
+    while(i > 0)
+    {
+        const size_t parent = (i - 1u) / 2u;
+        if(!_key_less(e->hi, e->lo, q->e[parent].hi, q->e[parent].lo)) break;
+        q->e[i] = q->e[parent];
+        i = parent;
+    }
+    q->e[i] = *e;
+    return 0;
+}
+
+static rheap_entry_t _late_pop(uuid7_rheap_t* h)
+{
+    rheap_bucket_t* q = &h->late;
+    const rheap_entry_t top = q->e[0];
+    const rheap_entry_t tail = q->e[--q->n];
+    size_t i = 0;
+    for(;;)
+    {
+        size_t child = 2u * i + 1u;
+        if(child >= q->n) break;
+        if(child + 1u < q->n && _key_less(q->e[child + 1u].hi, q->e[child + 1u].lo, q->e[child].hi, q->e[child].lo))
+        {
+            child++;
+        }
+        if(!_key_less(q->e[child].hi, q->e[child].lo, tail.hi, tail.lo)) break;
+        q->e[i] = q->e[child];
+        i = child;
+    }
+    if(q->n) q->e[i] = tail;
+    return top;
+}
+
+static int _refill(uuid7_rheap_t* h)
+{
+    /* Lowest occupied position, then its lowest digit; equal is empty */
+    if(h->pos_occ == 0) return -1;
+    const unsigned pos = (unsigned)__builtin_ctz(h->pos_occ);
+    unsigned dig = 0;
+    for(unsigned w = 0; w < RHEAP_DIGIT_WORDS; ++w)
+    {
+        if(h->dig_occ[pos][w])
+        {
+            dig = w * 64u + (unsigned)__builtin_ctzll(h->dig_occ[pos][w]);
+            break;
+        }
+    }
+    const unsigned src = pos * RHEAP_DIGITS + dig;
+
+    rheap_bucket_t* b = &h->b[src];
+    size_t min = 0;
+    for(size_t i = 1; i < b->n; ++i)
+    {
+        if(_key_less(b->e[i].hi, b->e[i].lo, b->e[min].hi, b->e[min].lo)) min = i;
+    }
+    const uint64_t last_hi = b->e[min].hi;
+    const uint64_t last_lo = b->e[min].lo;
+
+    /* Every entry lands at a position below pos: reserve, then move */
+    if(b->n == 1u)
+    {
+        if(_reserve(&h->b[RHEAP_EQUAL], 1u) != 0) return -1;
+    }
+    else
+    {
+        if(_reserve_targets(h, b->e, b->n, last_hi, last_lo) != 0) return -1;
+    }
+
+    h->last_hi = last_hi;
+    h->last_lo = last_lo;
+    for(size_t i = 0; i < b->n; ++i) _append(h, _bucket_of(b->e[i].hi, b->e[i].lo, last_hi, last_lo), &b->e[i]);
+    b->n = 0;
+    h->dig_occ[pos][dig >> 6] &= ~(1ull << (dig & 63u));
+    const uint64_t* occ = h->dig_occ[pos];
+    if((occ[0] | occ[1] | occ[2] | occ[3]) == 0) h->pos_occ &= ~(1u << pos);
+    return 0;
+}
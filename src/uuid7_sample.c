@@ -0,0 +1,240 @@
+/**
+ * @file uuid7_sample.c
+ * @brief Consistent sampling decisions taken from the UUIDv7 random tail.
+ *
+ * The tail is the low 62 bits of the big-endian second half of the ID, so
+ * a decision is one load, one byte swap and one compare. The rate becomes
+ * a threshold once per call; the batch path packs 64 compares into a
+ * bitmap word without branching on the outcome.
+ *
+ * Per-bucket sampling walks the runs of IDs that share a bucket. Runs no
+ * longer than the quota are kept whole; longer ones go through a max-heap
+ * of the quota's size holding the smallest (tail, high word) keys seen so
+ * far. Tails are uniform, so after the first quota entries an ID displaces
+ * the heap top with probability quota / position and most IDs cost one
+ * compare. The high word breaks tail ties so the choice never depends on
+ * the input order.
+ *
+ * @author: Roman Horshkov <roman.horshkov@gmail.com>
+ * @date:   2025
+ */
+
+#include "uuid7_sample.h"
+#include "uuid7_internal.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/****************************************************************************
+ * PRIVATE DEFINES
+ ****************************************************************************
+ */
+
+#define SAMPLE_ID_BYTES  16u
+#define SAMPLE_TAIL_BITS 62u
+#define SAMPLE_TAIL_MASK ((1ull << SAMPLE_TAIL_BITS) - 1u)
+#define SAMPLE_TAIL_ONE  0x1p62 /* 2^SAMPLE_TAIL_BITS as a double */
+#define SAMPLE_MS_SHIFT  16u    /* unix ms in the top 48 bits of the high word */
+
+/****************************************************************************
+ * PRIVATE STUCTURED VARIABLES
+ ****************************************************************************
+ */
+
+/* Bottom-k candidate: ordering key and position in the batch */
+typedef struct sample_ent
+{
+    uint64_t tail;
+    uint64_t hi;
+    size_t at;
+} sample_ent_t;
+
+/****************************************************************************
+ * PRIVATE VARIABLES
+ ****************************************************************************
+ */
+/* None */
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS PROTOTYPES
+ ****************************************************************************
+ */
+
+/**
+ * @brief The 62 random tail bits of an ID.
+ */
+static inline uint64_t _tail(const uint8_t* id);
+
+/**
+ * @brief Tails below the returned value are kept at @p rate.
+ */
+static uint64_t _threshold(double rate);
+
+/**
+ * @brief Whether candidate @p a sorts before @p b.
+ */
+static inline bool _ent_less(const sample_ent_t* a, const sample_ent_t* b);
+
+/**
+ * @brief Restore the max-heap property below @p i.
+ */
+static void _sift_down(sample_ent_t* heap, size_t n, size_t i);
+
+/**
+ * @brief Set the bits of the @p k smallest candidates of IDs [from, to).
+ */
+static void _keep_smallest(const uint8_t* ids, size_t from, size_t to, sample_ent_t* heap, size_t k,
+                           uint64_t* bitmap);
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+int uuid7_sample(const uint8_t* id, double rate)
+{
+    if(!id || rate != rate) return -1;
+    return _tail(id) < _threshold(rate) ? 1 : 0;
+}
+
+int uuid7_sample_n(const uint8_t* ids, size_t n, double rate, uint64_t* bitmap, size_t* kept)
+{
+    if((!ids || !bitmap) && n > 0) return -1;
+    if(rate != rate) return -1;
+
+    const uint64_t limit = _threshold(rate);
+    size_t total = 0;
+    for(size_t base = 0; base < n; base += 64u)
+    {
+        const size_t m = n - base < 64u ? n - base : 64u;
+        const uint8_t* p = ids + base * SAMPLE_ID_BYTES;
+        uint64_t word = 0;
+        for(size_t j = 0; j < m; ++j)
+        {
+            word |= (uint64_t)(_tail(p + j * SAMPLE_ID_BYTES) < limit) << j;
+        }
+        bitmap[base / 64u] = word;
+        total += (size_t)__builtin_popcountll(word);
+    }
+    if(kept) *kept = total;
+    return 0;
+}
+
+int uuid7_sample_per_bucket(const uint8_t* ids, size_t n, uint64_t bucket_ms, uint32_t per_bucket,
+                            uint64_t* bitmap, size_t* kept)
+{
+    if((!ids || !bitmap) && n > 0) return -1;
+    if(bucket_ms == 0) return -1;
+
+    memset(bitmap, 0, (n + 63u) / 64u * sizeof(uint64_t));
+    const size_t k = per_bucket < n ? per_bucket : n;
+    sample_ent_t* heap = NULL;
+    if(k > 0)
+    {
+        heap = malloc(k * sizeof(*heap));
+        if(!heap) return -1;
+    }
+
+    size_t total = 0;
+    uint64_t prev_start = 0;
+    for(size_t i = 0; i < n;)
+    {
+        const uint64_t ms = _load_be64(ids + i * SAMPLE_ID_BYTES) >> SAMPLE_MS_SHIFT;
+        const uint64_t start = ms - ms % bucket_ms;
+        if(i > 0 && start < prev_start)
+        {
+            free(heap);
+            return -1;
+        }
+        const uint64_t end = bucket_ms > UINT64_MAX - start ? UINT64_MAX : start + bucket_ms;
+
+        size_t j = i + 1u;
+        while(j < n)
+        {
+            const uint64_t next = _load_be64(ids + j * SAMPLE_ID_BYTES) >> SAMPLE_MS_SHIFT;
+            if(next < start || next >= end) break;
+            ++j;
+        }
+
+        if(j - i <= k)
+        {
+            for(size_t at = i; at < j; ++at) bitmap[at / 64u] |= 1ull << (at % 64u);
+            total += j - i;
+        }
+        else if(k > 0)
+        {
+            _keep_smallest(ids, i, j, heap, k, bitmap);
+            total += k;
+        }
+        prev_start = start;
+        i = j;
+    }
+
+    free(heap);
+    if(kept) *kept = total;
+    return 0;
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static inline uint64_t _tail(const uint8_t* id)
+{
+    return _load_be64(id + 8) & SAMPLE_TAIL_MASK;
+}
+
+static uint64_t _threshold(double rate)
+{
+    if(!(rate > 0.0)) return 0;
+    if(rate >= 1.0) return 1ull << SAMPLE_TAIL_BITS;
+    return (uint64_t)(rate * SAMPLE_TAIL_ONE);
+}
+
+static inline bool _ent_less(const sample_ent_t* a, const sample_ent_t* b)
+{
+    return a->tail < b->tail || (a->tail == b->tail && a->hi < b->hi);
+}
+
+static void _sift_down(sample_ent_t* heap, size_t n, size_t i)
+{
+    for(;;)
+    {
+        size_t top = i;
+        const size_t l = 2u * i + 1u;
+        const size_t r = l + 1u;
+        if(l < n && _ent_less(&heap[top], &heap[l])) top = l;
+        if(r < n && _ent_less(&heap[top], &heap[r])) top = r;
+        if(top == i) return;
+        const sample_ent_t t = heap[i];
+        heap[i] = heap[top];
+        heap[top] = t;
+        i = top;
+    }
+}
+
+static void _keep_smallest(const uint8_t* ids, size_t from, size_t to, sample_ent_t* heap, size_t k,
+                           uint64_t* bitmap)
+{
+    for(size_t i = 0; i < k; ++i)
+    {
+        const uint8_t* id = ids + (from + i) * SAMPLE_ID_BYTES;
+        heap[i] = (sample_ent_t){_tail(id), _load_be64(id), from + i};
+    }
+    for(size_t i = k / 2u; i-- > 0;) _sift_down(heap, k, i);
+
+    for(size_t at = from + k; at < to; ++at)
+    {
+        const uint8_t* id = ids + at * SAMPLE_ID_BYTES;
+        const uint64_t tail = _tail(id);
+        if(tail > heap[0].tail) continue; /* the common case, decided on the tail alone */
+        const sample_ent_t e = {tail, _load_be64(id), at};
+        if(!_ent_less(&e, &heap[0])) continue;
+        heap[0] = e;
+        _sift_down(heap, k, 0);
+    }
+
+    for(size_t i = 0; i < k; ++i) bitmap[heap[i].at / 64u] |= 1ull << (heap[i].at % 64u);
+}
@@ -0,0 +1,209 @@
+/**
+ * @file uuid7_sim.c
+ * @brief Deterministic, non-secure UUIDv7 generator with a virtual clock.
+ *
+ * Differences from `uuid7_gen()`, all in favour of speed and replayability:
+ *
+ * - Time comes from the caller-driven virtual clock in the state, never from
+ *   the system clock.
+ * - Randomness comes from xoshiro256** seeded through splitmix64. One 64-bit
+ *   output fills the 62-bit random tail; a second one is drawn only when a
+ *   new millisecond starts (fresh sequence).
+ * - The state is private to the instance, so there is no atomic and no
+ *   indirect call: an ID costs a compare, a PRNG step and two big-endian
+ *   64-bit stores. Batches skip the compare within a run of one ms.
+ *
+ * WARNING: NOT CRYPTOGRAPHICALLY SECURE. See uuid7_sim.h.
+ *
+ * @author: Roman Horshkov <roman.horshkov@gmail.com>
+ * @date:   2025
+ */
+
+#include "uuid7_sim.h"
+#include "uuid7_internal.h"
+
+#include <string.h>
+
+/****************************************************************************
+ * PRIVATE DEFINES
+ ****************************************************************************
+ */
+
+/* Same packing as the real generator's state word */
+#define SIM_SEQ_BITS        12u
+#define SIM_SEQ_MASK        ((1ull << SIM_SEQ_BITS) - 1ull)
+#define SIM_MS_MASK         ((1ull << 48) - 1ull)
+#define SIM_PACK(ms, seq)   (((uint64_t)(ms) << SIM_SEQ_BITS) | ((uint64_t)(seq) & SIM_SEQ_MASK))
+#define SIM_UNPACK_MS(word) ((uint64_t)(word) >> SIM_SEQ_BITS)
+
+/* High word: ms(48) | version(4) | seq(12); low word: variant(2) | rand(62) */
+#define SIM_VERSION_BITS    0x7000ull
+#define SIM_VARIANT_TOP     0x8000000000000000ull
+#define SIM_RAND62_MASK     0x3FFFFFFFFFFFFFFFull
+
+#define SIM_UUID_BYTES      16u
+
+/****************************************************************************
+ * PRIVATE STUCTURED VARIABLES
+ ****************************************************************************
+ */
+/* None */
+
+/****************************************************************************
+ * PRIVATE VARIABLES
+ ****************************************************************************
+ */
+/* None */
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS PROTOTYPES
+ ****************************************************************************
+ */
+
+/**
+ * @brief splitmix64 step, used to expand the seed.
+ * @param x  In/out state.
+ * @return Next output.
+ */
+static inline uint64_t _splitmix64(uint64_t* x);
+
+/**
+ * @brief xoshiro256** step.
+ * @param s  PRNG state.
+ * @return Next 64-bit output.
+ */
+static inline uint64_t _xoshiro256ss(uint64_t s[4]);
+
+/**
+ * @brief Reserve the next (ms, seq) pair at the current virtual time.
+ * @param sim  Generator.
+ * @return Packed (ms << 12) | seq.
+ */
+static inline uint64_t _next_word(uuid7_sim_t* sim);
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+int uuid7_sim_init(uuid7_sim_t* sim, uint64_t seed, uint64_t start_ms)
+{
+    if(!sim) return -1;
+    uint64_t x = seed;
+    for(int i = 0; i < 4; ++i) sim->rng[i] = _splitmix64(&x);
+    sim->now_ms = start_ms & SIM_MS_MASK;
+    sim->last = 0;
+    return 0;
+}
+
+int uuid7_sim_set_time(uuid7_sim_t* sim, uint64_t ms)
+{
+    if(!sim) return -1;
+    sim->now_ms = ms & SIM_MS_MASK;
+    return 0;
+}
+
+int uuid7_sim_advance(uuid7_sim_t* sim, uint64_t delta_ms)
+{
+    if(!sim) return -1;
+    sim->now_ms = (sim->now_ms + delta_ms) & SIM_MS_MASK;
+    return 0;
+}
+
+int uuid7_sim_gen(uuid7_sim_t* sim, uint8_t* out)
+{
+    if(!sim || !out) return -1;
+    const uint64_t word = _next_word(sim);
+    const uint64_t lo = (_xoshiro256ss(sim->rng) & SIM_RAND62_MASK) | SIM_VARIANT_TOP;
+    _store_be64(out, (SIM_UNPACK_MS(word) << 16) | SIM_VERSION_BITS | (word & SIM_SEQ_MASK));
+    _store_be64(out + 8, lo);
+    return 0;
+}
+
+int uuid7_sim_gen_n(uuid7_sim_t* sim, uint8_t* out, size_t n)
+{
+    if(!sim || (!out && n)) return -1;
+
+    /* Work on a local copy: stores through `out` may alias anything, and
+     * would otherwise force the PRNG state back to memory on every ID. */
+    uuid7_sim_t local = *sim;
+    uint8_t* p = out;
+    size_t left = n;
+    while(left)
+    {
+        /* After the first word of a run, (ms, seq) only increments until
+         * the sequence is exhausted: emit the run without re-checking */
+        const uint64_t word = _next_word(&local);
+        const uint64_t room = SIM_SEQ_MASK - (word & SIM_SEQ_MASK);
+        const size_t run = (size_t)(left - 1u < room ? left - 1u : room) + 1u;
+        uint64_t hi = (SIM_UNPACK_MS(word) << 16) | SIM_VERSION_BITS | (word & SIM_SEQ_MASK);
+        for(size_t i = 0; i < run; ++i, ++hi, p += SIM_UUID_BYTES)
+        {
+            _store_be64(p, hi);
+            _store_be64(p + 8, (_xoshiro256ss(local.rng) & SIM_RAND62_MASK) | SIM_VARIANT_TOP);
+        }
+        local.last = word + (run - 1u);
+        left -= run;
+    }
+    *sim = local;
+    return 0;
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static inline uint64_t _splitmix64(uint64_t* x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t _rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t _xoshiro256ss(uint64_t s[4])
+{
+    const uint64_t result = _rotl(s[1] * 5u, 7) * 9u;
+    const uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = _rotl(s[3], 45);
+    return result;
+}
+
+static inline uint64_t _next_word(uuid7_sim_t* sim)
+{
+    const uint64_t prev = sim->last;
+    const uint64_t prev_ms = SIM_UNPACK_MS(prev);
+
+    uint64_t word;
+    if(sim->now_ms > prev_ms)
+    {
+        /* New millisecond: fresh non-zero sequence (top 12 PRNG bits) */
+        uint64_t seq = _xoshiro256ss(sim->rng) >> (64u - SIM_SEQ_BITS);
+        if(seq == 0u) seq = 1u;
+        word = SIM_PACK(sim->now_ms, seq);
+    }
+    else if((prev & SIM_SEQ_MASK) != SIM_SEQ_MASK)
+    {
+        word = prev + 1u;
+    }
+    else
+    {
+        /* Sequence exhausted (or clock behind): roll into the next ms */
+        uint64_t seq = _xoshiro256ss(sim->rng) >> (64u - SIM_SEQ_BITS);
+        if(seq == 0u) seq = 1u;
+        word = SIM_PACK(prev_ms + 1u, seq);
+    }
+    sim->last = word;
+    return word;
+}
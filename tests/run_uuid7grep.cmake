@@ -0,0 +1,115 @@
+# Runs uuid7grep on a fixture and compares its output and exit status.
+#
+#   cmake -DTOOL=<uuid7grep> -DARGS="<args>" -DINPUT=<file> [-DSTDIN=ON]
+#         -DEXPECTED=<file> | -DEXPECTED_TEXT=<text>  [-DEXPECTED_RC=<n>]
+#         -P run_uuid7grep.cmake
+#
+#   cmake -DTOOL=<uuid7grep> -DPARALLEL=<dir> -P run_uuid7grep.cmake
+#
+# ARGS is split like a shell command line. With STDIN the fixture is piped
+# in, which takes the tool's stream path instead of the memory-mapped one.
+# EXPECTED_TEXT is compared with the output minus surrounding whitespace.
+#
+# PARALLEL writes a generated log of a few MiB to <dir> and checks that one,
+# three and four threads, mapped and piped, all print the expected lines.
+
+if(NOT DEFINED EXPECTED_RC)
+    set(EXPECTED_RC 0)
+endif()
+
+# Runs the tool on INPUT (piped when stdin is ON) into out_var and rc_var
+function(run_grep out_var rc_var args stdin)
+    separate_arguments(args UNIX_COMMAND "${args}")
+    if(stdin)
+        execute_process(COMMAND ${TOOL} ${args} INPUT_FILE ${INPUT} RESULT_VARIABLE rc OUTPUT_VARIABLE out)
+    else()
+        execute_process(COMMAND ${TOOL} ${args} ${INPUT} RESULT_VARIABLE rc OUTPUT_VARIABLE out)
+    endif()
+    set(${out_var} "${out}" PARENT_SCOPE)
+    set(${rc_var} "${rc}" PARENT_SCOPE)
+endfunction()
+
+if(DEFINED PARALLEL)
+    # 64-byte lines with the ID in columns [14, 50). 65537 lines = 4 * 16384
+    # + 1, so the raw cuts of 4 chunks fall at columns 16, 32 and 48 and those
+    # of 3 chunks at 42 and 20: every worker boundary lands inside an ID and
+    # has to move to the end of its line. The block number keeps the lines
+    # distinct, so chunks written out of order do not compare equal.
+    set(ids
+        019421bc-aa00-71a2-8a2b-0123456789ab # lower bound
+        019421bc-a9ff-71a2-8a2b-0123456789ab # one ms early
+        019421BC-B3C4-71A2-8A2B-0123456789AB # upper case
+        019421bc-bd88-71a2-8a2b-0123456789ab # upper bound
+        019421bc-bd89-71a2-8a2b-0123456789ab # one ms late
+        019421bc-ade8-41a2-8a2b-0123456789ab # v4
+        019421bc-ade8-71a2-ca2b-0123456789ab # wrong variant
+        019421bc-b5b8-71a2-8a2b-ba9876543210)
+    set(hits 0 2 3 7)
+
+    set(block "")
+    set(block_hits "")
+    foreach(i RANGE 7)
+        list(GET ids ${i} id)
+        set(line "n=@N@${i} id=${id} abcdefghijkl\n")
+        string(APPEND block "${line}")
+        list(FIND hits ${i} hit)
+        if(hit GREATER -1)
+            string(APPEND block_hits "${line}")
+        endif()
+    endforeach()
+
+    # 64 groups of 128 blocks; appending group by group keeps the copying
+    # of the growing strings linear
+    set(log "")
+    set(want "")
+    foreach(g RANGE 1000 1063)
+        set(group "")
+        set(group_hits "")
+        foreach(b RANGE 100 227)
+            string(REPLACE "@N@" "${g}${b}" text "${block}")
+            string(APPEND group "${text}")
+            string(REPLACE "@N@" "${g}${b}" text "${block_hits}")
+            string(APPEND group_hits "${text}")
+        endforeach()
+        string(APPEND log "${group}")
+        string(APPEND want "${group_hits}")
+    endforeach()
+    string(REPLACE "@N@" "1064100" text "${block}")
+    string(REGEX MATCH "^[^\n]*\n" text "${text}")
+    string(APPEND log "${text}")
+    string(APPEND want "${text}")
+
+    set(INPUT ${PARALLEL}/uuid7grep-parallel.log)
+    file(WRITE ${INPUT} "${log}")
+
+    foreach(stdin OFF ON)
+        foreach(jobs 1 3 4)
+            set(args "-j ${jobs} -f 1735732800000 -t 1735732805000")
+            run_grep(out rc "${args}" ${stdin})
+            if(NOT rc EQUAL 0 OR NOT out STREQUAL want)
+                string(LENGTH "${out}" got)
+                string(LENGTH "${want}" len)
+                message(FATAL_ERROR "uuid7grep ${args} (stdin ${stdin}): exit status ${rc}, "
+                                    "${got} bytes of output, expected ${len} identical bytes")
+            endif()
+        endforeach()
+    endforeach()
+    file(REMOVE ${INPUT})
+    return()
+endif()
+
+run_grep(out rc "${ARGS}" "${STDIN}")
+
+if(DEFINED EXPECTED)
+    file(READ ${EXPECTED} want)
+else()
+    set(want "${EXPECTED_TEXT}")
+    string(STRIP "${out}" out)
+endif()
+
+if(NOT rc EQUAL EXPECTED_RC)
+    message(FATAL_ERROR "uuid7grep ${ARGS}: exit status ${rc}, expected ${EXPECTED_RC}")
+endif()
+if(NOT out STREQUAL want)
+    message(FATAL_ERROR "uuid7grep ${ARGS}: output differs\n--- got\n${out}--- expected\n${want}")
+endif()
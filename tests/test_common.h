@@ -0,0 +1,41 @@
+/**
+ * @file test_common.h
+ * @brief Fixtures shared by the module tests: a settable clock for the
+ * modules' `clock_fn` and ID helpers.
+ */
+
+#ifndef UUID7_TEST_COMMON_H
+#define UUID7_TEST_COMMON_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+/* 2025-01-01T00:00:00Z, a multiple of every bucket width the tests use */
+#define T0_MS 1735689600000ull
+
+static _Atomic uint64_t g_clock = T0_MS;
+
+/* `clock_fn` reading g_clock */
+static uint64_t test_clock(void)
+{
+    return atomic_load(&g_clock);
+}
+
+/* A v7-shaped ID at @p ms with a fixed tail */
+static inline void set_ms(uint8_t* id, uint64_t ms)
+{
+    memset(id, 0xA5, 16);
+    for(int i = 0; i < 6; ++i) id[i] = (uint8_t)(ms >> (40 - 8 * i));
+    id[6] = 0x70;
+    id[8] = 0x80;
+}
+
+static inline uint64_t id_ms(const uint8_t* id)
+{
+    uint64_t ms = 0;
+    for(int i = 0; i < 6; ++i) ms = (ms << 8) | id[i];
+    return ms;
+}
+
+#endif  // UUID7_TEST_COMMON_H
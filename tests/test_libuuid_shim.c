@@ -0,0 +1,140 @@
+/*
+ * Consumer of the libuuid API, built twice: linked straight against the
+ * shim, and (when the system libuuid is available) linked against libuuid
+ * and run with the shim in LD_PRELOAD, once more with the generate calls
+ * routed back to libuuid (UUID7_PRELOAD_*=libuuid). Prototypes are declared
+ * here, as in <uuid/uuid.h>, so the test does not need the libuuid headers.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+typedef unsigned char uuid_t[16];
+
+void uuid_generate(uuid_t out);
+void uuid_generate_random(uuid_t out);
+void uuid_generate_time(uuid_t out);
+int uuid_generate_time_safe(uuid_t out);
+void uuid_unparse(const uuid_t uu, char* out);
+void uuid_unparse_lower(const uuid_t uu, char* out);
+void uuid_unparse_upper(const uuid_t uu, char* out);
+int uuid_parse(const char* in, uuid_t uu);
+time_t uuid_time(const uuid_t uu, struct timeval* ret_tv);
+
+/* Whether the shim was told to forward a family of calls to libuuid */
+static bool passthrough(const char* var)
+{
+    const char* v = getenv(var);
+    return v && strcmp(v, "libuuid") == 0;
+}
+
+static void test_generate_time_is_v7(void** state)
+{
+    (void)state;
+    uuid_t a, b;
+    uuid_generate_time(a);
+    int rc = uuid_generate_time_safe(b);
+    if(passthrough("UUID7_PRELOAD_TIME"))
+    {
+        /* The real library's v1, which is not byte-ordered */
+        assert_int_equal(a[6] >> 4, 1);
+        assert_int_equal(b[6] >> 4, 1);
+        return;
+    }
+    /* Real libuuid returns v1 here: v7 proves the shim is interposed */
+    assert_int_equal(rc, 0);
+    assert_int_equal(a[6] >> 4, 7);
+    assert_int_equal(b[6] >> 4, 7);
+    assert_int_equal(a[8] & 0xC0, 0x80);
+    assert_true(memcmp(a, b, sizeof(uuid_t)) < 0);
+}
+
+static void test_generate_is_random_v4(void** state)
+{
+    (void)state;
+    uuid_t a, b;
+    uuid_generate(a);
+    uuid_generate_random(b);
+    /* Forwarded uuid_generate() may fall back to v1; random never may */
+    if(!passthrough("UUID7_PRELOAD_GENERATE")) assert_int_equal(a[6] >> 4, 4);
+    assert_int_equal(a[8] & 0xC0, 0x80);
+    assert_true(memcmp(a, b, sizeof(uuid_t)) != 0);
+    for(int i = 0; i < 256; ++i)
+    {
+        uuid_generate_random(b);
+        assert_int_equal(b[6] >> 4, 4);
+        assert_int_equal(b[8] & 0xC0, 0x80);
+    }
+}
+
+static void test_unparse_parse_round_trip(void** state)
+{
+    (void)state;
+    uuid_t id, back;
+    char str[37];
+    for(int i = 0; i < 256; ++i)
+    {
+        uuid_generate(id);
+        uuid_unparse(id, str);
+        assert_int_equal(strlen(str), 36);
+        assert_int_equal(uuid_parse(str, back), 0);
+        assert_memory_equal(id, back, sizeof(uuid_t));
+    }
+}
+
+static void test_unparse_case(void** state)
+{
+    (void)state;
+    static const uuid_t id = {0x01, 0x90, 0xA1, 0xB2, 0xC3, 0xD4, 0x7A, 0xBC,
+                              0x8F, 0xED, 0xCB, 0xA9, 0x87, 0x65, 0x43, 0x21};
+    char str[37];
+    uuid_unparse_lower(id, str);
+    assert_string_equal(str, "0190a1b2-c3d4-7abc-8fed-cba987654321");
+    uuid_unparse_upper(id, str);
+    assert_string_equal(str, "0190A1B2-C3D4-7ABC-8FED-CBA987654321");
+}
+
+static void test_parse_rejects_like_libuuid(void** state)
+{
+    (void)state;
+    uuid_t out;
+    memset(out, 0xAA, sizeof(out));
+    assert_int_equal(uuid_parse("0190a1b2-c3d4-7abc-8fed-cba987654321 ", out), -1);
+    assert_int_equal(uuid_parse("0190a1b2-c3d4-7abc-8fed-cba98765432", out), -1);
+    assert_int_equal(uuid_parse("0190a1b2-c3d4-7abc-8fed-cba98765432x", out), -1);
+    assert_int_equal(uuid_parse("0190a1b2+c3d4-7abc-8fed-cba987654321", out), -1);
+    assert_int_equal(out[0], 0xAA);
+}
+
+static void test_time_decodes_v7(void** state)
+{
+    (void)state;
+    static const uuid_t id = {0x01, 0x94, 0x1F, 0x29, 0x7C, 0x00, 0x7B, 0x3F,
+                              0x85, 0x3B, 0x55, 0x96, 0x47, 0x36, 0x4C, 0xEA};
+    struct timeval tv;
+    assert_int_equal(uuid_time(id, &tv), 1735689600);
+    assert_int_equal(tv.tv_sec, 1735689600);
+    assert_int_equal(tv.tv_usec, 0);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_generate_time_is_v7),
+        cmocka_unit_test(test_generate_is_random_v4),
+        cmocka_unit_test(test_unparse_parse_round_trip),
+        cmocka_unit_test(test_unparse_case),
+        cmocka_unit_test(test_parse_rejects_like_libuuid),
+        cmocka_unit_test(test_time_decodes_v7),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -1,8 +1,14 @@
 #include "uuid7.h"
 
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
 
 #include <stdarg.h>
 #include <stddef.h>
@@ -173,6 +179,602 @@ static void test_init_null_leaves_existing_rng(void** state)
     assert_int_equal(uuid[9], script[3]);
 }
 
+static uint64_t g_fake_ms;
+
+static uint64_t fake_clock(void)
+{
+    return g_fake_ms;
+}
+
+static void test_set_clock_drives_timestamp(void** state)
+{
+    (void)state;
+    rng_load_script(NULL, 0, 0x30);
+    /* Far ahead of real time so earlier tests' state is below it; the
+     * tests that move the clock this far run last (see main) */
+    g_fake_ms = 0x0F0000000000ull;
+    assert_int_equal(uuid7_set_clock(fake_clock), 0);
+
+    uint8_t uuid[16] = {0};
+    assert_int_equal(uuid7_gen(uuid), 0);
+    assert_true(extract_ms(uuid) == g_fake_ms);
+
+    uint64_t ms = 0;
+    assert_int_equal(uuid7_get_ms(uuid, &ms), 0);
+    assert_true(ms == g_fake_ms);
+    assert_int_equal(uuid7_get_ms(NULL, &ms), -1);
+
+    assert_int_equal(uuid7_set_clock(NULL), 0);
+}
+
+static void test_clock_backward_jump_stays_monotonic(void** state)
+{
+    (void)state;
+    rng_load_script(NULL, 0, 0x90);
+    g_fake_ms = 0x0F0000000100ull;
+    assert_int_equal(uuid7_set_clock(fake_clock), 0);
+
+    uint8_t first[16] = {0};
+    uint8_t second[16] = {0};
+    assert_int_equal(uuid7_gen(first), 0);
+    g_fake_ms -= 5000u;
+    assert_int_equal(uuid7_gen(second), 0);
+
+    assert_true(extract_ms(second) == extract_ms(first));
+    assert_true(extract_seq(second) > extract_seq(first));
+
+    assert_int_equal(uuid7_set_clock(NULL), 0);
+}
+
+static void test_str_ms_decodes_prefix(void** state)
+{
+    (void)state;
+    uint64_t ms = 0;
+    assert_int_equal(uuid7_str_ms("0190a1b2-C3d4-7abc-8def-0123456789ab", &ms), 0);
+    assert_true(ms == 0x0190a1b2c3d4ull);
+
+    /* Only the prefix is inspected */
+    assert_int_equal(uuid7_str_ms("00000000-0001", &ms), 0);
+    assert_true(ms == 1ull);
+}
+
+static void test_str_ms_rejects_malformed(void** state)
+{
+    (void)state;
+    uint64_t ms = 0;
+    assert_int_equal(uuid7_str_ms(NULL, &ms), -1);
+    assert_int_equal(uuid7_str_ms("0190a1b2-c3d4", NULL), -1);
+    assert_int_equal(uuid7_str_ms("0190a1b2c3d4-7abc", &ms), -1);
+    assert_int_equal(uuid7_str_ms("0190a1g2-c3d4", &ms), -1);
+    assert_int_equal(uuid7_str_ms("0190a1b2-c3", &ms), -1);
+}
+
+static void test_gen_v4_sets_version_and_variant(void** state)
+{
+    (void)state;
+    uint8_t id[16];
+    for(int i = 0; i < 64; ++i)
+    {
+        assert_int_equal(uuid7_gen_v4(id), 0);
+        assert_int_equal(id[6] >> 4, 4);
+        assert_int_equal(id[8] & 0xC0, 0x80);
+    }
+    assert_int_equal(uuid7_gen_v4(NULL), -1);
+}
+
+static void test_rng_pool_not_shared_across_fork(void** state)
+{
+    (void)state;
+    assert_int_equal(uuid7_set_rng(uuid7_rng_buffered), 0);
+    uint8_t warm[16];
+    uuid7_gen_v4(warm); /* parent pool now holds unused bytes */
+
+    int fds[2];
+    assert_int_equal(pipe(fds), 0);
+    const pid_t pid = fork();
+    assert_true(pid >= 0);
+    if(pid == 0)
+    {
+        uint8_t id[16];
+        uuid7_gen_v4(id);
+        _exit(write(fds[1], id, sizeof(id)) == (ssize_t)sizeof(id) ? 0 : 1);
+    }
+    uint8_t parent[16], child[16];
+    uuid7_gen_v4(parent);
+    assert_int_equal(read(fds[0], child, sizeof(child)), (ssize_t)sizeof(child));
+    int status = 0;
+    waitpid(pid, &status, 0);
+    close(fds[0]);
+    close(fds[1]);
+    assert_true(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert_memory_not_equal(parent, child, sizeof(parent));
+    assert_int_equal(uuid7_set_rng(NULL), 0);
+}
+
+static void test_warmup_installs_default_rng(void** state)
+{
+    (void)state;
+    assert_int_equal(uuid7_set_rng(NULL), 0);
+    assert_int_equal(uuid7_warmup(0), 0);
+    assert_int_equal(uuid7_warmup(UUID7_WARMUP_AT_RANDOM), 0);
+
+    uint8_t a[16], b[16];
+    assert_int_equal(uuid7_gen_v4(a), 0);
+    assert_int_equal(uuid7_gen_v4(b), 0);
+    assert_memory_not_equal(a, b, sizeof(a));
+
+    /* Opting into the pool: warmup prefills it, AT_RANDOM is mixed in */
+    assert_int_equal(uuid7_set_rng(uuid7_rng_buffered), 0);
+    assert_int_equal(uuid7_warmup(UUID7_WARMUP_AT_RANDOM), 0);
+    assert_int_equal(uuid7_gen_v4(a), 0);
+    assert_int_equal(uuid7_gen_v4(b), 0);
+    assert_memory_not_equal(a, b, sizeof(a));
+    assert_int_equal(uuid7_set_rng(NULL), 0);
+}
+
+static void test_warmup_keeps_custom_rng(void** state)
+{
+    (void)state;
+    const uint8_t script[] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88,
+                              0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xF0, 0x01};
+    rng_load_script(script, sizeof(script), 0);
+    assert_int_equal(uuid7_warmup(0), 0);
+
+    uint8_t id[16];
+    assert_int_equal(uuid7_gen_v4(id), 0);
+    assert_int_equal(id[0], 0x11);
+    assert_int_equal(id[15], 0x01);
+    assert_int_equal(uuid7_set_rng(NULL), 0);
+}
+
+static void test_str_round_trip(void** state)
+{
+    (void)state;
+    static const uint8_t id[16] = {0x01, 0x90, 0xA1, 0xB2, 0xC3, 0xD4, 0x7A, 0xBC,
+                                   0x8F, 0xED, 0xCB, 0xA9, 0x87, 0x65, 0x43, 0x21};
+    char str[37];
+    assert_int_equal(uuid7_to_str(id, str), 0);
+    assert_string_equal(str, "0190a1b2-c3d4-7abc-8fed-cba987654321");
+    assert_int_equal(uuid7_to_str_upper(id, str), 0);
+    assert_string_equal(str, "0190A1B2-C3D4-7ABC-8FED-CBA987654321");
+
+    uint8_t back[16];
+    assert_int_equal(uuid7_from_str("0190A1b2-c3D4-7abc-8FED-cba987654321", back), 0);
+    assert_memory_equal(back, id, sizeof(id));
+}
+
+/* Reference rendering through the C library */
+static void time_str_ref(uint64_t ms, char* out)
+{
+    const time_t secs = (time_t)(ms / 1000u);
+    struct tm tm;
+    gmtime_r(&secs, &tm);
+    const size_t len = strftime(out, 21, "%Y-%m-%dT%H:%M:%S.", &tm);
+    snprintf(out + len, 5, "%03uZ", (unsigned)(ms % 1000u));
+}
+
+static void set_ms(uint8_t* id, uint64_t ms)
+{
+    for(int i = 0; i < 6; ++i) id[i] = (uint8_t)(ms >> (8 * (5 - i)));
+}
+
+static void test_time_str_matches_gmtime(void** state)
+{
+    (void)state;
+    uint8_t id[16] = {0};
+    char got[UUID7_TIME_STR_LEN + 1];
+    char want[32];
+
+    set_ms(id, 0u);
+    assert_int_equal(uuid7_time_str(id, got), 0);
+    assert_string_equal(got, "1970-01-01T00:00:00.000Z");
+    set_ms(id, 951782400123ull); /* leap day of a 400-year leap */
+    assert_int_equal(uuid7_time_str(id, got), 0);
+    assert_string_equal(got, "2000-02-29T00:00:00.123Z");
+    set_ms(id, 4107542399999ull); /* 2100 is not a leap year */
+    assert_int_equal(uuid7_time_str(id, got), 0);
+    assert_string_equal(got, "2100-02-28T23:59:59.999Z");
+    set_ms(id, 253402300799999ull);
+    assert_int_equal(uuid7_time_str(id, got), 0);
+    assert_string_equal(got, "9999-12-31T23:59:59.999Z");
+    set_ms(id, 253402300800000ull);
+    assert_int_equal(uuid7_time_str(id, got), -1);
+    assert_int_equal(uuid7_time_str(NULL, got), -1);
+    assert_int_equal(uuid7_time_str(id, NULL), -1);
+
+    /* Scattered timestamps, then a sorted batch crossing seconds and days */
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    for(int i = 0; i < 20000; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        const uint64_t ms = x % 253402300800000ull;
+        set_ms(id, ms);
+        time_str_ref(ms, want);
+        assert_int_equal(uuid7_time_str(id, got), 0);
+        assert_string_equal(got, want);
+    }
+
+    enum { N = 512 };
+    static uint8_t ids[N][16];
+    static char out[N * UUID7_TIME_STR_LEN];
+    uint64_t ms = 1735689599000ull; /* 2024-12-31T23:59:59Z */
+    for(int i = 0; i < N; ++i)
+    {
+        ms += (uint64_t)(i % 7) * 3u;
+        set_ms(ids[i], ms);
+    }
+    assert_int_equal(uuid7_time_str_n(&ids[0][0], N, out), 0);
+    for(int i = 0; i < N; ++i)
+    {
+        uint64_t v = 0;
+        assert_int_equal(uuid7_get_ms(ids[i], &v), 0);
+        time_str_ref(v, want);
+        assert_memory_equal(out + i * UUID7_TIME_STR_LEN, want, UUID7_TIME_STR_LEN);
+    }
+    assert_int_equal(uuid7_time_str_n(&ids[0][0], 0, out), 0);
+    assert_int_equal(uuid7_time_str_n(NULL, 1, out), -1);
+}
+
+static void test_from_str_rejects_malformed(void** state)
+{
+    (void)state;
+    uint8_t out[16];
+    assert_int_equal(uuid7_from_str(NULL, out), -1);
+    assert_int_equal(uuid7_from_str("0190a1b2-c3d4-7abc-8fed-cba987654321", NULL), -1);
+    assert_int_equal(uuid7_from_str("0190a1b2-c3d4-7abc-8fed-cba98765432g", out), -1);
+    assert_int_equal(uuid7_from_str("0190a1b2-c3d4-7abc-8fed:cba987654321", out), -1);
+    assert_int_equal(uuid7_from_str("0190a1b2c-3d4-7abc-8fed-cba987654321", out), -1);
+    assert_int_equal(uuid7_from_str("0190a1b2-c3d4-7abc-8fed-cba98765432/", out), -1);
+}
+
+static void test_adaptive_config_validation(void** state)
+{
+    (void)state;
+    uuid7_adapt_config_t cfg;
+    assert_int_equal(uuid7_adapt_config_init(NULL), -1);
+    assert_int_equal(uuid7_adapt_config_init(&cfg), 0);
+
+    uuid7_adapt_config_t bad = cfg;
+    bad.window = 0;
+    assert_int_equal(uuid7_set_adaptive(&bad), -1);
+    bad = cfg;
+    bad.exit_pct = bad.enter_pct + 1u;
+    assert_int_equal(uuid7_set_adaptive(&bad), -1);
+    bad = cfg;
+    bad.lease_size = 4097u;
+    assert_int_equal(uuid7_set_adaptive(&bad), -1);
+    bad = cfg;
+    bad.exit_windows = 0;
+    assert_int_equal(uuid7_set_adaptive(&bad), -1);
+
+    assert_int_equal(uuid7_set_adaptive(&cfg), 0);
+    assert_int_equal(uuid7_set_adaptive(NULL), 0);
+    assert_int_equal(uuid7_get_adapt_stats(NULL), -1);
+}
+
+static void zero_rng(void* buf, const size_t n)
+{
+    memset(buf, 0, n);
+}
+
+static void test_adaptive_switches_and_stays_monotonic(void** state)
+{
+    (void)state;
+    /* Sequences start at 1 and only increment: 64+ IDs fit in one ms */
+    assert_int_equal(uuid7_set_rng(zero_rng), 0);
+    g_fake_ms = 0x0F0000010000ull;
+    assert_int_equal(uuid7_set_clock(fake_clock), 0);
+
+    /* enter_pct 0: every window counts as contended, so one window leases */
+    uuid7_adapt_config_t cfg;
+    uuid7_adapt_config_init(&cfg);
+    cfg.window = 4u;
+    cfg.enter_pct = 0u;
+    cfg.exit_pct = 0u;
+    cfg.enter_windows = 1u;
+    cfg.exit_windows = 2u;
+    cfg.lease_size = 16u;
+    assert_int_equal(uuid7_set_adaptive(&cfg), 0);
+
+    uuid7_adapt_stats_t base, st;
+    uuid7_get_adapt_stats(&base);
+
+    uint8_t prev[16], cur[16];
+    assert_int_equal(uuid7_gen(prev), 0);
+    for(int i = 0; i < 64; ++i)
+    {
+        assert_int_equal(uuid7_gen(cur), 0);
+        assert_true(memcmp(prev, cur, 8) < 0);
+        assert_true(extract_ms(cur) == g_fake_ms);
+        memcpy(prev, cur, sizeof(cur));
+    }
+    uuid7_get_adapt_stats(&st);
+    assert_true(st.to_leased > base.to_leased);
+    assert_true(st.leases > base.leases);
+
+    /* One ID per ms: leases expire mostly unused and refills never collide */
+    int rounds = 0;
+    while(st.to_shared == base.to_shared && rounds++ < 256)
+    {
+        g_fake_ms++;
+        assert_int_equal(uuid7_gen(cur), 0);
+        assert_true(memcmp(prev, cur, 8) < 0);
+        assert_true(extract_ms(cur) == g_fake_ms);
+        memcpy(prev, cur, sizeof(cur));
+        uuid7_get_adapt_stats(&st);
+    }
+    assert_true(st.to_shared > base.to_shared);
+
+    assert_int_equal(uuid7_set_adaptive(NULL), 0);
+    assert_int_equal(uuid7_gen(cur), 0);
+    assert_true(memcmp(prev, cur, 8) < 0);
+    assert_int_equal(uuid7_set_clock(NULL), 0);
+    assert_int_equal(uuid7_set_rng(NULL), 0);
+}
+
+#define MT_THREADS 4
+#define MT_PER_THREAD 20000
+
+static uint8_t g_mt_ids[MT_THREADS * MT_PER_THREAD][16];
+static int (*g_mt_gen)(uint8_t* out);
+
+/* Fill this thread's share of g_mt_ids; returns arg if its IDs ascend */
+static void* mt_worker(void* arg)
+{
+    const size_t t = (size_t)(uintptr_t)arg - 1u;
+    bool ordered = true;
+    for(size_t i = 0; i < MT_PER_THREAD; ++i)
+    {
+        uint8_t* id = g_mt_ids[t * MT_PER_THREAD + i];
+        g_mt_gen(id);
+        if(i > 0 && memcmp(id - 16, id, 8) >= 0) ordered = false;
+    }
+    return ordered ? arg : NULL;
+}
+
+static int cmp_id(const void* a, const void* b)
+{
+    return memcmp(a, b, 16);
+}
+
+/* Run MT_THREADS workers and check per-thread order and global uniqueness */
+static void run_mt_workers(int (*gen)(uint8_t* out))
+{
+    g_mt_gen = gen;
+    pthread_t th[MT_THREADS];
+    for(size_t t = 0; t < MT_THREADS; ++t)
+    {
+        assert_int_equal(pthread_create(&th[t], NULL, mt_worker, (void*)(uintptr_t)(t + 1)), 0);
+    }
+    for(size_t t = 0; t < MT_THREADS; ++t)
+    {
+        void* ret = NULL;
+        pthread_join(th[t], &ret);
+        assert_true(ret == (void*)(uintptr_t)(t + 1));
+    }
+
+    qsort(g_mt_ids, MT_THREADS * MT_PER_THREAD, 16, cmp_id);
+    for(size_t i = 1; i < MT_THREADS * MT_PER_THREAD; ++i)
+    {
+        assert_true(memcmp(g_mt_ids[i - 1], g_mt_ids[i], 8) != 0);
+    }
+}
+
+static void test_adaptive_threads_unique_and_ordered(void** state)
+{
+    (void)state;
+    /* Flip modes as often as possible while threads race */
+    uuid7_adapt_config_t cfg;
+    uuid7_adapt_config_init(&cfg);
+    cfg.window = 8u;
+    cfg.enter_pct = 0u;
+    cfg.exit_pct = 0u;
+    cfg.enter_windows = 1u;
+    cfg.exit_windows = 1u;
+    cfg.lease_size = 8u;
+    assert_int_equal(uuid7_set_adaptive(&cfg), 0);
+    run_mt_workers(uuid7_gen);
+    assert_int_equal(uuid7_set_adaptive(NULL), 0);
+}
+
+static void test_fc_threads_unique_and_ordered(void** state)
+{
+    (void)state;
+    run_mt_workers(uuid7_gen_fc);
+
+    /* Same shared state as uuid7_gen(): interleaved calls stay ordered */
+    uint8_t a[16], b[16], c[16];
+    assert_int_equal(uuid7_gen(a), 0);
+    assert_int_equal(uuid7_gen_fc(b), 0);
+    assert_int_equal(uuid7_gen(c), 0);
+    assert_true(memcmp(a, b, 8) < 0);
+    assert_true(memcmp(b, c, 8) < 0);
+    assert_int_equal(uuid7_gen_fc(NULL), -1);
+}
+
+static void test_gen_n_blocks_ordered(void** state)
+{
+    (void)state;
+    /* More than one reserved block, bracketed by single IDs */
+    enum { N = 5000 };
+    static uint8_t ids[N + 2][16];
+    assert_int_equal(uuid7_gen(ids[0]), 0);
+    assert_int_equal(uuid7_gen_n(ids[1], N), 0);
+    assert_int_equal(uuid7_gen(ids[N + 1]), 0);
+    for(size_t i = 1; i < N + 2; ++i)
+    {
+        assert_true(memcmp(ids[i - 1], ids[i], 8) < 0);
+        assert_int_equal(ids[i][6] >> 4, 7);
+        assert_int_equal(ids[i][8] & 0xC0u, 0x80u);
+    }
+    assert_int_equal(uuid7_gen_n(NULL, 0), 0);
+    assert_int_equal(uuid7_gen_n(NULL, 1), -1);
+}
+
+static void test_gen_n_retires_lease(void** state)
+{
+    (void)state;
+    /* Force leasing: the batch and the combined ID come from the shared
+     * state, and the next uuid7_gen() must not fall back into the lease */
+    uuid7_adapt_config_t cfg;
+    uuid7_adapt_config_init(&cfg);
+    cfg.window = 2u;
+    cfg.enter_pct = 0u;
+    cfg.exit_pct = 0u;
+    cfg.enter_windows = 1u;
+    cfg.exit_windows = 1000000u;
+    cfg.lease_size = 64u;
+    assert_int_equal(uuid7_set_adaptive(&cfg), 0);
+
+    uint8_t ids[8][16];
+    for(int run = 0; run < 1000; ++run)
+    {
+        assert_int_equal(uuid7_gen(ids[0]), 0);
+        assert_int_equal(uuid7_gen(ids[1]), 0);
+        assert_int_equal(uuid7_gen_n(ids[2], 4u), 0);
+        assert_int_equal(uuid7_gen(ids[6]), 0);
+        assert_int_equal(run % 2 ? uuid7_gen_fc(ids[7]) : uuid7_gen(ids[7]), 0);
+        for(int i = 1; i < 8; ++i) assert_true(memcmp(ids[i - 1], ids[i], 8) < 0);
+        uint8_t after[16];
+        assert_int_equal(uuid7_gen(after), 0);
+        assert_true(memcmp(ids[7], after, 8) < 0);
+    }
+    uuid7_adapt_stats_t st;
+    assert_int_equal(uuid7_get_adapt_stats(&st), 0);
+    assert_int_equal(st.leased, 1);
+    assert_int_equal(uuid7_set_adaptive(NULL), 0);
+}
+
+static void* fc_once(void* arg)
+{
+    uint8_t id[16];
+    return uuid7_gen_fc(id) == 0 && (id[6] >> 4) == 7 ? arg : NULL;
+}
+
+static void test_fc_slots_recycled_after_thread_exit(void** state)
+{
+    (void)state;
+    /* More short-lived threads than slots */
+    for(uintptr_t i = 1; i <= 600; ++i)
+    {
+        pthread_t th;
+        void* ret = NULL;
+        assert_int_equal(pthread_create(&th, NULL, fc_once, (void*)i), 0);
+        pthread_join(th, &ret);
+        assert_true(ret == (void*)i);
+    }
+}
+
+static void test_inflight_watermark_follows_commits(void** state)
+{
+    (void)state;
+    uint8_t a[16], b[16], wm[16];
+    assert_int_equal(uuid7_inflight_begin(a), 0);
+    assert_int_equal(uuid7_inflight_begin(b), 0);
+
+    /* The oldest open ID holds the watermark back */
+    assert_int_equal(uuid7_low_watermark(wm), 0);
+    assert_memory_equal(wm, a, 8);
+    assert_int_equal(wm[8], 0x80);
+
+    assert_int_equal(uuid7_inflight_commit(a), 0);
+    assert_int_equal(uuid7_low_watermark(wm), 0);
+    assert_memory_equal(wm, b, 8);
+
+    /* Nothing open: bounded by the next ID the generator can issue */
+    assert_int_equal(uuid7_inflight_commit(b), 0);
+    assert_int_equal(uuid7_low_watermark(wm), 0);
+    assert_true(memcmp(b, wm, 8) < 0);
+    uint8_t next[16];
+    assert_int_equal(uuid7_gen(next), 0);
+    assert_true(memcmp(wm, next, 8) <= 0);
+
+    assert_int_equal(uuid7_inflight_commit(b), -1);
+    assert_int_equal(uuid7_inflight_commit(NULL), -1);
+    assert_int_equal(uuid7_inflight_begin(NULL), -1);
+    assert_int_equal(uuid7_low_watermark(NULL), -1);
+
+    uint8_t open[UUID7_INFLIGHT_MAX][16];
+    for(unsigned i = 0; i < UUID7_INFLIGHT_MAX; ++i) assert_int_equal(uuid7_inflight_begin(open[i]), 0);
+    assert_int_equal(uuid7_inflight_begin(a), -1);
+    for(unsigned i = UUID7_INFLIGHT_MAX; i-- > 0;) assert_int_equal(uuid7_inflight_commit(open[i]), 0);
+}
+
+static void test_inflight_under_leasing(void** state)
+{
+    (void)state;
+    uuid7_adapt_config_t cfg;
+    uuid7_adapt_config_init(&cfg);
+    cfg.window = 2u;
+    cfg.enter_pct = 0u;
+    cfg.exit_pct = 0u;
+    cfg.enter_windows = 1u;
+    cfg.exit_windows = 1000000u;
+    assert_int_equal(uuid7_set_adaptive(&cfg), 0);
+
+    /* An in-flight ID is ordered against the thread's leased IDs */
+    uint8_t before[16], id[16], after[16], wm[16];
+    for(int run = 0; run < 1000; ++run)
+    {
+        assert_int_equal(uuid7_gen(before), 0);
+        assert_int_equal(uuid7_inflight_begin(id), 0);
+        assert_int_equal(uuid7_gen(after), 0);
+        assert_true(memcmp(before, id, 8) < 0);
+        assert_true(memcmp(id, after, 8) < 0);
+        assert_int_equal(uuid7_inflight_commit(id), 0);
+    }
+
+    /* Leased words may land below any bound: no watermark while enabled */
+    assert_int_equal(uuid7_low_watermark(wm), -1);
+    assert_int_equal(uuid7_set_adaptive(NULL), 0);
+    assert_int_equal(uuid7_low_watermark(wm), 0);
+    assert_int_equal(uuid7_gen(after), 0);
+    assert_true(memcmp(wm, after, 8) <= 0);
+}
+
+static void* inflight_writer(void* arg)
+{
+    /* An open ID must never fall below the published watermark */
+    bool ok = true;
+    uint8_t ids[3][16], wm[16];
+    for(size_t i = 0; i < MT_PER_THREAD / 4u; ++i)
+    {
+        const unsigned n = 1u + (unsigned)(i % 3u);
+        for(unsigned k = 0; k < n; ++k) ok &= uuid7_inflight_begin(ids[k]) == 0;
+        uuid7_low_watermark(wm);
+        for(unsigned k = 0; k < n; ++k) ok &= memcmp(wm, ids[k], 8) <= 0;
+        for(unsigned k = n; k-- > 0;) ok &= uuid7_inflight_commit(ids[k]) == 0;
+    }
+    return ok ? arg : NULL;
+}
+
+static void test_inflight_watermark_threads(void** state)
+{
+    (void)state;
+    pthread_t th[MT_THREADS];
+    for(size_t t = 0; t < MT_THREADS; ++t)
+    {
+        assert_int_equal(pthread_create(&th[t], NULL, inflight_writer, (void*)(uintptr_t)(t + 1)), 0);
+    }
+
+    /* Meanwhile the reader side only ever moves forward */
+    uint8_t prev[16] = {0}, wm[16];
+    for(int i = 0; i < 20000; ++i)
+    {
+        assert_int_equal(uuid7_low_watermark(wm), 0);
+        assert_true(memcmp(prev, wm, 8) <= 0);
+        memcpy(prev, wm, 16);
+    }
+    for(size_t t = 0; t < MT_THREADS; ++t)
+    {
+        void* ret = NULL;
+        pthread_join(th[t], &ret);
+        assert_true(ret == (void*)(uintptr_t)(t + 1));
+    }
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -184,6 +786,28 @@ int main(void)
         cmocka_unit_test(test_set_rng_can_reset_to_default),
         cmocka_unit_test(test_init_accepts_custom_rng),
         cmocka_unit_test(test_init_null_leaves_existing_rng),
+        cmocka_unit_test(test_str_ms_decodes_prefix),
+        cmocka_unit_test(test_str_ms_rejects_malformed),
+        cmocka_unit_test(test_gen_v4_sets_version_and_variant),
+        cmocka_unit_test(test_rng_pool_not_shared_across_fork),
+        cmocka_unit_test(test_warmup_installs_default_rng),
+        cmocka_unit_test(test_warmup_keeps_custom_rng),
+        cmocka_unit_test(test_adaptive_config_validation),
+        cmocka_unit_test(test_adaptive_threads_unique_and_ordered),
+        cmocka_unit_test(test_fc_threads_unique_and_ordered),
+        cmocka_unit_test(test_fc_slots_recycled_after_thread_exit),
+        cmocka_unit_test(test_gen_n_blocks_ordered),
+        cmocka_unit_test(test_gen_n_retires_lease),
+        cmocka_unit_test(test_inflight_watermark_follows_commits),
+        cmocka_unit_test(test_inflight_watermark_threads),
+        cmocka_unit_test(test_inflight_under_leasing),
+        cmocka_unit_test(test_str_round_trip),
+        cmocka_unit_test(test_time_str_matches_gmtime),
+        cmocka_unit_test(test_from_str_rejects_malformed),
+        /* These move the state far past the real clock: keep them last */
+        cmocka_unit_test(test_set_clock_drives_timestamp),
+        cmocka_unit_test(test_clock_backward_jump_stays_monotonic),
+        cmocka_unit_test(test_adaptive_switches_and_stays_monotonic),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -0,0 +1,258 @@
+#include "uuid7_age.h"
+#include "uuid7_sim.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "test_common.h"
+
+#define NOW_MS    (T0_MS + 200000u)
+#define N_AGES    100000u
+#define N_THREADS 4u
+#define N_PER     20000u
+
+static uint8_t g_ids[N_AGES][16];
+static uint64_t g_counts[UUID7_AGE_BUCKETS];
+
+static uuid7_age_t* make_age(void)
+{
+    uuid7_age_config_t cfg;
+    uuid7_age_config_init(&cfg);
+    cfg.clock_fn = test_clock;
+    atomic_store(&g_clock, NOW_MS);
+    return uuid7_age_create(&cfg);
+}
+
+/* IDs of ages 0 .. N_AGES - 1 ms, oldest first, one per ms */
+static void fill_ages(void)
+{
+    uuid7_sim_t sim;
+    uuid7_sim_init(&sim, 1u, NOW_MS - (N_AGES - 1u));
+    for(size_t i = 0; i < N_AGES; ++i)
+    {
+        uuid7_sim_gen(&sim, g_ids[i]);
+        uuid7_sim_advance(&sim, 1u);
+    }
+}
+
+static void assert_close(uint64_t got, uint64_t want)
+{
+    const uint64_t err = got > want ? got - want : want - got;
+    assert_true(err * 100u <= want);
+}
+
+static void test_quantiles_within_one_percent(void** state)
+{
+    (void)state;
+    fill_ages();
+    uuid7_age_t* age = make_age();
+    assert_non_null(age);
+
+    assert_int_equal(uuid7_age_record_n(age, &g_ids[0][0], N_AGES), 0);
+    uuid7_age_stats_t st;
+    assert_int_equal(uuid7_age_get_stats(age, &st), 0);
+    assert_int_equal(st.count, N_AGES);
+    assert_int_equal(st.future, 0u);
+
+    /* Ages are uniform over [0, N_AGES): the q quantile is q * (N_AGES - 1) */
+    assert_close(st.p50_ms, N_AGES / 2u);
+    assert_close(st.p99_ms, N_AGES * 99u / 100u);
+    assert_close(st.p999_ms, N_AGES * 999u / 1000u);
+    assert_true(st.max_ms >= N_AGES - 1u);
+    assert_close(st.max_ms, N_AGES - 1u);
+
+    uint64_t ms = 0;
+    assert_int_equal(uuid7_age_quantile(age, 0.5, &ms), 0);
+    assert_int_equal(ms, st.p50_ms);
+    assert_int_equal(uuid7_age_quantile(age, 0.0, &ms), 0);
+    assert_int_equal(ms, 0u);
+    assert_int_equal(uuid7_age_quantile(age, 0.001, &ms), 0);
+    assert_int_equal(ms, 99u); /* exact below 128 ms */
+    uuid7_age_destroy(age);
+}
+
+static void test_single_batch_and_future_ids(void** state)
+{
+    (void)state;
+    fill_ages();
+    uuid7_age_t* one = make_age();
+    uuid7_age_t* batch = make_age();
+    assert_non_null(one);
+    assert_non_null(batch);
+
+    /* Runs of IDs in one ms, as a generator issues them */
+    uuid7_sim_t sim;
+    uuid7_sim_init(&sim, 2u, NOW_MS - 500u);
+    uint8_t ids[600][16];
+    for(size_t i = 0; i < 600u; ++i)
+    {
+        if(i % 7u == 0) uuid7_sim_advance(&sim, 10u + i % 3u);
+        uuid7_sim_gen(&sim, ids[i]);
+    }
+    for(size_t i = 0; i < 600u; ++i) assert_int_equal(uuid7_age_record(one, ids[i]), 0);
+    assert_int_equal(uuid7_age_record_n(batch, &ids[0][0], 600u), 0);
+
+    uint64_t counts[UUID7_AGE_BUCKETS];
+    assert_int_equal(uuid7_age_export(one, g_counts, NULL, 0), 0);
+    assert_int_equal(uuid7_age_export(batch, counts, NULL, 0), 0);
+    assert_memory_equal(counts, g_counts, sizeof(counts));
+
+    /* The tail of the stream is ahead of the clock: counted as age 0 */
+    uuid7_age_stats_t st;
+    assert_int_equal(uuid7_age_get_stats(batch, &st), 0);
+    assert_int_equal(st.count, 600u);
+    assert_true(st.future > 0u);
+    assert_int_equal(counts[0], st.future);
+
+    /* A caller-supplied clock gives the same ages as the configured one */
+    assert_int_equal(uuid7_age_record_at(one, &ids[0][0], 600u, NOW_MS), 0);
+    assert_int_equal(uuid7_age_export(one, g_counts, NULL, 0), 0);
+    for(uint32_t b = 0; b < UUID7_AGE_BUCKETS; ++b) assert_int_equal(g_counts[b], 2u * counts[b]);
+
+    uuid7_age_destroy(one);
+    uuid7_age_destroy(batch);
+}
+
+static void test_merge_export_import(void** state)
+{
+    (void)state;
+    fill_ages();
+    uuid7_age_t* a = make_age();
+    uuid7_age_t* b = make_age();
+    uuid7_age_t* all = make_age();
+    assert_non_null(a);
+    assert_non_null(b);
+    assert_non_null(all);
+
+    assert_int_equal(uuid7_age_record_n(a, &g_ids[0][0], N_AGES / 2u), 0);
+    assert_int_equal(uuid7_age_record_n(b, g_ids[N_AGES / 2u], N_AGES / 2u), 0);
+    assert_int_equal(uuid7_age_record_n(all, &g_ids[0][0], N_AGES), 0);
+
+    /* a + b equals the sketch of the whole stream */
+    assert_int_equal(uuid7_age_merge(a, b), 0);
+    uint64_t counts[UUID7_AGE_BUCKETS];
+    uint64_t future = 0;
+    assert_int_equal(uuid7_age_export(a, counts, &future, 0), 0);
+    assert_int_equal(uuid7_age_export(all, g_counts, NULL, 0), 0);
+    assert_memory_equal(counts, g_counts, sizeof(counts));
+
+    /* Export with reset empties the sketch; import restores it */
+    assert_int_equal(uuid7_age_export(a, counts, &future, 1), 0);
+    uuid7_age_stats_t st;
+    assert_int_equal(uuid7_age_get_stats(a, &st), 0);
+    assert_int_equal(st.count, 0u);
+    assert_int_equal(st.p50_ms, 0u);
+    uint64_t ms = 0;
+    assert_int_equal(uuid7_age_quantile(a, 0.5, &ms), -1);
+    assert_int_equal(uuid7_age_import(a, counts, future), 0);
+    assert_int_equal(uuid7_age_export(a, counts, NULL, 0), 0);
+    assert_memory_equal(counts, g_counts, sizeof(counts));
+
+    /* IDs ahead of the clock travel with the counts, and a reset without
+     * an out-param for them keeps them */
+    uint8_t ahead[16];
+    set_ms(ahead, NOW_MS + 1000u);
+    assert_int_equal(uuid7_age_record(a, ahead), 0);
+    assert_int_equal(uuid7_age_export(a, counts, NULL, 1), 0);
+    assert_int_equal(uuid7_age_get_stats(a, &st), 0);
+    assert_int_equal(st.future, 1u);
+    assert_int_equal(uuid7_age_export(a, counts, &future, 1), 0);
+    assert_int_equal(future, 1u);
+    assert_int_equal(uuid7_age_get_stats(a, &st), 0);
+    assert_int_equal(st.future, 0u);
+    assert_int_equal(uuid7_age_import(b, counts, future), 0);
+    assert_int_equal(uuid7_age_get_stats(b, &st), 0);
+    assert_int_equal(st.future, 1u);
+
+    assert_int_equal(uuid7_age_merge(a, a), -1);
+    uuid7_age_destroy(a);
+    uuid7_age_destroy(b);
+    uuid7_age_destroy(all);
+}
+
+static uuid7_age_t* g_shared;
+
+static void* recorder(void* arg)
+{
+    const size_t t = (size_t)arg;
+    for(size_t i = 0; i < N_PER; i += 100u)
+    {
+        if(uuid7_age_record_n(g_shared, g_ids[(t * N_PER + i) % N_AGES], 100u) != 0) return (void*)1;
+    }
+    return NULL;
+}
+
+static void test_concurrent_recorders(void** state)
+{
+    (void)state;
+    fill_ages();
+    uuid7_age_config_t cfg;
+    uuid7_age_config_init(&cfg);
+    cfg.shards = 2u; /* fewer shards than threads: shared counters */
+    cfg.clock_fn = test_clock;
+    g_shared = uuid7_age_create(&cfg);
+    assert_non_null(g_shared);
+
+    pthread_t th[N_THREADS];
+    for(size_t t = 0; t < N_THREADS; ++t)
+    {
+        assert_int_equal(pthread_create(&th[t], NULL, recorder, (void*)t), 0);
+    }
+    for(size_t t = 0; t < N_THREADS; ++t)
+    {
+        void* ret = NULL;
+        pthread_join(th[t], &ret);
+        assert_null(ret);
+    }
+
+    uuid7_age_stats_t st;
+    assert_int_equal(uuid7_age_get_stats(g_shared, &st), 0);
+    assert_int_equal(st.count, N_THREADS * N_PER);
+    uuid7_age_destroy(g_shared);
+}
+
+static void test_config_limits(void** state)
+{
+    (void)state;
+    uuid7_age_config_t cfg;
+    uuid7_age_config_init(&cfg);
+    assert_int_equal(cfg.shards, 16u);
+    cfg.shards = 0u;
+    assert_null(uuid7_age_create(&cfg));
+    cfg.shards = 257u;
+    assert_null(uuid7_age_create(&cfg));
+
+    uuid7_age_t* age = make_age();
+    assert_non_null(age);
+    uint64_t ms = 0;
+    uint8_t id[16] = {0};
+    assert_int_equal(uuid7_age_quantile(age, 1.5, &ms), -1);
+
+    /* An all-zero ID is 55 years old: clamped into the last bucket */
+    assert_int_equal(uuid7_age_record(age, id), 0);
+    assert_int_equal(uuid7_age_quantile(age, 1.0, &ms), 0);
+    assert_true(ms > (1ull << 39));
+    uuid7_age_destroy(age);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_quantiles_within_one_percent),
+        cmocka_unit_test(test_single_batch_and_future_ids),
+        cmocka_unit_test(test_merge_export_import),
+        cmocka_unit_test(test_concurrent_recorders),
+        cmocka_unit_test(test_config_limits),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,288 @@
+#include "uuid7_arena.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "test_common.h"
+
+#define BUCKET_MS 100u
+#define CHUNK     8192u
+#define N_THREADS 4u
+
+static _Atomic bool g_stop;
+static uuid7_arena_t* g_shared;
+
+static uuid7_arena_t* make_arena(uint32_t max_windows, uint32_t spare)
+{
+    uuid7_arena_config_t cfg;
+    uuid7_arena_config_init(&cfg);
+    cfg.bucket_ms = BUCKET_MS;
+    cfg.chunk_size = CHUNK;
+    cfg.max_windows = max_windows;
+    cfg.spare_chunks = spare;
+    cfg.clock_fn = test_clock;
+    atomic_store(&g_clock, T0_MS);
+    return uuid7_arena_create(&cfg);
+}
+
+static void test_alloc_places_objects_by_window(void** state)
+{
+    (void)state;
+    uuid7_arena_t* a = make_arena(64u, 0u);
+    assert_non_null(a);
+
+    /* 10 windows x 100 objects of 40 bytes: several chunks per window */
+    uint8_t id[16];
+    uint8_t* first[10];
+    for(uint64_t w = 0; w < 10u; ++w)
+    {
+        for(int i = 0; i < 100; ++i)
+        {
+            set_ms(id, T0_MS + w * BUCKET_MS + (uint64_t)i % BUCKET_MS);
+            uint8_t* p = uuid7_arena_alloc(a, id, 40u);
+            assert_non_null(p);
+            assert_int_equal((uintptr_t)p % UUID7_ARENA_ALIGN, 0u);
+            memset(p, (int)w, 40u);
+            if(i == 0) first[w] = p;
+        }
+    }
+    for(uint64_t w = 0; w < 10u; ++w) assert_int_equal(first[w][39], w);
+
+    uuid7_arena_stats_t st;
+    assert_int_equal(uuid7_arena_get_stats(a, &st), 0);
+    assert_int_equal(st.bytes, 1000u * 48u);
+    assert_int_equal(st.windows, 10u);
+    assert_int_equal(st.chunks, 10u); /* 4800 bytes fit one 8 KiB chunk */
+    assert_int_equal(st.rejected, 0u);
+
+    /* Larger than a chunk: a dedicated chunk, the current one is kept */
+    set_ms(id, T0_MS);
+    uint8_t* big = uuid7_arena_alloc(a, id, 3u * CHUNK);
+    assert_non_null(big);
+    memset(big, 1, 3u * CHUNK);
+    uint8_t* small = uuid7_arena_alloc(a, id, 16u);
+    assert_ptr_equal(small, first[0] + 100u * 48u);
+    assert_int_equal(uuid7_arena_get_stats(a, &st), 0);
+    assert_int_equal(st.chunks, 11u);
+
+    /* Filling a window rolls over to new chunks */
+    for(int i = 0; i < 1000; ++i) assert_non_null(uuid7_arena_alloc(a, id, 100u));
+    assert_int_equal(uuid7_arena_get_stats(a, &st), 0);
+    assert_true(st.chunks >= 11u + 1000u * 112u / CHUNK);
+    uuid7_arena_destroy(a);
+}
+
+static void test_release_windows_wholesale(void** state)
+{
+    (void)state;
+    uuid7_arena_t* a = make_arena(64u, 2u);
+    assert_non_null(a);
+
+    uint8_t id[16];
+    for(uint64_t w = 0; w < 10u; ++w)
+    {
+        set_ms(id, T0_MS + w * BUCKET_MS);
+        assert_non_null(uuid7_arena_alloc(a, id, 64u));
+    }
+    uuid7_arena_stats_t st;
+    assert_int_equal(uuid7_arena_get_stats(a, &st), 0);
+    assert_int_equal(st.mapped_bytes, 10u * CHUNK);
+
+    /* Windows 0..4 end at or before T0 + 500 */
+    assert_int_equal(uuid7_arena_release(a, T0_MS + 5u * BUCKET_MS + 50u), 5u);
+    assert_int_equal(uuid7_arena_release(a, T0_MS + 5u * BUCKET_MS), 0u);
+    assert_int_equal(uuid7_arena_get_stats(a, &st), 0);
+    assert_int_equal(st.windows, 5u);
+    assert_int_equal(st.released, 5u);
+    assert_int_equal(st.chunks, 5u);
+    assert_int_equal(st.mapped_bytes, 7u * CHUNK); /* two kept as spares */
+
+    /* Released windows refuse allocations; new windows reuse the spares */
+    set_ms(id, T0_MS + 2u * BUCKET_MS);
+    assert_null(uuid7_arena_alloc(a, id, 64u));
+    set_ms(id, T0_MS + 20u * BUCKET_MS);
+    assert_non_null(uuid7_arena_alloc(a, id, 64u));
+    set_ms(id, T0_MS + 21u * BUCKET_MS);
+    assert_non_null(uuid7_arena_alloc(a, id, 64u));
+    assert_int_equal(uuid7_arena_get_stats(a, &st), 0);
+    assert_int_equal(st.rejected, 1u);
+    assert_int_equal(st.mapped_bytes, 7u * CHUNK);
+
+    /* A window sharing its slot with a live one is refused */
+    set_ms(id, T0_MS + (20u + 64u) * BUCKET_MS);
+    assert_null(uuid7_arena_alloc(a, id, 64u));
+    assert_int_equal(uuid7_arena_release(a, UINT64_MAX), 7u);
+    assert_int_equal(uuid7_arena_get_stats(a, &st), 0);
+    assert_int_equal(st.windows, 0u);
+    assert_int_equal(st.mapped_bytes, 2u * CHUNK);
+    uuid7_arena_destroy(a);
+}
+
+static void test_retain_and_gen(void** state)
+{
+    (void)state;
+    uuid7_arena_config_t cfg;
+    uuid7_arena_config_init(&cfg);
+    cfg.bucket_ms = BUCKET_MS;
+    cfg.chunk_size = CHUNK;
+    cfg.spare_chunks = 0u;
+    cfg.retain_ms = 1000u;
+    cfg.clock_fn = test_clock;
+    atomic_store(&g_clock, T0_MS);
+    uuid7_arena_t* a = uuid7_arena_create(&cfg);
+    assert_non_null(a);
+
+    /* One window per 100 ms of clock; mapping the next chunk releases
+     * windows older than a second */
+    uint8_t id[16];
+    for(uint64_t t = 0; t < 30u; ++t)
+    {
+        atomic_store(&g_clock, T0_MS + t * BUCKET_MS);
+        set_ms(id, T0_MS + t * BUCKET_MS);
+        assert_non_null(uuid7_arena_alloc(a, id, 32u));
+    }
+    uuid7_arena_stats_t st;
+    assert_int_equal(uuid7_arena_get_stats(a, &st), 0);
+    assert_int_equal(st.released, 19u); /* windows ending by T0 + 1900 */
+    assert_int_equal(st.windows, 11u);
+    assert_int_equal(st.mapped_bytes, 11u * CHUNK);
+    uuid7_arena_destroy(a);
+
+    /* gen: the ID is fresh and its object lives in the current window */
+    a = make_arena(64u, 0u);
+    assert_non_null(a);
+    uint8_t* p = uuid7_arena_gen(a, id, 24u);
+    assert_non_null(p);
+    memset(p, 0, 24u);
+    assert_int_equal(id[6] >> 4, 7);
+    assert_int_equal(uuid7_arena_get_stats(a, &st), 0);
+    assert_int_equal(st.windows, 1u);
+    uuid7_arena_destroy(a);
+}
+
+/* The application's side of release: a thread pins the ms it works in,
+ * and the releaser waits for pinned ms below the release point (Dekker
+ * style, both sides store then load) */
+static _Atomic uint64_t g_pinned[N_THREADS];
+static _Atomic uint64_t g_release_point;
+
+static void* allocator(void* arg)
+{
+    const size_t t = (size_t)arg;
+    const uint8_t tag = (uint8_t)(t + 1u);
+    uint8_t id[16];
+    size_t n = 0;
+    while(!atomic_load(&g_stop) || n < 1000u)
+    {
+        const uint64_t ms = atomic_load(&g_clock);
+        atomic_store(&g_pinned[t], ms);
+        if(ms >= atomic_load(&g_release_point))
+        {
+            set_ms(id, ms);
+            uint8_t* p = uuid7_arena_alloc(g_shared, id, 48u);
+            if(p)
+            {
+                memset(p, tag, 48u);
+                for(int i = 0; i < 48; ++i)
+                {
+                    if(p[i] != tag) return (void*)1;
+                }
+                ++n;
+            }
+        }
+        atomic_store(&g_pinned[t], UINT64_MAX);
+    }
+    return NULL;
+}
+
+static void test_concurrent_alloc_and_release(void** state)
+{
+    (void)state;
+    g_shared = make_arena(256u, 4u);
+    assert_non_null(g_shared);
+    atomic_store(&g_stop, false);
+    atomic_store(&g_release_point, 0u);
+    for(size_t t = 0; t < N_THREADS; ++t) atomic_store(&g_pinned[t], UINT64_MAX);
+
+    pthread_t th[N_THREADS];
+    for(size_t t = 0; t < N_THREADS; ++t)
+    {
+        assert_int_equal(pthread_create(&th[t], NULL, allocator, (void*)t), 0);
+    }
+    for(int step = 0; step < 2000; ++step)
+    {
+        const uint64_t now = atomic_fetch_add(&g_clock, 7u) + 7u;
+        const uint64_t point = now - 3u * BUCKET_MS;
+        atomic_store(&g_release_point, point);
+        for(size_t t = 0; t < N_THREADS; ++t)
+        {
+            while(atomic_load(&g_pinned[t]) < point) sched_yield();
+        }
+        uuid7_arena_release(g_shared, point);
+    }
+    atomic_store(&g_stop, true);
+    for(size_t t = 0; t < N_THREADS; ++t)
+    {
+        void* ret = NULL;
+        pthread_join(th[t], &ret);
+        assert_null(ret);
+    }
+
+    uuid7_arena_stats_t st;
+    assert_int_equal(uuid7_arena_get_stats(g_shared, &st), 0);
+    assert_true(st.windows >= 1u && st.windows <= 5u);
+    assert_true(st.bytes >= 48u);
+    uuid7_arena_release(g_shared, UINT64_MAX);
+    assert_int_equal(uuid7_arena_get_stats(g_shared, &st), 0);
+    assert_true(st.mapped_bytes <= 4u * CHUNK);
+    uuid7_arena_destroy(g_shared);
+}
+
+static void test_config_limits(void** state)
+{
+    (void)state;
+    uuid7_arena_config_t cfg;
+    uuid7_arena_config_init(&cfg);
+    assert_int_equal(cfg.bucket_ms, 1000u);
+    assert_int_equal(cfg.chunk_size, 1u << 20);
+    uuid7_arena_config_t bad = cfg;
+    bad.bucket_ms = 0u;
+    assert_null(uuid7_arena_create(&bad));
+    bad = cfg;
+    bad.chunk_size = 1024u;
+    assert_null(uuid7_arena_create(&bad));
+    bad = cfg;
+    bad.max_windows = 0u;
+    assert_null(uuid7_arena_create(&bad));
+
+    /* A zero-size object still gets a distinct address */
+    uuid7_arena_t* a = make_arena(4u, 0u);
+    assert_non_null(a);
+    uint8_t id[16];
+    set_ms(id, T0_MS);
+    assert_non_null(uuid7_arena_alloc(a, id, 0u));
+    uuid7_arena_destroy(a);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_alloc_places_objects_by_window),
+        cmocka_unit_test(test_release_windows_wholesale),
+        cmocka_unit_test(test_retain_and_gen),
+        cmocka_unit_test(test_concurrent_alloc_and_release),
+        cmocka_unit_test(test_config_limits),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,170 @@
+#include "uuid7_dict.h"
+#include "uuid7_sim.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+/* 2025-01-01T00:00:00Z */
+#define T0_MS    1735689600000ull
+#define N_KEYS   5000u
+#define N_COLUMN 100003u /* not a multiple of the decode step */
+
+static uint8_t g_keys[N_KEYS][16];
+static uint8_t g_column[N_COLUMN][16];
+static uint8_t g_back[N_COLUMN][16];
+
+/* Distinct IDs in ascending order, a few per virtual ms */
+static void fill_keys(uint64_t seed)
+{
+    uuid7_sim_t sim;
+    uuid7_sim_init(&sim, seed, T0_MS);
+    for(size_t i = 0; i < N_KEYS; ++i)
+    {
+        if(i % 3u == 0) uuid7_sim_advance(&sim, 1u);
+        uuid7_sim_gen(&sim, g_keys[i]);
+    }
+}
+
+static uint32_t next_rand(uint32_t* x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+static void test_round_trip_random_column(void** state)
+{
+    (void)state;
+    fill_keys(1u);
+
+    /* FK-like column: random picks among the first 1000 keys, in runs */
+    uint32_t x = 2463534242u;
+    for(size_t i = 0; i < N_COLUMN;)
+    {
+        const uint32_t pick = next_rand(&x) % 1000u;
+        for(uint32_t run = 1u + next_rand(&x) % 4u; run-- > 0 && i < N_COLUMN; ++i)
+        {
+            memcpy(g_column[i], g_keys[pick], 16);
+        }
+    }
+
+    uuid7_dict_t* d = uuid7_dict_build(&g_column[0][0], N_COLUMN);
+    assert_non_null(d);
+    assert_int_equal(uuid7_dict_size(d), 1000u);
+    assert_int_equal(uuid7_dict_bits(d), 10u); /* straddles word boundaries */
+    assert_memory_equal(uuid7_dict_entries(d), g_keys, 1000u * 16u);
+
+    const size_t words = uuid7_dict_packed_words(d, N_COLUMN);
+    assert_int_equal(words, (N_COLUMN * 10u + 63u) / 64u);
+    uint64_t* packed = calloc(words, sizeof(*packed));
+    assert_non_null(packed);
+    assert_int_equal(uuid7_dict_encode(d, &g_column[0][0], N_COLUMN, packed), 0);
+    assert_int_equal(uuid7_dict_decode(d, packed, N_COLUMN, &g_back[0][0]), 0);
+    assert_memory_equal(g_back, g_column, sizeof(g_column));
+
+    uint32_t index = 0;
+    assert_int_equal(uuid7_dict_find(d, g_keys[777], &index), 0);
+    assert_int_equal(index, 777u);
+    assert_int_equal(uuid7_dict_find(d, g_keys[1000], &index), -1);
+
+    /* An ID outside the dictionary cannot be encoded */
+    assert_int_equal(uuid7_dict_encode(d, g_keys[1000], 1u, packed), -1);
+
+    /* Corrupt input: index 1023 is beyond the 1000 entries */
+    packed[0] |= 0x3FFu;
+    assert_int_equal(uuid7_dict_decode(d, packed, N_COLUMN, &g_back[0][0]), -1);
+    free(packed);
+    uuid7_dict_destroy(d);
+}
+
+static void test_build_orders_out_of_order_input(void** state)
+{
+    (void)state;
+    fill_keys(2u);
+
+    /* Descending, then every key again: exercises pending merges, and the
+     * second half must be found in the merged dictionary */
+    for(size_t i = 0; i < N_KEYS; ++i) memcpy(g_column[i], g_keys[N_KEYS - 1u - i], 16);
+    for(size_t i = 0; i < N_KEYS; ++i) memcpy(g_column[N_KEYS + i], g_keys[(i * 7u) % N_KEYS], 16);
+
+    uuid7_dict_t* d = uuid7_dict_build(&g_column[0][0], 2u * N_KEYS);
+    assert_non_null(d);
+    assert_int_equal(uuid7_dict_size(d), N_KEYS);
+    assert_int_equal(uuid7_dict_bits(d), 13u);
+    assert_memory_equal(uuid7_dict_entries(d), g_keys, sizeof(g_keys));
+
+    /* Stored entries reload into the same dictionary */
+    uuid7_dict_t* again = uuid7_dict_load(uuid7_dict_entries(d), uuid7_dict_size(d));
+    assert_non_null(again);
+    assert_int_equal(uuid7_dict_size(again), N_KEYS);
+    uint64_t packed[8] = {0};
+    uint8_t out[5][16];
+    assert_int_equal(uuid7_dict_encode(d, g_keys[4000], 1u, packed), 0);
+    assert_int_equal(uuid7_dict_decode(again, packed, 1u, out[0]), 0);
+    assert_memory_equal(out[0], g_keys[4000], 16);
+    uuid7_dict_destroy(again);
+    uuid7_dict_destroy(d);
+
+    /* Load refuses unsorted or duplicate entries */
+    memcpy(out[0], g_keys[1], 16);
+    memcpy(out[1], g_keys[0], 16);
+    assert_null(uuid7_dict_load(&out[0][0], 2u));
+    memcpy(out[1], g_keys[1], 16);
+    assert_null(uuid7_dict_load(&out[0][0], 2u));
+}
+
+static void test_small_dictionaries_and_bad_args(void** state)
+{
+    (void)state;
+    fill_keys(3u);
+
+    /* One distinct value still takes one bit per row */
+    uint8_t column[5][16];
+    for(int i = 0; i < 5; ++i) memcpy(column[i], g_keys[9], 16);
+    uuid7_dict_t* d = uuid7_dict_build(&column[0][0], 5u);
+    assert_non_null(d);
+    assert_int_equal(uuid7_dict_size(d), 1u);
+    assert_int_equal(uuid7_dict_bits(d), 1u);
+    assert_int_equal(uuid7_dict_packed_words(d, 5u), 1u);
+    uint64_t packed[1] = {~0ull};
+    assert_int_equal(uuid7_dict_encode(d, &column[0][0], 5u, packed), 0);
+    assert_int_equal(packed[0], 0u);
+    uint8_t back[5][16];
+    assert_int_equal(uuid7_dict_decode(d, packed, 5u, &back[0][0]), 0);
+    assert_memory_equal(back, column, sizeof(column));
+    uuid7_dict_destroy(d);
+
+    /* Empty column: an empty dictionary that decodes nothing */
+    d = uuid7_dict_build(NULL, 0u);
+    assert_non_null(d);
+    assert_int_equal(uuid7_dict_size(d), 0u);
+    assert_int_equal(uuid7_dict_decode(d, packed, 0u, &back[0][0]), 0);
+    assert_int_equal(uuid7_dict_decode(d, packed, 1u, &back[0][0]), -1);
+    uuid7_dict_destroy(d);
+
+    assert_null(uuid7_dict_build(NULL, 1u));
+    assert_null(uuid7_dict_load(NULL, 1u));
+    assert_int_equal(uuid7_dict_encode(NULL, &column[0][0], 1u, packed), -1);
+    assert_int_equal(uuid7_dict_find(NULL, column[0], NULL), -1);
+    assert_int_equal(uuid7_dict_size(NULL), 0u);
+    uuid7_dict_destroy(NULL);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_round_trip_random_column),
+        cmocka_unit_test(test_build_orders_out_of_order_input),
+        cmocka_unit_test(test_small_dictionaries_and_bad_args),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,127 @@
+#include "uuid7.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+static_assert(std::ranges::input_range<uuid7::basic_stream<>>);
+static_assert(std::ranges::random_access_range<uuid7::basic_split<>>);
+static_assert(std::ranges::sized_range<uuid7::basic_split<>>);
+
+static bool is_v7(const uuid7::id& id)
+{
+    return (id[6] >> 4) == 7 && (id[8] & 0xC0u) == 0x80u;
+}
+
+static bool ordered(const std::vector<uuid7::id>& ids)
+{
+    for(size_t i = 1; i < ids.size(); ++i)
+    {
+        if(std::memcmp(ids[i - 1].data(), ids[i].data(), 8) >= 0) return false;
+    }
+    return true;
+}
+
+static void test_stream_crosses_chunks(void** state)
+{
+    (void)state;
+    std::vector<uuid7::id> ids;
+    for(const uuid7::id& id : uuid7::stream(1000u)) ids.push_back(id);
+    assert_int_equal(ids.size(), 1000u);
+    assert_true(ordered(ids));
+    assert_true(std::all_of(ids.begin(), ids.end(), is_v7));
+
+    /* A chunk that does not divide the count; post-increment yields the ID */
+    uuid7::basic_stream<7> s(20u);
+    auto it = s.begin();
+    uuid7::id last = *it;
+    assert_true(it++ == last);
+    size_t n = 1;
+    for(; it != s.end(); ++it, ++n)
+    {
+        assert_true(std::memcmp(last.data(), it->data(), 8) < 0);
+        last = *it;
+    }
+    assert_int_equal(n, 20u);
+    assert_int_equal(s.size(), 0u);
+
+    auto empty = uuid7::stream(0u);
+    assert_true(empty.begin() == empty.end());
+}
+
+static void test_ranges_algorithms(void** state)
+{
+    (void)state;
+    std::vector<uuid7::id> ids(300u);
+    std::ranges::copy(uuid7::stream(ids.size()), ids.begin());
+    assert_true(ordered(ids));
+
+    std::vector<uuid7::id> few;
+    std::ranges::copy(uuid7::stream(1000u) | std::views::take(5), std::back_inserter(few));
+    assert_int_equal(few.size(), 5u);
+    assert_true(ordered(few));
+}
+
+static void test_split_parallel_fill(void** state)
+{
+    (void)state;
+    const size_t n = 10007u;
+    auto parts = uuid7::split(n, 8u);
+    assert_int_equal(parts.size(), 8u);
+
+    /* Parts tile [0, n) in order */
+    size_t at = 0;
+    for(auto s : parts)
+    {
+        assert_int_equal(s.offset(), at);
+        at += s.size();
+    }
+    assert_int_equal(at, n);
+    assert_int_equal(parts.part(7u).offset(), n - parts.part(7u).size());
+    assert_int_equal(parts.end() - parts.begin(), 8);
+
+    /* One thread per part, each filling its own slice */
+    std::vector<uuid7::id> out(n);
+    std::vector<std::thread> th;
+    for(auto it = parts.begin(); it != parts.end(); ++it)
+    {
+        th.emplace_back([&out, it] {
+            auto s = *it;
+            std::copy(s.begin(), s.end(), out.begin() + static_cast<std::ptrdiff_t>(s.offset()));
+        });
+    }
+    for(auto& t : th) t.join();
+
+    for(auto s : parts)
+    {
+        const auto first = out.begin() + static_cast<std::ptrdiff_t>(s.offset());
+        assert_true(ordered(std::vector<uuid7::id>(first, first + static_cast<std::ptrdiff_t>(s.size()))));
+    }
+    std::sort(out.begin(), out.end());
+    assert_true(std::adjacent_find(out.begin(), out.end()) == out.end());
+    assert_true(std::all_of(out.begin(), out.end(), is_v7));
+
+    /* Never more parts than IDs, never zero parts */
+    assert_int_equal(uuid7::split(3u, 8u).size(), 3u);
+    assert_int_equal(uuid7::split(5u, 0u).size(), 1u);
+    assert_int_equal(uuid7::split(5u, 0u).part(0u).size(), 5u);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_stream_crosses_chunks),
+        cmocka_unit_test(test_ranges_algorithms),
+        cmocka_unit_test(test_split_parallel_fill),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
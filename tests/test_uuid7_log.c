@@ -0,0 +1,342 @@
+#include "uuid7_log.h"
+#include "uuid7.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "test_common.h"
+
+#define N_THREADS  4u
+#define PER_THREAD 20000u
+#define N_APPENDS  100u
+
+static uuid7_log_t* make_log(uint32_t seg_records, uint32_t max_segments, uint64_t retain_ms)
+{
+    uuid7_log_config_t cfg;
+    uuid7_log_config_init(&cfg);
+    cfg.record_size = sizeof(uint64_t);
+    cfg.segment_records = seg_records;
+    cfg.max_segments = max_segments;
+    cfg.retain_ms = retain_ms;
+    cfg.clock_fn = test_clock;
+    atomic_store(&g_clock, T0_MS);
+    return uuid7_log_create(&cfg);
+}
+
+static uint8_t g_ids[N_APPENDS][16];
+
+/* Appends 0..N_APPENDS-1, three per virtual ms */
+static void fill(uuid7_log_t* log)
+{
+    for(uint64_t i = 0; i < N_APPENDS; ++i)
+    {
+        if(i % 3u == 0) atomic_fetch_add(&g_clock, 1u);
+        assert_int_equal(uuid7_log_append(log, &i, g_ids[i]), 0);
+    }
+}
+
+static void test_append_read_in_order(void** state)
+{
+    (void)state;
+    uuid7_log_t* log = make_log(8u, 64u, 0u);
+    assert_non_null(log);
+    fill(log);
+
+    uuid7_log_cursor_t cur;
+    assert_int_equal(uuid7_log_since(log, NULL, &cur), 0);
+    uint8_t ids[N_APPENDS][16];
+    uint64_t recs[N_APPENDS];
+    assert_int_equal(uuid7_log_read(log, &cur, UINT64_MAX, &ids[0][0], recs, 7u), 7u);
+    assert_int_equal(uuid7_log_read(log, &cur, UINT64_MAX, &ids[7][0], &recs[7], N_APPENDS), N_APPENDS - 7u);
+    assert_int_equal(uuid7_log_read(log, &cur, UINT64_MAX, &ids[0][0], recs, N_APPENDS), 0u);
+
+    assert_int_equal(uuid7_log_since(log, NULL, &cur), 0);
+    assert_int_equal(uuid7_log_read(log, &cur, UINT64_MAX, &ids[0][0], recs, N_APPENDS), N_APPENDS);
+    for(uint64_t i = 0; i < N_APPENDS; ++i)
+    {
+        assert_memory_equal(ids[i], g_ids[i], 16);
+        assert_int_equal(recs[i], i);
+        assert_int_equal(ids[i][6] >> 4, 7);
+        assert_int_equal(ids[i][8] & 0xC0u, 0x80u);
+        if(i > 0) assert_true(memcmp(ids[i - 1], ids[i], 16) < 0);
+    }
+    assert_int_equal(id_ms(ids[0]), T0_MS + 1u);
+
+    uuid7_log_stats_t st;
+    assert_int_equal(uuid7_log_get_stats(log, &st), 0);
+    assert_int_equal(st.records, N_APPENDS);
+    assert_int_equal(st.segments, (N_APPENDS + 7u) / 8u);
+    assert_true(st.mapped_bytes > 0);
+    uuid7_log_destroy(log);
+}
+
+static void test_since_id_and_time_range(void** state)
+{
+    (void)state;
+    uuid7_log_t* log = make_log(16u, 64u, 0u);
+    fill(log);
+
+    uuid7_log_cursor_t cur;
+    uint8_t ids[N_APPENDS][16];
+    uint64_t recs[N_APPENDS];
+    for(size_t k = 0; k < N_APPENDS; k += 13u)
+    {
+        assert_int_equal(uuid7_log_since(log, g_ids[k], &cur), 0);
+        assert_int_equal(uuid7_log_read(log, &cur, UINT64_MAX, NULL, recs, N_APPENDS), N_APPENDS - 1u - k);
+        assert_int_equal(recs[0], k + 1u);
+    }
+
+    /* An ID between two records: everything after it */
+    uint8_t mid[16];
+    memcpy(mid, g_ids[40], 16);
+    mid[15] ^= 0x01u;
+    const bool above = memcmp(mid, g_ids[40], 16) > 0;
+    assert_int_equal(uuid7_log_since(log, mid, &cur), 0);
+    assert_int_equal(uuid7_log_read(log, &cur, UINT64_MAX, NULL, recs, N_APPENDS), above ? 59u : 60u);
+
+    /* [T0+5, T0+9): records 12..23 (three per ms from T0+1) */
+    assert_int_equal(uuid7_log_since_ms(log, T0_MS + 5u, &cur), 0);
+    assert_int_equal(uuid7_log_read(log, &cur, T0_MS + 9u, &ids[0][0], recs, N_APPENDS), 12u);
+    assert_int_equal(recs[0], 12u);
+    assert_int_equal(recs[11], 23u);
+    assert_int_equal(id_ms(ids[11]), T0_MS + 8u);
+    /* The cursor waits at the bound */
+    assert_int_equal(uuid7_log_read(log, &cur, UINT64_MAX, NULL, recs, 1u), 1u);
+    assert_int_equal(recs[0], 24u);
+
+    /* Past the end, then new appends show up */
+    assert_int_equal(uuid7_log_since(log, g_ids[N_APPENDS - 1u], &cur), 0);
+    assert_int_equal(uuid7_log_read(log, &cur, UINT64_MAX, NULL, recs, N_APPENDS), 0u);
+    const uint64_t extra = 777u;
+    uint8_t id[16];
+    assert_int_equal(uuid7_log_append(log, &extra, id), 0);
+    assert_int_equal(uuid7_log_read(log, &cur, UINT64_MAX, ids[0], recs, N_APPENDS), 1u);
+    assert_memory_equal(ids[0], id, 16);
+    assert_int_equal(recs[0], extra);
+    uuid7_log_destroy(log);
+}
+
+static void test_search_large_segment(void** state)
+{
+    (void)state;
+    uuid7_log_t* log = make_log(8192u, 4u, 0u);
+    enum { N = 6000 };
+    static uint8_t ids[N][16];
+    for(uint64_t i = 0; i < N; ++i)
+    {
+        /* Bursty time: uneven, so interpolation has to correct itself */
+        if(i % 97u == 0) atomic_fetch_add(&g_clock, 1u + (i / 97u) % 5u * 40u);
+        assert_int_equal(uuid7_log_append(log, &i, ids[i]), 0);
+    }
+    uuid7_log_cursor_t cur;
+    uint64_t rec = 0;
+    for(size_t k = 0; k < N; k += 131u)
+    {
+        assert_int_equal(uuid7_log_since(log, ids[k], &cur), 0);
+        if(k + 1u < N)
+        {
+            assert_int_equal(uuid7_log_read(log, &cur, UINT64_MAX, NULL, &rec, 1u), 1u);
+            assert_int_equal(rec, k + 1u);
+        }
+        assert_int_equal(uuid7_log_since_ms(log, id_ms(ids[k]), &cur), 0);
+        assert_int_equal(uuid7_log_read(log, &cur, UINT64_MAX, NULL, &rec, 1u), 1u);
+        assert_true(rec <= k);
+        assert_int_equal(id_ms(ids[rec]), id_ms(ids[k]));
+        assert_true(rec == 0 || id_ms(ids[rec - 1u]) < id_ms(ids[k]));
+    }
+    uuid7_log_destroy(log);
+}
+
+static void test_retire_by_age(void** state)
+{
+    (void)state;
+    uuid7_log_t* log = make_log(4u, 4u, 0u);
+    uint8_t id[16];
+    uint64_t i = 0;
+    for(; i < 16u; ++i)
+    {
+        atomic_fetch_add(&g_clock, 10u);
+        assert_int_equal(uuid7_log_append(log, &i, id), 0);
+    }
+    /* Four full segments: no room to roll */
+    assert_int_equal(uuid7_log_append(log, &i, id), -1);
+
+    uuid7_log_cursor_t old;
+    assert_int_equal(uuid7_log_since(log, NULL, &old), 0);
+
+    uuid7_log_stats_t st;
+    uuid7_log_get_stats(log, &st);
+    const uint64_t mapped = st.mapped_bytes;
+    assert_int_equal(st.rejected, 1u);
+
+    /* Segment 0 ends at T0+40, segment 1 at T0+80 */
+    assert_int_equal(uuid7_log_retire(log, T0_MS + 40u), 0u);
+    assert_int_equal(uuid7_log_retire(log, T0_MS + 81u), 2u);
+    uuid7_log_get_stats(log, &st);
+    assert_int_equal(st.segments, 2u);
+    assert_int_equal(st.retired, 2u);
+    assert_int_equal(st.records, 8u);
+    assert_true(st.mapped_bytes < mapped);
+
+    /* A cursor into retired records resumes at the oldest live one */
+    uint64_t recs[16];
+    assert_int_equal(uuid7_log_read(log, &old, UINT64_MAX, NULL, recs, 16u), 8u);
+    assert_int_equal(recs[0], 8u);
+    assert_int_equal(uuid7_log_append(log, &i, id), 0);
+    uuid7_log_destroy(log);
+}
+
+static void test_auto_retire_and_idle_seal(void** state)
+{
+    (void)state;
+    /* 100 ms retention: a log of two-slot segments keeps going forever */
+    uuid7_log_t* log = make_log(2u, 4u, 100u);
+    uint8_t id[16], prev[16] = {0};
+    for(uint64_t i = 0; i < 1000u; ++i)
+    {
+        atomic_fetch_add(&g_clock, 30u);
+        assert_int_equal(uuid7_log_append(log, &i, id), 0);
+        assert_true(memcmp(prev, id, 16) < 0);
+        memcpy(prev, id, 16);
+    }
+    uuid7_log_stats_t st;
+    uuid7_log_get_stats(log, &st);
+    assert_true(st.retired >= 490u);
+    assert_true(st.segments <= 4u);
+    uuid7_log_destroy(log);
+
+    /* 50 idle days overflow the ms delta: the segment is sealed with holes,
+     * which reads skip, and IDs keep ascending */
+    log = make_log(8u, 8u, 0u);
+    uint8_t a[16], b[16];
+    const uint64_t one = 1u, two = 2u;
+    assert_int_equal(uuid7_log_append(log, &one, a), 0);
+    atomic_fetch_add(&g_clock, 50ull * 86400000u);
+    assert_int_equal(uuid7_log_append(log, &two, b), 0);
+    assert_true(memcmp(a, b, 16) < 0);
+    assert_int_equal(id_ms(b), T0_MS + 50ull * 86400000u);
+
+    uuid7_log_cursor_t cur;
+    uint64_t recs[8];
+    uint8_t ids[8][16];
+    uuid7_log_since(log, NULL, &cur);
+    assert_int_equal(uuid7_log_read(log, &cur, UINT64_MAX, &ids[0][0], recs, 8u), 2u);
+    assert_memory_equal(ids[1], b, 16);
+    assert_int_equal(recs[1], 2u);
+    uuid7_log_since(log, a, &cur);
+    assert_int_equal(uuid7_log_read(log, &cur, UINT64_MAX, NULL, recs, 8u), 1u);
+    assert_int_equal(recs[0], 2u);
+    uuid7_log_destroy(log);
+}
+
+static uuid7_log_t* g_log;
+static _Atomic uint32_t g_done;
+
+static void* appender(void* arg)
+{
+    const uint64_t t = (uint64_t)(uintptr_t)arg;
+    uint8_t id[16];
+    bool ok = true;
+    for(uint64_t i = 0; ok && i < PER_THREAD; ++i)
+    {
+        const uint64_t rec = (t << 32) | i;
+        ok = uuid7_log_append(g_log, &rec, id) == 0;
+    }
+    atomic_fetch_add(&g_done, 1u);
+    return ok ? arg : NULL;
+}
+
+static void test_concurrent_appenders_and_reader(void** state)
+{
+    (void)state;
+    uuid7_log_config_t cfg;
+    uuid7_log_config_init(&cfg);
+    cfg.record_size = sizeof(uint64_t);
+    cfg.segment_records = 1024u;
+    g_log = uuid7_log_create(&cfg);
+    assert_non_null(g_log);
+    atomic_store(&g_done, 0u);
+
+    pthread_t th[N_THREADS];
+    for(uintptr_t t = 0; t < N_THREADS; ++t)
+    {
+        assert_int_equal(pthread_create(&th[t], NULL, appender, (void*)t), 0);
+    }
+
+    /* Read while appends run: strictly ascending IDs, and each thread's
+     * records in its own order, nothing lost */
+    uuid7_log_cursor_t cur;
+    uuid7_log_since(g_log, NULL, &cur);
+    uint64_t next[N_THREADS] = {0};
+    uint8_t ids[256][16], last[16] = {0};
+    uint64_t recs[256];
+    size_t seen = 0;
+    for(;;)
+    {
+        const bool done = atomic_load(&g_done) == N_THREADS;
+        const size_t n = uuid7_log_read(g_log, &cur, UINT64_MAX, &ids[0][0], recs, 256u);
+        for(size_t k = 0; k < n; ++k, ++seen)
+        {
+            assert_true(memcmp(last, ids[k], 16) < 0);
+            memcpy(last, ids[k], 16);
+            const uint64_t t = recs[k] >> 32;
+            assert_true(t < N_THREADS);
+            assert_int_equal(recs[k] & 0xFFFFFFFFu, next[t]);
+            next[t]++;
+        }
+        if(done && n == 0) break;
+    }
+    for(uintptr_t t = 0; t < N_THREADS; ++t)
+    {
+        void* ret = NULL;
+        pthread_join(th[t], &ret);
+        assert_true(ret == (void*)t);
+    }
+    assert_int_equal(seen, N_THREADS * PER_THREAD);
+    uuid7_log_destroy(g_log);
+}
+
+static void test_config_limits(void** state)
+{
+    (void)state;
+    uuid7_log_config_t cfg;
+    uuid7_log_config_init(&cfg);
+    cfg.segment_records = 0u;
+    assert_null(uuid7_log_create(&cfg));
+    uuid7_log_config_init(&cfg);
+    cfg.segment_records = 1u << 20;
+    assert_null(uuid7_log_create(&cfg));
+    uuid7_log_config_init(&cfg);
+    cfg.max_segments = 1u;
+    assert_null(uuid7_log_create(&cfg));
+
+    uuid7_log_t* log = make_log(64u, 4u, 0u);
+    assert_non_null(log);
+    uint8_t id[16];
+    assert_int_equal(uuid7_log_append(log, NULL, id), -1);
+    uuid7_log_destroy(log);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_append_read_in_order),
+        cmocka_unit_test(test_since_id_and_time_range),
+        cmocka_unit_test(test_search_large_segment),
+        cmocka_unit_test(test_retire_by_age),
+        cmocka_unit_test(test_auto_retire_and_idle_seal),
+        cmocka_unit_test(test_concurrent_appenders_and_reader),
+        cmocka_unit_test(test_config_limits),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
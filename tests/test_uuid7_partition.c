@@ -0,0 +1,320 @@
+#ifndef _GNU_SOURCE
+#    define _GNU_SOURCE
+#endif
+
+#include "uuid7_partition.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+/* 2025-01-01T00:00:00Z and one hour later */
+#define T0_MS 1735689600000ull
+#define T1_MS (T0_MS + 3600000ull)
+
+static char g_dir[64];
+
+static int setup_dir(void** state)
+{
+    (void)state;
+    strcpy(g_dir, "/tmp/uuid7partXXXXXX");
+    return mkdtemp(g_dir) ? 0 : -1;
+}
+
+static int teardown_dir(void** state)
+{
+    (void)state;
+    char cmd[128];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", g_dir);
+    return system(cmd) == 0 ? 0 : -1;
+}
+
+static void make_id(uint64_t ms, uint8_t tag, uint8_t out[16])
+{
+    memset(out, tag, 16);
+    for(int i = 0; i < 6; ++i) out[i] = (uint8_t)(ms >> (8 * (5 - i)));
+    out[6] = 0x70;
+    out[8] = (uint8_t)(0x80u | (tag & 0x3Fu));
+}
+
+static void format_id(const uint8_t id[16], char out[37])
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t o = 0;
+    for(int i = 0; i < 16; ++i)
+    {
+        if(i == 4 || i == 6 || i == 8 || i == 10) out[o++] = '-';
+        out[o++] = hex[id[i] >> 4];
+        out[o++] = hex[id[i] & 0x0F];
+    }
+    out[o] = '\0';
+}
+
+static size_t read_file(const char* name, char* buf, size_t cap)
+{
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", g_dir, name);
+    FILE* f = fopen(path, "rb");
+    if(!f) return (size_t)-1;
+    size_t n = fread(buf, 1, cap - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+    return n;
+}
+
+static void test_text_records_split_by_hour(void** state)
+{
+    (void)state;
+    uuid7_part_config_t cfg;
+    uuid7_part_config_init(&cfg);
+    cfg.out_dir = g_dir;
+    cfg.prefix = "txt-";
+    cfg.id_column = 1;
+    cfg.threads = 1;
+
+    uint8_t a[16], b[16];
+    char sa[37], sb[37];
+    make_id(T0_MS + 5, 0x11, a);
+    make_id(T1_MS + 7, 0x22, b);
+    format_id(a, sa);
+    format_id(b, sb);
+
+    char input[512];
+    snprintf(input, sizeof(input), "x,%s,1\ny,%s,2\nz,not-an-id,3\nw,%s,4", sa, sb, sa);
+
+    uuid7_part_t* p = uuid7_part_create(&cfg);
+    assert_non_null(p);
+
+    /* Without `last`, the unterminated final line is left to the caller */
+    size_t used = 0;
+    assert_int_equal(uuid7_part_write(p, input, strlen(input), 0, &used), 0);
+    const char* tail = strrchr(input, '\n') + 1;
+    assert_int_equal(used, (size_t)(tail - input));
+    assert_int_equal(uuid7_part_write(p, tail, strlen(tail), 1, &used), 0);
+    assert_int_equal(used, strlen(tail));
+
+    uuid7_part_stats_t st;
+    assert_int_equal(uuid7_part_get_stats(p, &st), 0);
+    assert_int_equal(st.records, 3);
+    assert_int_equal(st.rejected, 1);
+    assert_int_equal(uuid7_part_close(p), 0);
+
+    char buf[512], expect[512];
+    snprintf(expect, sizeof(expect), "x,%s,1\nw,%s,4\n", sa, sa);
+    assert_int_not_equal(read_file("txt-2025-01-01T00", buf, sizeof(buf)), (size_t)-1);
+    assert_string_equal(buf, expect);
+
+    snprintf(expect, sizeof(expect), "y,%s,2\n", sb);
+    assert_int_not_equal(read_file("txt-2025-01-01T01", buf, sizeof(buf)), (size_t)-1);
+    assert_string_equal(buf, expect);
+
+    assert_int_not_equal(read_file("txt-invalid", buf, sizeof(buf)), (size_t)-1);
+    assert_string_equal(buf, "z,not-an-id,3\n");
+}
+
+static void test_binary_records_with_lru_eviction(void** state)
+{
+    (void)state;
+    uuid7_part_config_t cfg;
+    uuid7_part_config_init(&cfg);
+    cfg.out_dir = g_dir;
+    cfg.prefix = "bin-";
+    cfg.format = UUID7_PART_BINARY;
+    cfg.record_size = 20;
+    cfg.id_offset = 4;
+    cfg.bucket_ms = UUID7_PART_DAY_MS;
+    cfg.max_open_files = 1;
+    cfg.threads = 1;
+
+    /* Alternate between two days so the single writer slot is evicted */
+    uint8_t input[6 * 20];
+    for(int i = 0; i < 6; ++i)
+    {
+        uint8_t* rec = input + i * 20;
+        memset(rec, 0xEE, 4);
+        rec[0] = (uint8_t)i;
+        make_id((i % 2) ? T0_MS + 86400000ull : T0_MS, (uint8_t)i, rec + 4);
+    }
+
+    uuid7_part_t* p = uuid7_part_create(&cfg);
+    assert_non_null(p);
+    size_t used = 0;
+    assert_int_equal(uuid7_part_write(p, input, sizeof(input) - 3, 0, &used), 0);
+    assert_int_equal(used, 5 * 20);
+    assert_int_equal(uuid7_part_write(p, input + used, sizeof(input) - used, 1, &used), 0);
+
+    uuid7_part_stats_t st;
+    uuid7_part_get_stats(p, &st);
+    assert_int_equal(st.records, 6);
+    assert_true(st.evictions >= 5);
+    assert_int_equal(uuid7_part_close(p), 0);
+
+    /* Re-opened files were appended to, in input order */
+    char buf[256];
+    assert_int_equal(read_file("bin-2025-01-01", buf, sizeof(buf)), 60);
+    assert_int_equal((uint8_t)buf[0], 0);
+    assert_int_equal((uint8_t)buf[20], 2);
+    assert_int_equal((uint8_t)buf[40], 4);
+    assert_int_equal(read_file("bin-2025-01-02", buf, sizeof(buf)), 60);
+    assert_int_equal((uint8_t)buf[0], 1);
+    assert_int_equal((uint8_t)buf[40], 5);
+}
+
+static void test_binary_non_v7_ids_are_invalid(void** state)
+{
+    (void)state;
+    uuid7_part_config_t cfg;
+    uuid7_part_config_init(&cfg);
+    cfg.out_dir = g_dir;
+    cfg.prefix = "chk-";
+    cfg.format = UUID7_PART_BINARY;
+    cfg.record_size = 16;
+    cfg.bucket_ms = UUID7_PART_DAY_MS;
+
+    /* Valid, wrong version (v4), wrong variant, garbage far in the future */
+    uint8_t input[4 * 16];
+    for(int i = 0; i < 4; ++i) make_id(T0_MS, (uint8_t)i, input + i * 16);
+    input[16 + 6] = 0x40;
+    input[32 + 8] = 0xC0;
+    memset(input + 48, 0xFF, 16);
+
+    uuid7_part_t* p = uuid7_part_create(&cfg);
+    assert_non_null(p);
+    assert_int_equal(uuid7_part_write(p, input, sizeof(input), 1, NULL), 0);
+    uuid7_part_stats_t st;
+    uuid7_part_get_stats(p, &st);
+    assert_int_equal(st.rejected, 3);
+    assert_int_equal(uuid7_part_close(p), 0);
+
+    char buf[128];
+    assert_int_equal(read_file("chk-2025-01-01", buf, sizeof(buf)), 16);
+    assert_int_equal(read_file("chk-invalid", buf, sizeof(buf)), 48);
+    assert_int_equal((uint8_t)buf[6], 0x40);
+    assert_int_equal((uint8_t)buf[16 + 8], 0xC0);
+}
+
+static void test_text_non_v7_ids_are_invalid(void** state)
+{
+    (void)state;
+    uuid7_part_config_t cfg;
+    uuid7_part_config_init(&cfg);
+    cfg.out_dir = g_dir;
+    cfg.prefix = "tchk-";
+    cfg.bucket_ms = UUID7_PART_DAY_MS;
+
+    /* Valid, wrong version (v4), wrong variant, truncated after the ms */
+    uint8_t id[16];
+    char ok[37], v4[37], var[37];
+    make_id(T0_MS, 0x11, id);
+    format_id(id, ok);
+    id[6] = 0x40;
+    format_id(id, v4);
+    id[6] = 0x70;
+    id[8] = 0xC0;
+    format_id(id, var);
+
+    char input[512];
+    snprintf(input, sizeof(input), "%s,a\n%s,b\n%s,c\n%.13s\n", ok, v4, var, ok);
+
+    uuid7_part_t* p = uuid7_part_create(&cfg);
+    assert_non_null(p);
+    assert_int_equal(uuid7_part_write(p, input, strlen(input), 1, NULL), 0);
+    uuid7_part_stats_t st;
+    uuid7_part_get_stats(p, &st);
+    assert_int_equal(st.rejected, 3);
+    assert_int_equal(uuid7_part_close(p), 0);
+
+    char buf[512], expect[512];
+    snprintf(expect, sizeof(expect), "%s,a\n", ok);
+    assert_int_not_equal(read_file("tchk-2025-01-01", buf, sizeof(buf)), (size_t)-1);
+    assert_string_equal(buf, expect);
+    snprintf(expect, sizeof(expect), "%s,b\n%s,c\n%.13s\n", v4, var, ok);
+    assert_int_not_equal(read_file("tchk-invalid", buf, sizeof(buf)), (size_t)-1);
+    assert_string_equal(buf, expect);
+}
+
+static void test_parallel_chunks_keep_order(void** state)
+{
+    (void)state;
+    uuid7_part_config_t cfg;
+    uuid7_part_config_init(&cfg);
+    cfg.out_dir = g_dir;
+    cfg.prefix = "par-";
+    cfg.format = UUID7_PART_BINARY;
+    cfg.record_size = 16;
+    cfg.bucket_ms = UUID7_PART_MINUTE_MS;
+    cfg.threads = 4;
+
+    /* 4 MiB of records so the block is split across workers */
+    const size_t n = (4u << 20) / 16u;
+    uint8_t* input = malloc(n * 16u);
+    assert_non_null(input);
+    for(size_t i = 0; i < n; ++i)
+    {
+        const uint32_t idx = (uint32_t)i;
+        make_id(T0_MS + (i % 2) * 60000ull, 0, input + i * 16u);
+        memcpy(input + i * 16u + 12, &idx, sizeof(idx));
+    }
+
+    uuid7_part_t* p = uuid7_part_create(&cfg);
+    assert_non_null(p);
+    assert_int_equal(uuid7_part_write(p, input, n * 16u, 1, NULL), 0);
+    assert_int_equal(uuid7_part_close(p), 0);
+    free(input);
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s/par-2025-01-01T0001", g_dir);
+    FILE* f = fopen(path, "rb");
+    assert_non_null(f);
+    uint8_t rec[16];
+    size_t expect = 1, count = 0;
+    while(fread(rec, 1, sizeof(rec), f) == sizeof(rec))
+    {
+        uint32_t idx;
+        memcpy(&idx, rec + 12, sizeof(idx));
+        assert_int_equal(idx, expect);
+        expect += 2;
+        count++;
+    }
+    fclose(f);
+    assert_int_equal(count, n / 2);
+}
+
+static void test_invalid_config_rejected(void** state)
+{
+    (void)state;
+    uuid7_part_config_t cfg;
+    uuid7_part_config_init(&cfg);
+    assert_null(uuid7_part_create(&cfg)); /* no out_dir */
+
+    cfg.out_dir = g_dir;
+    cfg.format = UUID7_PART_BINARY;
+    cfg.record_size = 16;
+    cfg.id_offset = 1;
+    assert_null(uuid7_part_create(&cfg)); /* ID does not fit the record */
+
+    assert_null(uuid7_part_create(NULL));
+    assert_int_equal(uuid7_part_close(NULL), 0);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_text_records_split_by_hour),
+        cmocka_unit_test(test_binary_records_with_lru_eviction),
+        cmocka_unit_test(test_binary_non_v7_ids_are_invalid),
+        cmocka_unit_test(test_text_non_v7_ids_are_invalid),
+        cmocka_unit_test(test_parallel_chunks_keep_order),
+        cmocka_unit_test(test_invalid_config_rejected),
+    };
+
+    return cmocka_run_group_tests(tests, setup_dir, teardown_dir);
+}
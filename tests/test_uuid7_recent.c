@@ -0,0 +1,177 @@
+#include "uuid7_recent.h"
+#include "uuid7.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#define N_THREADS  4u
+#define PER_THREAD 20000u
+
+/* Synthetic v7 ID with a chosen ms, seq and tail */
+static void make_id(uint8_t* id, uint64_t ms, uint16_t seq, uint8_t tail)
+{
+    for(int i = 0; i < 6; ++i) id[i] = (uint8_t)(ms >> (8 * (5 - i)));
+    id[6] = (uint8_t)(0x70u | ((seq >> 8) & 0x0Fu));
+    id[7] = (uint8_t)seq;
+    id[8] = 0x80u;
+    memset(id + 9, tail, 7);
+}
+
+/* Slow path: answers with the tail byte it was asked about, tagged */
+static void* slow_lookup(const uint8_t* id, void* ctx)
+{
+    (*(unsigned*)ctx)++;
+    return (void*)(uintptr_t)(0x1000u | id[15]);
+}
+
+static void test_hit_miss_and_fallback(void** state)
+{
+    (void)state;
+    unsigned slow_calls = 0;
+    uuid7_recent_config_t cfg;
+    uuid7_recent_config_init(&cfg);
+    cfg.window_ms = 16u;
+    cfg.seq_sets = 4u;
+    cfg.miss_fn = slow_lookup;
+    cfg.miss_ctx = &slow_calls;
+    uuid7_recent_t* r = uuid7_recent_create(&cfg);
+    assert_non_null(r);
+
+    int objs[4];
+    uint8_t a[16], b[16], c[16], d[16];
+    make_id(a, 1000u, 0x101u, 0x11u);
+    make_id(b, 1000u, 0x102u, 0x22u);
+    make_id(c, 1016u, 0x101u, 0x33u); /* one lap later, same set as a */
+    make_id(d, 1032u, 0x105u, 0x44u); /* two laps later, same set again */
+    assert_int_equal(uuid7_recent_insert(r, a, &objs[0]), 0);
+    assert_int_equal(uuid7_recent_insert(r, b, &objs[1]), 0);
+    assert_int_equal(uuid7_recent_insert(r, c, &objs[2]), 0);
+    assert_ptr_equal(uuid7_recent_get(r, a), &objs[0]);
+    assert_ptr_equal(uuid7_recent_get(r, b), &objs[1]);
+    assert_ptr_equal(uuid7_recent_get(r, c), &objs[2]);
+    assert_int_equal(slow_calls, 0);
+
+    /* Set full: d displaces the older a, which now takes the slow path */
+    assert_int_equal(uuid7_recent_insert(r, d, &objs[3]), 0);
+    assert_ptr_equal(uuid7_recent_get(r, d), &objs[3]);
+    assert_ptr_equal(uuid7_recent_get(r, c), &objs[2]);
+    assert_ptr_equal(uuid7_recent_get(r, a), (void*)(uintptr_t)0x1011u);
+    assert_int_equal(slow_calls, 1);
+
+    /* Remove only matches the exact occupant */
+    assert_int_equal(uuid7_recent_remove(r, a), -1);
+    assert_int_equal(uuid7_recent_remove(r, b), 0);
+    assert_ptr_equal(uuid7_recent_get(r, b), (void*)(uintptr_t)0x1022u);
+
+    uuid7_recent_stats_t st;
+    assert_int_equal(uuid7_recent_get_stats(r, &st), 0);
+    assert_int_equal(st.slots, 128u);
+    assert_int_equal(st.evictions, 1u);
+    assert_int_equal(st.misses, 2u);
+    uuid7_recent_destroy(r);
+}
+
+static void zero_rng(void* buf, const size_t n)
+{
+    memset(buf, 0, n);
+}
+
+static void test_gen_registers_and_config_validation(void** state)
+{
+    (void)state;
+    uuid7_recent_config_t cfg;
+    uuid7_recent_config_init(&cfg);
+    uuid7_recent_t* r = uuid7_recent_create(&cfg);
+    assert_non_null(r);
+
+    /* An all-zero RNG makes the sequence count up from 1 in each ms, so 64
+     * IDs fill at most two ways of 32 consecutive sets and all stay put */
+    assert_int_equal(uuid7_set_rng(zero_rng), 0);
+    int objs[64];
+    uint8_t ids[64][16];
+    for(int i = 0; i < 64; ++i) assert_int_equal(uuid7_recent_gen(r, ids[i], &objs[i]), 0);
+    for(int i = 0; i < 64; ++i) assert_ptr_equal(uuid7_recent_get(r, ids[i]), &objs[i]);
+    assert_int_equal(uuid7_set_rng(NULL), 0);
+
+    assert_int_equal(uuid7_recent_gen(r, ids[0], NULL), -1);
+    assert_int_equal(uuid7_recent_insert(NULL, ids[0], &objs[0]), -1);
+    assert_null(uuid7_recent_get(NULL, ids[0]));
+    assert_int_equal(uuid7_recent_get_stats(r, NULL), -1);
+    uuid7_recent_destroy(r);
+
+    cfg.window_ms = 1000u; /* not a power of two */
+    assert_null(uuid7_recent_create(&cfg));
+    uuid7_recent_config_init(&cfg);
+    cfg.seq_sets = 8192u;
+    assert_null(uuid7_recent_create(&cfg));
+    assert_null(uuid7_recent_create(NULL));
+    uuid7_recent_destroy(NULL);
+}
+
+static uuid7_recent_t* g_table;
+
+/* Register and immediately resolve: a lookup may miss (slot taken over by
+ * a busier ms), but must never return another thread's object */
+static void* gen_and_lookup(void* arg)
+{
+    uintptr_t* mine = calloc(PER_THREAD, sizeof(*mine));
+    uint8_t(*ids)[16] = calloc(PER_THREAD, 16);
+    bool ok = mine && ids;
+    for(size_t i = 0; ok && i < PER_THREAD; ++i)
+    {
+        ok &= uuid7_recent_gen(g_table, ids[i], &mine[i]) == 0;
+        void* got = uuid7_recent_get(g_table, ids[i]);
+        ok &= got == &mine[i] || got == NULL;
+        if(i >= 64)
+        {
+            got = uuid7_recent_get(g_table, ids[i - 64]);
+            ok &= got == &mine[i - 64] || got == NULL;
+        }
+    }
+    free(ids);
+    free(mine);
+    return ok ? arg : NULL;
+}
+
+static void test_concurrent_gen_and_lookup(void** state)
+{
+    (void)state;
+    uuid7_recent_config_t cfg;
+    uuid7_recent_config_init(&cfg);
+    cfg.window_ms = 64u;
+    cfg.seq_sets = 4u; /* small, so slots are shared and displaced */
+    g_table = uuid7_recent_create(&cfg);
+    assert_non_null(g_table);
+
+    pthread_t th[N_THREADS];
+    for(uintptr_t t = 0; t < N_THREADS; ++t)
+    {
+        assert_int_equal(pthread_create(&th[t], NULL, gen_and_lookup, (void*)(t + 1u)), 0);
+    }
+    for(uintptr_t t = 0; t < N_THREADS; ++t)
+    {
+        void* ret = NULL;
+        pthread_join(th[t], &ret);
+        assert_true(ret == (void*)(t + 1u));
+    }
+    uuid7_recent_destroy(g_table);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_hit_miss_and_fallback),
+        cmocka_unit_test(test_gen_registers_and_config_validation),
+        cmocka_unit_test(test_concurrent_gen_and_lookup),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
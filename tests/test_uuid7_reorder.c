@@ -0,0 +1,234 @@
+#include "uuid7_reorder.h"
+#include "uuid7_sim.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+/* 2025-01-01T00:00:00Z */
+#define T0_MS       1735689600000ull
+#define N_PRODUCERS 4u
+#define PER_PRODUCER 20000u
+#define N_IDS       (N_PRODUCERS * PER_PRODUCER)
+#define DRAIN_BATCH 256u
+
+static uint8_t g_ids[N_IDS][16];
+
+/* Monotone stream, 8 IDs per virtual ms */
+static void fill_ids(uint64_t seed, size_t n)
+{
+    uuid7_sim_t sim;
+    uuid7_sim_init(&sim, seed, T0_MS);
+    for(size_t i = 0; i < n; ++i)
+    {
+        if(i % 8u == 0) uuid7_sim_advance(&sim, 1u);
+        uuid7_sim_gen(&sim, g_ids[i]);
+    }
+}
+
+typedef struct producer
+{
+    uuid7_reorder_t* r;
+    unsigned index;
+} producer_t;
+
+/* Producer p sends IDs p, p + N, p + 2N, ... in blocks of 16, each block
+ * reversed, so the merged arrival order is scrambled within a few ms. */
+static void* producer_main(void* arg)
+{
+    const producer_t* p = arg;
+    for(size_t base = 0; base < PER_PRODUCER; base += 16u)
+    {
+        for(size_t k = 16u; k-- > 0;)
+        {
+            const size_t i = (base + k) * N_PRODUCERS + p->index;
+            while(uuid7_reorder_push(p->r, g_ids[i], (void*)(uintptr_t)(i + 1u)) != 0)
+            {
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+static void test_concurrent_producers_drain_in_order(void** state)
+{
+    (void)state;
+    fill_ids(1u, N_IDS);
+
+    uuid7_reorder_config_t cfg;
+    uuid7_reorder_config_init(&cfg);
+    /* Producers may run far apart on a loaded machine, so hold everything:
+     * ingest still races the producers, and the final order must be exact */
+    cfg.skew_ms = UINT64_MAX / 2u;
+    cfg.capacity = 1024u;
+    uuid7_reorder_t* r = uuid7_reorder_create(&cfg);
+    assert_non_null(r);
+
+    pthread_t th[N_PRODUCERS];
+    producer_t args[N_PRODUCERS];
+    for(unsigned t = 0; t < N_PRODUCERS; ++t)
+    {
+        args[t] = (producer_t){r, t};
+        assert_int_equal(pthread_create(&th[t], NULL, producer_main, &args[t]), 0);
+    }
+
+    static uint8_t out[DRAIN_BATCH][16];
+    void* values[DRAIN_BATCH];
+    size_t seen = 0;
+    for(;;)
+    {
+        /* Everything pushed and nothing held: the stream is complete */
+        uuid7_reorder_stats_t st;
+        uuid7_reorder_get_stats(r, &st);
+        const bool all_in = st.pushed == N_IDS;
+        if(all_in && st.held == 0) break;
+
+        const size_t n = all_in ? uuid7_reorder_flush(r, &out[0][0], values, DRAIN_BATCH)
+                                : uuid7_reorder_drain(r, 0, &out[0][0], values, DRAIN_BATCH);
+        for(size_t k = 0; k < n; ++k, ++seen)
+        {
+            /* Exactly the generated sequence, payloads attached */
+            assert_memory_equal(out[k], g_ids[seen], 16);
+            assert_int_equal((uintptr_t)values[k], seen + 1u);
+        }
+        if(n == 0) sched_yield();
+    }
+    for(unsigned t = 0; t < N_PRODUCERS; ++t) pthread_join(th[t], NULL);
+    assert_int_equal(seen, N_IDS);
+
+    uuid7_reorder_stats_t st;
+    assert_int_equal(uuid7_reorder_get_stats(r, &st), 0);
+    assert_int_equal(st.pushed, N_IDS);
+    assert_int_equal(st.emitted, N_IDS);
+    assert_int_equal(st.late, 0);
+    assert_int_equal(st.held, 0);
+    uuid7_reorder_destroy(r);
+}
+
+static void test_watermark_holds_recent_events(void** state)
+{
+    (void)state;
+    fill_ids(2u, 64u); /* ms T0+1 .. T0+8 */
+
+    uuid7_reorder_config_t cfg;
+    uuid7_reorder_config_init(&cfg);
+    cfg.skew_ms = 3u;
+    uuid7_reorder_t* r = uuid7_reorder_create(&cfg);
+    for(size_t i = 64u; i-- > 0;) assert_int_equal(uuid7_reorder_push(r, g_ids[i], NULL), 0);
+
+    /* Wall clock at T0+5: watermark T0+2, i.e. the first two ms (16 IDs) */
+    uint8_t out[64][16];
+    assert_int_equal(uuid7_reorder_drain(r, T0_MS + 5u, &out[0][0], NULL, 64u), 16u);
+    assert_memory_equal(out, g_ids, 16u * 16u);
+
+    /* Event time: highest pushed ms is T0+8, watermark T0+5 */
+    assert_int_equal(uuid7_reorder_drain(r, 0, &out[0][0], NULL, 64u), 24u);
+    assert_memory_equal(out, g_ids[16], 24u * 16u);
+
+    /* The watermark never moves back */
+    assert_int_equal(uuid7_reorder_drain(r, T0_MS + 1u, &out[0][0], NULL, 64u), 0u);
+    assert_int_equal(uuid7_reorder_flush(r, &out[0][0], NULL, 5u), 5u);
+    assert_int_equal(uuid7_reorder_flush(r, &out[0][0], NULL, 64u), 19u);
+    assert_memory_equal(out, g_ids[45], 19u * 16u);
+    uuid7_reorder_destroy(r);
+}
+
+static void test_late_events_counted(void** state)
+{
+    (void)state;
+    fill_ids(3u, 32u);
+
+    for(int drop = 0; drop <= 1; ++drop)
+    {
+        uuid7_reorder_config_t cfg;
+        uuid7_reorder_config_init(&cfg);
+        cfg.skew_ms = 0u;
+        cfg.drop_late = drop;
+        uuid7_reorder_t* r = uuid7_reorder_create(&cfg);
+
+        uint8_t out[32][16];
+        for(size_t i = 16; i < 24; ++i) uuid7_reorder_push(r, g_ids[i], NULL);
+        assert_int_equal(uuid7_reorder_flush(r, &out[0][0], NULL, 32u), 8u);
+
+        /* Two stragglers older than what already left, one fresh event */
+        uuid7_reorder_push(r, g_ids[3], NULL);
+        uuid7_reorder_push(r, g_ids[30], NULL);
+        uuid7_reorder_push(r, g_ids[1], NULL);
+        const size_t n = uuid7_reorder_flush(r, &out[0][0], NULL, 32u);
+
+        uuid7_reorder_stats_t st;
+        uuid7_reorder_get_stats(r, &st);
+        assert_int_equal(st.late, 2u);
+        if(drop)
+        {
+            assert_int_equal(n, 1u);
+            assert_int_equal(st.dropped, 2u);
+            assert_memory_equal(out[0], g_ids[30], 16);
+        }
+        else
+        {
+            /* Late ones first, smallest first, then the in-order event */
+            assert_int_equal(n, 3u);
+            assert_int_equal(st.dropped, 0u);
+            assert_memory_equal(out[0], g_ids[1], 16);
+            assert_memory_equal(out[1], g_ids[3], 16);
+            assert_memory_equal(out[2], g_ids[30], 16);
+        }
+        uuid7_reorder_destroy(r);
+    }
+}
+
+static void test_full_ring_and_bad_args(void** state)
+{
+    (void)state;
+    fill_ids(4u, 8u);
+
+    uuid7_reorder_config_t cfg;
+    uuid7_reorder_config_init(&cfg);
+    cfg.capacity = 3u; /* rounded up to 4 */
+    uuid7_reorder_t* r = uuid7_reorder_create(&cfg);
+    assert_non_null(r);
+    for(size_t i = 0; i < 4; ++i) assert_int_equal(uuid7_reorder_push(r, g_ids[i], NULL), 0);
+    assert_int_equal(uuid7_reorder_push(r, g_ids[4], NULL), -1);
+
+    uint8_t out[8][16];
+    assert_int_equal(uuid7_reorder_flush(r, &out[0][0], NULL, 8u), 4u);
+    assert_int_equal(uuid7_reorder_push(r, g_ids[4], NULL), 0);
+
+    uuid7_reorder_stats_t st;
+    assert_int_equal(uuid7_reorder_get_stats(r, &st), 0);
+    assert_int_equal(st.pushed, 5u);
+    assert_int_equal(st.rejected, 1u);
+    assert_int_equal(st.held, 1u);
+
+    assert_int_equal(uuid7_reorder_push(NULL, g_ids[0], NULL), -1);
+    assert_int_equal(uuid7_reorder_push(r, NULL, NULL), -1);
+    assert_int_equal(uuid7_reorder_drain(NULL, 0, &out[0][0], NULL, 8u), 0u);
+    assert_int_equal(uuid7_reorder_get_stats(r, NULL), -1);
+    cfg.capacity = 1u;
+    assert_null(uuid7_reorder_create(&cfg));
+    assert_null(uuid7_reorder_create(NULL));
+    uuid7_reorder_destroy(r);
+    uuid7_reorder_destroy(NULL);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_concurrent_producers_drain_in_order),
+        cmocka_unit_test(test_watermark_holds_recent_events),
+        cmocka_unit_test(test_late_events_counted),
+        cmocka_unit_test(test_full_ring_and_bad_args),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
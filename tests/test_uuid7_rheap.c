@@ -0,0 +1,166 @@
+#include "uuid7_rheap.h"
+#include "uuid7_sim.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+/* 2025-01-01T00:00:00Z */
+#define T0_MS 1735689600000ull
+#define N_IDS 20000u
+
+static uint8_t g_ids[N_IDS][16];
+
+static int cmp_id(const void* a, const void* b)
+{
+    return memcmp(a, b, 16);
+}
+
+/* Generator-like stream: monotone IDs, several per virtual ms */
+static void fill_ids(uint64_t seed)
+{
+    uuid7_sim_t sim;
+    uuid7_sim_init(&sim, seed, T0_MS);
+    for(size_t i = 0; i < N_IDS; ++i)
+    {
+        if(i % 7u == 0) uuid7_sim_advance(&sim, 1u);
+        uuid7_sim_gen(&sim, g_ids[i]);
+    }
+}
+
+static void test_pops_in_id_order(void** state)
+{
+    (void)state;
+    fill_ids(1u);
+    uuid7_rheap_t* h = uuid7_rheap_create();
+    assert_non_null(h);
+
+    /* Push in a locally shuffled order, interleaved with pops */
+    srand(7);
+    size_t pushed = 0;
+    uint8_t prev[16] = {0};
+    uint8_t id[16];
+    void* value = NULL;
+    while(pushed < N_IDS)
+    {
+        const size_t burst = 1u + (size_t)rand() % 64u;
+        for(size_t k = 0; k < burst && pushed < N_IDS; ++k, ++pushed)
+        {
+            assert_int_equal(uuid7_rheap_push(h, g_ids[pushed], (void*)(uintptr_t)(pushed + 1u)), 0);
+        }
+        const size_t pops = (size_t)rand() % (burst + 1u);
+        for(size_t k = 0; k < pops && uuid7_rheap_size(h) > 0; ++k)
+        {
+            uint8_t peeked[16];
+            assert_int_equal(uuid7_rheap_peek(h, peeked, NULL), 0);
+            assert_int_equal(uuid7_rheap_pop(h, id, &value), 0);
+            assert_memory_equal(peeked, id, 16);
+            assert_true(memcmp(prev, id, 16) <= 0);
+            assert_memory_equal(g_ids[(uintptr_t)value - 1u], id, 16);
+            memcpy(prev, id, 16);
+        }
+    }
+    while(uuid7_rheap_size(h) > 0)
+    {
+        assert_int_equal(uuid7_rheap_pop(h, id, NULL), 0);
+        assert_true(memcmp(prev, id, 16) <= 0);
+        memcpy(prev, id, 16);
+    }
+    assert_int_equal(uuid7_rheap_pop(h, id, NULL), -1);
+    uuid7_rheap_destroy(h);
+}
+
+static void test_bulk_insert_matches_sort(void** state)
+{
+    (void)state;
+    fill_ids(2u);
+    /* Reverse, so the bulk path sees a fully unsorted block */
+    for(size_t i = 0; i < N_IDS / 2u; ++i)
+    {
+        uint8_t tmp[16];
+        memcpy(tmp, g_ids[i], 16);
+        memcpy(g_ids[i], g_ids[N_IDS - 1u - i], 16);
+        memcpy(g_ids[N_IDS - 1u - i], tmp, 16);
+    }
+    uuid7_rheap_t* h = uuid7_rheap_create();
+    assert_int_equal(uuid7_rheap_push_n(h, &g_ids[0][0], NULL, N_IDS), 0);
+    assert_int_equal(uuid7_rheap_size(h), N_IDS);
+
+    qsort(g_ids, N_IDS, 16, cmp_id);
+    uint8_t id[16];
+    for(size_t i = 0; i < N_IDS; ++i)
+    {
+        assert_int_equal(uuid7_rheap_pop(h, id, NULL), 0);
+        assert_memory_equal(id, g_ids[i], 16);
+    }
+    uuid7_rheap_destroy(h);
+}
+
+static void test_late_keys_pop_first(void** state)
+{
+    (void)state;
+    fill_ids(3u);
+    uuid7_rheap_t* h = uuid7_rheap_create();
+    for(size_t i = 100; i < 200; ++i) uuid7_rheap_push(h, g_ids[i], NULL);
+
+    uint8_t id[16];
+    assert_int_equal(uuid7_rheap_pop(h, id, NULL), 0);
+    assert_memory_equal(id, g_ids[100], 16);
+
+    /* Older than the last pop: served next, smallest first */
+    assert_int_equal(uuid7_rheap_push(h, g_ids[50], NULL), 0);
+    assert_int_equal(uuid7_rheap_push(h, g_ids[10], NULL), 0);
+    assert_int_equal(uuid7_rheap_push(h, g_ids[30], NULL), 0);
+    assert_int_equal(uuid7_rheap_pop(h, id, NULL), 0);
+    assert_memory_equal(id, g_ids[10], 16);
+    assert_int_equal(uuid7_rheap_pop(h, id, NULL), 0);
+    assert_memory_equal(id, g_ids[30], 16);
+    assert_int_equal(uuid7_rheap_pop(h, id, NULL), 0);
+    assert_memory_equal(id, g_ids[50], 16);
+    for(size_t i = 101; i < 200; ++i)
+    {
+        assert_int_equal(uuid7_rheap_pop(h, id, NULL), 0);
+        assert_memory_equal(id, g_ids[i], 16);
+    }
+    uuid7_rheap_destroy(h);
+}
+
+static void test_duplicates_and_bad_args(void** state)
+{
+    (void)state;
+    uuid7_rheap_t* h = uuid7_rheap_create();
+    const uint8_t id[16] = {0x01, 0x94, 0, 0, 0, 0, 0x70, 0x01, 0x80, 0, 0, 0, 0, 0, 0, 1};
+    for(int i = 0; i < 3; ++i) assert_int_equal(uuid7_rheap_push(h, id, NULL), 0);
+    uint8_t out[16];
+    for(int i = 0; i < 3; ++i)
+    {
+        assert_int_equal(uuid7_rheap_pop(h, out, NULL), 0);
+        assert_memory_equal(out, id, 16);
+    }
+    assert_int_equal(uuid7_rheap_push(NULL, id, NULL), -1);
+    assert_int_equal(uuid7_rheap_push(h, NULL, NULL), -1);
+    assert_int_equal(uuid7_rheap_push_n(h, NULL, NULL, 1), -1);
+    assert_int_equal(uuid7_rheap_push_n(h, NULL, NULL, 0), 0);
+    assert_int_equal(uuid7_rheap_pop(NULL, out, NULL), -1);
+    assert_int_equal(uuid7_rheap_size(NULL), 0);
+    uuid7_rheap_destroy(h);
+    uuid7_rheap_destroy(NULL);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_pops_in_id_order),
+        cmocka_unit_test(test_bulk_insert_matches_sort),
+        cmocka_unit_test(test_late_keys_pop_first),
+        cmocka_unit_test(test_duplicates_and_bad_args),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
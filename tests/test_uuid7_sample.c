@@ -0,0 +1,208 @@
+#include "uuid7_sample.h"
+#include "uuid7_sim.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+/* 2025-01-01T00:00:00Z */
+#define T0_MS   1735689600000ull
+#define N_IDS   100003u /* not a multiple of 64 */
+#define N_WORDS ((N_IDS + 63u) / 64u)
+#define QUOTA   5u
+
+static uint8_t g_ids[N_IDS][16];
+static uint8_t g_shuffled[N_IDS][16];
+static uint64_t g_bits[N_WORDS];
+static uint64_t g_bits2[N_WORDS];
+
+static uint32_t next_rand(uint32_t* x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+static bool bit(const uint64_t* bitmap, size_t i)
+{
+    return (bitmap[i / 64u] >> (i % 64u)) & 1u;
+}
+
+static uint64_t tail_of(const uint8_t* id)
+{
+    uint64_t v = id[8] & 0x3Fu;
+    for(int i = 9; i < 16; ++i) v = (v << 8) | id[i];
+    return v;
+}
+
+static uint64_t ms_of(const uint8_t* id)
+{
+    uint64_t v = 0;
+    for(int i = 0; i < 6; ++i) v = (v << 8) | id[i];
+    return v;
+}
+
+/* Ascending IDs, 0..2 * QUOTA + 1 per virtual ms, some ms empty */
+static void fill_ids(uint64_t seed)
+{
+    uuid7_sim_t sim;
+    uuid7_sim_init(&sim, seed, T0_MS);
+    uint32_t x = (uint32_t)seed * 2654435761u + 1u;
+    uint32_t left = 0;
+    for(size_t i = 0; i < N_IDS; ++i)
+    {
+        while(left == 0)
+        {
+            uuid7_sim_advance(&sim, 1u);
+            left = next_rand(&x) % (2u * QUOTA + 2u);
+        }
+        uuid7_sim_gen(&sim, g_ids[i]);
+        --left;
+    }
+}
+
+static void test_rate_decisions(void** state)
+{
+    (void)state;
+    fill_ids(1u);
+
+    size_t kept = 0;
+    assert_int_equal(uuid7_sample_n(&g_ids[0][0], N_IDS, 0.1, g_bits, &kept), 0);
+    assert_in_range(kept, N_IDS / 10u - 1000u, N_IDS / 10u + 1000u);
+    assert_int_equal(g_bits[N_WORDS - 1u] >> (N_IDS % 64u), 0u);
+
+    /* The batch agrees with single decisions, and lower rates keep subsets */
+    assert_int_equal(uuid7_sample_n(&g_ids[0][0], N_IDS, 0.02, g_bits2, NULL), 0);
+    size_t count = 0;
+    for(size_t i = 0; i < N_IDS; ++i)
+    {
+        assert_int_equal(uuid7_sample(g_ids[i], 0.1), bit(g_bits, i));
+        assert_int_equal(uuid7_sample(g_ids[i], 0.02), bit(g_bits2, i));
+        if(bit(g_bits2, i)) assert_true(bit(g_bits, i));
+        count += bit(g_bits, i);
+    }
+    assert_int_equal(count, kept);
+
+    /* Extremes, including the largest and smallest tails */
+    uint8_t id[16];
+    memcpy(id, g_ids[0], 16);
+    memset(id + 9, 0xFF, 7);
+    id[8] = 0xBF;
+    assert_int_equal(uuid7_sample(id, 1.0), 1);
+    assert_int_equal(uuid7_sample(id, 0.999999), 0);
+    memset(id + 9, 0x00, 7);
+    id[8] = 0x80;
+    assert_int_equal(uuid7_sample(id, 0.0), 0);
+    assert_int_equal(uuid7_sample(id, 1e-12), 1);
+    assert_int_equal(uuid7_sample_n(&g_ids[0][0], N_IDS, 2.0, g_bits, &kept), 0);
+    assert_int_equal(kept, N_IDS);
+    assert_int_equal(uuid7_sample_n(&g_ids[0][0], N_IDS, -1.0, g_bits, &kept), 0);
+    assert_int_equal(kept, 0u);
+}
+
+static void test_per_bucket_keeps_smallest_tails(void** state)
+{
+    (void)state;
+    fill_ids(2u);
+
+    size_t kept = 0;
+    assert_int_equal(uuid7_sample_per_bucket(&g_ids[0][0], N_IDS, 1u, QUOTA, g_bits, &kept), 0);
+
+    /* Every run of one ms keeps min(run, QUOTA), and every dropped tail is
+     * above every kept one */
+    size_t total = 0;
+    for(size_t i = 0; i < N_IDS;)
+    {
+        size_t j = i;
+        size_t in = 0;
+        uint64_t max_kept = 0, min_dropped = UINT64_MAX;
+        while(j < N_IDS && ms_of(g_ids[j]) == ms_of(g_ids[i]))
+        {
+            const uint64_t t = tail_of(g_ids[j]);
+            if(bit(g_bits, j))
+            {
+                ++in;
+                if(t > max_kept) max_kept = t;
+            }
+            else if(t < min_dropped)
+            {
+                min_dropped = t;
+            }
+            ++j;
+        }
+        assert_int_equal(in, j - i < QUOTA ? j - i : QUOTA);
+        assert_true(max_kept < min_dropped);
+        total += in;
+        i = j;
+    }
+    assert_int_equal(total, kept);
+    assert_int_equal(g_bits[N_WORDS - 1u] >> (N_IDS % 64u), 0u);
+
+    /* Order inside a bucket does not change the choice: reverse each
+     * 10 ms bucket and compare the kept IDs */
+    assert_int_equal(uuid7_sample_per_bucket(&g_ids[0][0], N_IDS, 10u, QUOTA, g_bits, &kept), 0);
+    for(size_t i = 0; i < N_IDS;)
+    {
+        size_t j = i;
+        while(j < N_IDS && ms_of(g_ids[j]) / 10u == ms_of(g_ids[i]) / 10u) ++j;
+        for(size_t k = i; k < j; ++k) memcpy(g_shuffled[k], g_ids[i + j - 1u - k], 16);
+        i = j;
+    }
+    size_t kept2 = 0;
+    assert_int_equal(uuid7_sample_per_bucket(&g_shuffled[0][0], N_IDS, 10u, QUOTA, g_bits2, &kept2), 0);
+    assert_int_equal(kept2, kept);
+    for(size_t i = 0; i < N_IDS;)
+    {
+        size_t j = i;
+        while(j < N_IDS && ms_of(g_ids[j]) / 10u == ms_of(g_ids[i]) / 10u) ++j;
+        for(size_t k = i; k < j; ++k) assert_int_equal(bit(g_bits, k), bit(g_bits2, i + j - 1u - k));
+        i = j;
+    }
+
+    /* A quota of zero keeps nothing, a huge one everything */
+    assert_int_equal(uuid7_sample_per_bucket(&g_ids[0][0], N_IDS, 1u, 0u, g_bits, &kept), 0);
+    assert_int_equal(kept, 0u);
+    assert_int_equal(uuid7_sample_per_bucket(&g_ids[0][0], N_IDS, 1u, UINT32_MAX, g_bits, &kept), 0);
+    assert_int_equal(kept, N_IDS);
+}
+
+static void test_bad_args(void** state)
+{
+    (void)state;
+    fill_ids(3u);
+
+    uint64_t bits[1];
+    size_t kept = 0;
+    assert_int_equal(uuid7_sample(NULL, 0.5), -1);
+    assert_int_equal(uuid7_sample(g_ids[0], 0.0 / 0.0), -1);
+    assert_int_equal(uuid7_sample_n(NULL, 1u, 0.5, bits, NULL), -1);
+    assert_int_equal(uuid7_sample_n(&g_ids[0][0], 1u, 0.5, NULL, NULL), -1);
+    assert_int_equal(uuid7_sample_n(NULL, 0u, 0.5, NULL, &kept), 0);
+    assert_int_equal(kept, 0u);
+    assert_int_equal(uuid7_sample_per_bucket(&g_ids[0][0], 2u, 0u, 1u, bits, NULL), -1);
+    assert_int_equal(uuid7_sample_per_bucket(NULL, 2u, 1u, 1u, bits, NULL), -1);
+
+    /* A bucket that goes back in time is refused */
+    uint8_t two[2][16];
+    memcpy(two[0], g_ids[N_IDS - 1u], 16);
+    memcpy(two[1], g_ids[0], 16);
+    assert_int_equal(uuid7_sample_per_bucket(&two[0][0], 2u, 1u, 1u, bits, NULL), -1);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_rate_decisions),
+        cmocka_unit_test(test_per_bucket_keeps_smallest_tails),
+        cmocka_unit_test(test_bad_args),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
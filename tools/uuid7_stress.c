@@ -0,0 +1,541 @@
+/**
+ * @file uuid7_stress.c
+ * @brief Multi-process, multi-thread uniqueness and monotonicity stress test.
+ *
+ * Forks P worker processes, each running T threads that call a generation
+ * mode for a fixed duration. Every ID is inserted into one lock-free hash set
+ * in shared anonymous memory, so duplicates are detected across threads and
+ * across processes. Each thread also checks that its own IDs are strictly
+ * increasing in (ms, seq).
+ *
+ * - Hash set: open addressing over 16-byte slots holding the two big-endian
+ *   halves of an ID. Both halves of a UUIDv7 are never zero (version and
+ *   variant bits), so 0 marks an empty slot. An inserter claims a slot by
+ *   CAS on the high half and then publishes the low half; a prober that
+ *   finds an equal high half waits for the low half before comparing.
+ * - Clock jumps: with `-J PERIOD:DELTA` each process installs a clock
+ *   (`uuid7_set_clock()`) that alternates every PERIOD ms between real time
+ *   and real time minus DELTA, exercising the backward-jump clamp.
+ * - Modes: `-m` selects the generation entry point from `g_modes`; every
+ *   performance mode of the library is listed there so it can be validated
+ *   before rollout. `gen_n` fills each batch with blocks of varying size,
+ *   and `mixed` interleaves `uuid7_gen()` and `uuid7_gen_n()` under
+ *   adaptive leasing, so the per-thread ordering check spans both the
+ *   block boundaries and the lease hand-offs.
+ *
+ * Usage: uuid7_stress [-P procs] [-T threads] [-d seconds] [-m mode]
+ *                     [-c log2_slots] [-J period_ms:delta_ms]
+ *
+ * Exit status: 0 if no duplicate and no monotonicity violation was seen.
+ *
+ * @author: Roman Horshkov <roman.horshkov@gmail.com>
+ * @date:   2025
+ */
+#ifndef _GNU_SOURCE
+#    define _GNU_SOURCE
+#endif
+
+#include "uuid7.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/****************************************************************************
+ * PRIVATE DEFINES
+ ****************************************************************************
+ */
+
+#define STRESS_MAX_PROCS   64u
+#define STRESS_MAX_THREADS 256u
+#define STRESS_BATCH       64u   /* IDs generated between deadline checks */
+#define STRESS_LOAD_PCT    75u   /* stop once the set is this full */
+#define STRESS_DEF_LOG2    24u   /* 16M slots, 256 MiB */
+
+/****************************************************************************
+ * PRIVATE STUCTURED VARIABLES
+ ****************************************************************************
+ */
+
+/* Generation entry point: fill @p n consecutive IDs into @p out */
+typedef int (*stress_gen_fn)(uint8_t* out, size_t n);
+
+typedef struct stress_mode
+{
+    const char* name;
+    stress_gen_fn gen;
+    int (*setup)(void); /* optional, run in each process before its threads */
+    void (*report)(unsigned proc); /* optional, run in each process at the end */
+} stress_mode_t;
+
+typedef struct stress_slot
+{
+    _Atomic uint64_t hi;
+    _Atomic uint64_t lo;
+} stress_slot_t;
+
+/* Per-thread results, in shared memory so the parent can read them */
+typedef struct stress_result
+{
+    uint64_t generated;
+    uint64_t duplicates;
+    uint64_t mono_violations;
+    uint64_t errors;
+} stress_result_t;
+
+/* Shared control block */
+typedef struct stress_shared
+{
+    _Atomic uint64_t inserted;
+    _Atomic int stop;
+} stress_shared_t;
+
+typedef struct stress_thread
+{
+    stress_result_t* result;
+    uint64_t deadline_ns;
+} stress_thread_t;
+
+/****************************************************************************
+ * PRIVATE VARIABLES
+ ****************************************************************************
+ */
+
+static stress_slot_t* g_set;
+static uint64_t g_set_mask;
+static uint64_t g_set_limit;
+static stress_shared_t* g_shared;
+static const stress_mode_t* g_mode;
+
+static uint64_t g_jump_period_ms;
+static uint64_t g_jump_delta_ms;
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS PROTOTYPES
+ ****************************************************************************
+ */
+
+/**
+ * @brief "gen" mode: one `uuid7_gen()` call per ID.
+ */
+static int _mode_gen(uint8_t* out, size_t n);
+
+/**
+ * @brief "gen_n" mode: `uuid7_gen_n()` blocks of 1 to `STRESS_BATCH` IDs.
+ */
+static int _mode_gen_n(uint8_t* out, size_t n);
+
+/**
+ * @brief "mixed" mode: alternating `uuid7_gen()` IDs and `uuid7_gen_n()`
+ * blocks.
+ */
+static int _mode_mixed(uint8_t* out, size_t n);
+
+/**
+ * @brief "fc" mode: one `uuid7_gen_fc()` call per ID.
+ */
+static int _mode_fc(uint8_t* out, size_t n);
+
+/**
+ * @brief "adaptive" mode setup: `uuid7_gen()` with contention-aware leasing.
+ */
+static int _setup_adaptive(void);
+
+/**
+ * @brief "mixed" mode setup: adaptive leasing forced on from the first
+ * window and never left, so `uuid7_gen()` runs leased whatever the
+ * contention on the test machine.
+ */
+static int _setup_leased(void);
+
+/**
+ * @brief Print the adaptive mode-change counters of one process.
+ */
+static void _report_adaptive(unsigned proc);
+
+/**
+ * @brief Insert an ID into the shared set.
+ * @return 1 if inserted, 0 if it was already present, -1 if the set is full.
+ */
+static int _set_insert(uint64_t hi, uint64_t lo);
+
+/**
+ * @brief Worker thread body.
+ * @param arg  stress_thread_t*.
+ * @return NULL.
+ */
+static void* _worker(void* arg);
+
+/**
+ * @brief Clock with injected backward jumps (see `-J`).
+ */
+static uint64_t _jumping_clock(void);
+
+/****************************************************************************
+ * MODE TABLE
+ ****************************************************************************
+ */
+
+static const stress_mode_t g_modes[] = {
+    {"gen", _mode_gen, NULL, NULL},
+    {"adaptive", _mode_gen, _setup_adaptive, _report_adaptive},
+    {"gen_n", _mode_gen_n, NULL, NULL},
+    {"mixed", _mode_mixed, _setup_leased, _report_adaptive},
+    {"fc", _mode_fc, NULL, NULL},
+};
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+int main(int argc, char** argv)
+{
+    unsigned procs = 2;
+    unsigned threads = 4;
+    double seconds = 2.0;
+    unsigned log2_slots = STRESS_DEF_LOG2;
+    const char* mode_name = "gen";
+
+    int c;
+    while((c = getopt(argc, argv, "P:T:d:m:c:J:h")) != -1)
+    {
+        switch(c)
+        {
+            case 'P': procs = (unsigned)strtoul(optarg, NULL, 10); break;
+            case 'T': threads = (unsigned)strtoul(optarg, NULL, 10); break;
+            case 'd': seconds = strtod(optarg, NULL); break;
+            case 'm': mode_name = optarg; break;
+            case 'c': log2_slots = (unsigned)strtoul(optarg, NULL, 10); break;
+            case 'J':
+                if(sscanf(optarg, "%" SCNu64 ":%" SCNu64, &g_jump_period_ms, &g_jump_delta_ms) != 2 ||
+                   g_jump_period_ms == 0)
+                {
+                    goto usage;
+                }
+                break;
+            case 'h':
+            default: goto usage;
+        }
+    }
+    if(procs < 1 || procs > STRESS_MAX_PROCS || threads < 1 || threads > STRESS_MAX_THREADS || seconds <= 0 ||
+       log2_slots < 10 || log2_slots > 34)
+    {
+        goto usage;
+    }
+
+    for(size_t i = 0; i < sizeof(g_modes) / sizeof(g_modes[0]); ++i)
+    {
+        if(strcmp(g_modes[i].name, mode_name) == 0) g_mode = &g_modes[i];
+    }
+    if(!g_mode)
+    {
+        fprintf(stderr, "%s: unknown mode '%s'\n", argv[0], mode_name);
+        goto usage;
+    }
+
+    /* Shared memory: control block, per-thread results, hash set */
+    const uint64_t nslots = 1ull << log2_slots;
+    const size_t nresults = (size_t)procs * threads;
+    g_shared = mmap(NULL, sizeof(*g_shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    stress_result_t* results = mmap(NULL, nresults * sizeof(*results), PROT_READ | PROT_WRITE,
+                                    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    g_set = mmap(NULL, nslots * sizeof(*g_set), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE,
+                 -1, 0);
+    if(g_shared == MAP_FAILED || results == MAP_FAILED || g_set == MAP_FAILED)
+    {
+        fprintf(stderr, "%s: mmap: %s\n", argv[0], strerror(errno));
+        return 2;
+    }
+    g_set_mask = nslots - 1u;
+    g_set_limit = nslots / 100u * STRESS_LOAD_PCT;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    const uint64_t deadline_ns =
+        (uint64_t)t0.tv_sec * 1000000000ull + (uint64_t)t0.tv_nsec + (uint64_t)(seconds * 1e9);
+
+    pid_t pids[STRESS_MAX_PROCS];
+    for(unsigned p = 0; p < procs; ++p)
+    {
+        pids[p] = fork();
+        if(pids[p] < 0)
+        {
+            fprintf(stderr, "%s: fork: %s\n", argv[0], strerror(errno));
+            atomic_store(&g_shared->stop, 1);
+            procs = p;
+            break;
+        }
+        if(pids[p] == 0)
+        {
+            /* Child: fresh generator state per process after fork */
+            if(g_jump_period_ms) uuid7_set_clock(_jumping_clock);
+            if(g_mode->setup && g_mode->setup() != 0) _exit(1);
+
+            pthread_t tids[STRESS_MAX_THREADS];
+            stress_thread_t args[STRESS_MAX_THREADS];
+            bool started[STRESS_MAX_THREADS];
+            int rc = 0;
+            for(unsigned t = 0; t < threads; ++t)
+            {
+                args[t] = (stress_thread_t){.result = &results[p * threads + t], .deadline_ns = deadline_ns};
+                started[t] = pthread_create(&tids[t], NULL, _worker, &args[t]) == 0;
+                if(!started[t])
+                {
+                    results[p * threads + t].errors++;
+                    rc = 1;
+                }
+            }
+            for(unsigned t = 0; t < threads; ++t)
+            {
+                if(started[t]) pthread_join(tids[t], NULL);
+            }
+            if(g_mode->report) g_mode->report(p);
+            _exit(rc);
+        }
+    }
+
+    bool child_failed = false;
+    for(unsigned p = 0; p < procs; ++p)
+    {
+        int status = 0;
+        if(waitpid(pids[p], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) child_failed = true;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    const double elapsed = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    stress_result_t total = {0};
+    for(unsigned p = 0; p < procs; ++p)
+    {
+        stress_result_t proc = {0};
+        for(unsigned t = 0; t < threads; ++t)
+        {
+            const stress_result_t* r = &results[p * threads + t];
+            proc.generated += r->generated;
+            proc.duplicates += r->duplicates;
+            proc.mono_violations += r->mono_violations;
+            proc.errors += r->errors;
+        }
+        printf("proc %2u: ids=%" PRIu64 " dup=%" PRIu64 " mono=%" PRIu64 " err=%" PRIu64 " rate=%.2f Mid/s\n", p,
+               proc.generated, proc.duplicates, proc.mono_violations, proc.errors,
+               (double)proc.generated / elapsed / 1e6);
+        total.generated += proc.generated;
+        total.duplicates += proc.duplicates;
+        total.mono_violations += proc.mono_violations;
+        total.errors += proc.errors;
+    }
+
+    printf("mode=%s procs=%u threads=%u elapsed=%.3fs%s\n", g_mode->name, procs, threads, elapsed,
+           atomic_load(&g_shared->stop) ? " (stopped early: set full)" : "");
+    printf("total: ids=%" PRIu64 " dup=%" PRIu64 " mono=%" PRIu64 " err=%" PRIu64 " rate=%.2f Mid/s\n",
+           total.generated, total.duplicates, total.mono_violations, total.errors,
+           (double)total.generated / elapsed / 1e6);
+
+    const bool ok = !child_failed && total.duplicates == 0 && total.mono_violations == 0 && total.errors == 0;
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+
+usage:
+    fprintf(stderr,
+            "usage: %s [-P procs] [-T threads] [-d seconds] [-m mode] [-c log2_slots]\n"
+            "          [-J period_ms:delta_ms]\n"
+            "modes:",
+            argv[0]);
+    for(size_t i = 0; i < sizeof(g_modes) / sizeof(g_modes[0]); ++i) fprintf(stderr, " %s", g_modes[i].name);
+    fprintf(stderr, "\n");
+    return 2;
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static int _mode_gen(uint8_t* out, size_t n)
+{
+    for(size_t i = 0; i < n; ++i)
+    {
+        if(uuid7_gen(out + i * 16u) != 0) return -1;
+    }
+    return 0;
+}
+
+/* Next block size for the calling thread, cycling through 1..STRESS_BATCH */
+static size_t _block_size(size_t left)
+{
+    static _Thread_local uint32_t turn;
+    const size_t k = 1u + (size_t)((turn++ * 37u) % STRESS_BATCH);
+    return k < left ? k : left;
+}
+
+static int _mode_gen_n(uint8_t* out, size_t n)
+{
+    for(size_t i = 0; i < n;)
+    {
+        const size_t k = _block_size(n - i);
+        if(uuid7_gen_n(out + i * 16u, k) != 0) return -1;
+        i += k;
+    }
+    return 0;
+}
+
+static int _mode_mixed(uint8_t* out, size_t n)
+{
+    for(size_t i = 0; i < n;)
+    {
+        /* A few single IDs from the thread's lease, then a block */
+        for(size_t j = 0; j < 3u && i < n; ++j, ++i)
+        {
+            if(uuid7_gen(out + i * 16u) != 0) return -1;
+        }
+        const size_t k = _block_size(n - i);
+        if(k && uuid7_gen_n(out + i * 16u, k) != 0) return -1;
+        i += k;
+    }
+    return 0;
+}
+
+static int _mode_fc(uint8_t* out, size_t n)
+{
+    for(size_t i = 0; i < n; ++i)
+    {
+        if(uuid7_gen_fc(out + i * 16u) != 0) return -1;
+    }
+    return 0;
+}
+
+static int _setup_adaptive(void)
+{
+    uuid7_adapt_config_t cfg;
+    uuid7_adapt_config_init(&cfg);
+    return uuid7_set_adaptive(&cfg);
+}
+
+static int _setup_leased(void)
+{
+    uuid7_adapt_config_t cfg;
+    uuid7_adapt_config_init(&cfg);
+    cfg.window = 16u;
+    cfg.enter_pct = 0u; /* every window votes for leasing */
+    cfg.exit_pct = 0u;
+    cfg.enter_windows = 1u;
+    cfg.exit_windows = UINT32_MAX;
+    return uuid7_set_adaptive(&cfg);
+}
+
+static void _report_adaptive(unsigned proc)
+{
+    uuid7_adapt_stats_t st;
+    uuid7_get_adapt_stats(&st);
+    fprintf(stderr,
+            "proc %u: adaptive cas=%" PRIu64 " retries=%" PRIu64 " leases=%" PRIu64 " to_leased=%" PRIu64
+            " to_shared=%" PRIu64 "\n",
+            proc, st.cas_attempts, st.cas_retries, st.leases, st.to_leased, st.to_shared);
+}
+
+static inline uint64_t _load_be64(const uint8_t* p)
+{
+    uint64_t v = 0;
+    for(int i = 0; i < 8; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+static inline uint64_t _mono_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int _set_insert(uint64_t hi, uint64_t lo)
+{
+    if(atomic_load_explicit(&g_shared->inserted, memory_order_relaxed) >= g_set_limit) return -1;
+
+    uint64_t pos = ((lo ^ (hi * 0x9E3779B97F4A7C15ull)) * 0xBF58476D1CE4E5B9ull) >> 20;
+    for(;;)
+    {
+        stress_slot_t* s = &g_set[pos & g_set_mask];
+        uint64_t cur = atomic_load_explicit(&s->hi, memory_order_acquire);
+        if(cur == 0)
+        {
+            uint64_t expected = 0;
+            if(atomic_compare_exchange_strong_explicit(&s->hi, &expected, hi, memory_order_acq_rel,
+                                                       memory_order_acquire))
+            {
+                atomic_store_explicit(&s->lo, lo, memory_order_release);
+                atomic_fetch_add_explicit(&g_shared->inserted, 1u, memory_order_relaxed);
+                return 1;
+            }
+            cur = expected;
+        }
+        if(cur == hi)
+        {
+            /* Same high half: wait until the owner publishes the low half */
+            uint64_t other;
+            while((other = atomic_load_explicit(&s->lo, memory_order_acquire)) == 0)
+            {
+            }
+            if(other == lo) return 0;
+        }
+        ++pos;
+    }
+}
+
+static void* _worker(void* arg)
+{
+    stress_thread_t* a = (stress_thread_t*)arg;
+    stress_result_t* r = a->result;
+    uint8_t ids[STRESS_BATCH * 16u];
+    uint64_t last_prefix = 0;
+
+    while(!atomic_load_explicit(&g_shared->stop, memory_order_relaxed) && _mono_ns() < a->deadline_ns)
+    {
+        if(g_mode->gen(ids, STRESS_BATCH) != 0)
+        {
+            r->errors++;
+            break;
+        }
+        for(size_t i = 0; i < STRESS_BATCH; ++i)
+        {
+            const uint8_t* id = ids + i * 16u;
+            const uint64_t hi = _load_be64(id);
+            const uint64_t lo = _load_be64(id + 8);
+
+            /* (ms, ver, seq) must strictly increase within a thread */
+            if(hi <= last_prefix) r->mono_violations++;
+            last_prefix = hi;
+
+            const int ins = _set_insert(hi, lo);
+            if(ins == 0) r->duplicates++;
+            if(ins < 0)
+            {
+                atomic_store_explicit(&g_shared->stop, 1, memory_order_relaxed);
+                break;
+            }
+            r->generated++;
+        }
+    }
+    return NULL;
+}
+
+static uint64_t _jumping_clock(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    const uint64_t now = (uint64_t)ts.tv_sec * 1000u + (uint64_t)(ts.tv_nsec / 1000000u);
+
+    /* Odd periods run behind by DELTA: a backward jump at the start of the
+     * period and a forward jump at its end. */
+    if((now / g_jump_period_ms) & 1u) return now - g_jump_delta_ms;
+    return now;
+}
@@ -0,0 +1,589 @@
+/**
+ * @file uuid7grep.c
+ * @brief Time-range search for UUIDv7 strings in text logs.
+ *
+ * Scans text for canonical 36-character UUIDv7 strings and prints every line
+ * (or, with `-o`, every ID) whose embedded unix-ms timestamp falls inside the
+ * inclusive range [from, to].
+ *
+ * - Candidate search: the input is swept 16 bytes at a time for '-' (SSE2
+ *   compare + movemask when available). Every dash is tried as the first dash
+ *   of an 8-4-4-4-12 string; the 36 candidate bytes are then classified as
+ *   hex/dash with three overlapping 16-byte vector loads, so a full shape
+ *   check costs a handful of instructions and no per-character branches.
+ * - Filtering: only the 12-hex-digit timestamp prefix is decoded
+ *   (`uuid7_str_ms()`); the rest of the ID is never parsed.
+ * - Parallelism: each input window is split at line boundaries into one chunk
+ *   per worker thread. Workers collect output in private buffers which are
+ *   written in chunk order, so output order matches input order.
+ * - Inputs: regular files are memory-mapped. Pipes and stdin (e.g. the output
+ *   of `zstd -dc`) are read in large windows cut at the last newline, so
+ *   decompressed streams are scanned with the same parallel path.
+ *
+ * Usage: uuid7grep -f FROM -t TO [-o] [-c] [-j N] [FILE...]
+ *   FROM/TO are unix ms or UTC `YYYY-MM-DDTHH:MM:SS[.mmm][Z]`.
+ *
+ * Exit status follows grep(1): 0 if something matched, 1 if nothing did,
+ * 2 on error.
+ *
+ * @author: Roman Horshkov <roman.horshkov@gmail.com>
+ * @date:   2025
+ */
+#ifndef _GNU_SOURCE
+#    define _GNU_SOURCE
+#endif
+
+#include "uuid7.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+/****************************************************************************
+ * PRIVATE DEFINES
+ ****************************************************************************
+ */
+
+#define GREP_UUID_CHARS   36u
+#define GREP_FIRST_DASH   8u
+#define GREP_VERSION_POS  14u
+#define GREP_VARIANT_POS  19u
+#define GREP_MAX_THREADS  256u
+#define GREP_MIN_CHUNK    (1u << 20)  /* below this, one thread is faster */
+#define GREP_STREAM_BLOCK (64u << 20) /* bytes read per stream window */
+#define GREP_OUT_INITIAL  (64u << 10)
+
+/* Expected dash masks of the three classification windows [0,16), [16,32)
+ * and [20,36) of a candidate: dashes sit at offsets 8, 13, 18 and 23. */
+#define GREP_DASHES_W0 ((1u << 8) | (1u << 13))
+#define GREP_DASHES_W1 ((1u << 2) | (1u << 7))
+#define GREP_DASHES_W2 (1u << 3)
+#define GREP_MASK16    0xFFFFu
+
+/****************************************************************************
+ * PRIVATE STUCTURED VARIABLES
+ ****************************************************************************
+ */
+
+typedef struct grep_opts
+{
+    uint64_t from_ms;
+    uint64_t to_ms;
+    bool only_ids;
+    bool count;
+    bool with_name;
+    unsigned threads;
+} grep_opts_t;
+
+typedef struct grep_out
+{
+    char* buf;
+    size_t len;
+    size_t cap;
+} grep_out_t;
+
+typedef struct grep_job
+{
+    const char* base;
+    size_t len;
+    const grep_opts_t* opts;
+    const char* name;
+    grep_out_t out;
+    size_t matches;
+    bool oom;
+} grep_job_t;
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS PROTOTYPES
+ ****************************************************************************
+ */
+
+/**
+ * @brief Position of the next '-' at or after @p i, or @p n if none.
+ */
+static size_t _find_dash(const char* p, size_t i, size_t n);
+
+/**
+ * @brief Check that the 36 bytes at @p s have the UUIDv7 string shape.
+ */
+static bool _match_shape(const char* s);
+
+/**
+ * @brief Scan one chunk of whole lines and collect its output.
+ * @param arg  grep_job_t* describing the chunk.
+ * @return NULL.
+ */
+static void* _scan_chunk(void* arg);
+
+/**
+ * @brief Split a window into per-thread chunks, scan them and print results.
+ * @return Number of matches in the window, or -1 on allocation failure.
+ */
+static long long _scan_window(const char* base, size_t len, const grep_opts_t* opts, const char* name);
+
+/**
+ * @brief Scan one input (file path or "-" for stdin).
+ * @return Number of matches, or -1 on error.
+ */
+static long long _scan_input(const char* path, const grep_opts_t* opts);
+
+/**
+ * @brief Parse unix ms or a UTC `YYYY-MM-DDTHH:MM:SS[.mmm][Z]` timestamp.
+ * @return 0 on success, -1 on malformed input.
+ */
+static int _parse_time(const char* s, uint64_t* ms);
+
+/****************************************************************************
+ * PUBLIC FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+int main(int argc, char** argv)
+{
+    grep_opts_t opts = {0};
+    bool have_from = false;
+    bool have_to = false;
+
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    opts.threads = (ncpu > 0) ? (unsigned)ncpu : 1u;
+
+    static const struct option long_opts[] = {
+        {"from", required_argument, NULL, 'f'},
+        {"to", required_argument, NULL, 't'},
+        {"only-ids", no_argument, NULL, 'o'},
+        {"count", no_argument, NULL, 'c'},
+        {"threads", required_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+
+    int c;
+    while((c = getopt_long(argc, argv, "f:t:ocj:h", long_opts, NULL)) != -1)
+    {
+        switch(c)
+        {
+            case 'f':
+                if(_parse_time(optarg, &opts.from_ms) != 0) goto bad_time;
+                have_from = true;
+                break;
+            case 't':
+                if(_parse_time(optarg, &opts.to_ms) != 0) goto bad_time;
+                have_to = true;
+                break;
+            case 'o': opts.only_ids = true; break;
+            case 'c': opts.count = true; break;
+            case 'j':
+            {
+                long j = strtol(optarg, NULL, 10);
+                if(j < 1) j = 1;
+                if(j > (long)GREP_MAX_THREADS) j = GREP_MAX_THREADS;
+                opts.threads = (unsigned)j;
+                break;
+            }
+            case 'h':
+            default:
+                fprintf(stderr,
+                        "usage: %s -f FROM -t TO [-o] [-c] [-j N] [FILE...]\n"
+                        "  FROM/TO: unix ms or UTC YYYY-MM-DDTHH:MM:SS[.mmm][Z] (inclusive)\n"
+                        "  -o  print matching IDs instead of lines\n"
+                        "  -c  print the number of matches only\n"
+                        "  -j  worker threads (default: online CPUs)\n",
+                        argv[0]);
+                return (c == 'h') ? 0 : 2;
+        }
+    }
+
+    if(!have_from || !have_to)
+    {
+        fprintf(stderr, "%s: both --from and --to are required\n", argv[0]);
+        return 2;
+    }
+    if(opts.threads > GREP_MAX_THREADS) opts.threads = GREP_MAX_THREADS;
+
+    const int nfiles = argc - optind;
+    opts.with_name = nfiles > 1;
+
+    long long total = 0;
+    bool failed = false;
+    if(nfiles == 0)
+    {
+        long long r = _scan_input("-", &opts);
+        if(r < 0) failed = true;
+        else total += r;
+    }
+    for(int i = optind; i < argc; ++i)
+    {
+        long long r = _scan_input(argv[i], &opts);
+        if(r < 0) failed = true;
+        else total += r;
+    }
+
+    fflush(stdout);
+    if(failed) return 2;
+    return (total > 0) ? 0 : 1;
+
+bad_time:
+    fprintf(stderr, "%s: invalid time '%s'\n", argv[0], optarg);
+    return 2;
+}
+
+/****************************************************************************
+ * PRIVATE FUNCTIONS DEFINITIONS
+ ****************************************************************************
+ */
+
+static inline bool _is_hex(char c)
+{
+    return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f');
+}
+
+static size_t _find_dash(const char* p, size_t i, size_t n)
+{
+#if defined(__SSE2__)
+    const __m128i dash = _mm_set1_epi8('-');
+    while(i + 16u <= n)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(const void*)(p + i));
+        const unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, dash));
+        if(m) return i + (size_t)__builtin_ctz(m);
+        i += 16u;
+    }
+#endif
+    while(i < n && p[i] != '-') ++i;
+    return i;
+}
+
+#if defined(__SSE2__)
+/* Classify 16 bytes: returns the hex-digit mask and stores the dash mask. */
+static inline unsigned _classify16(const char* p, unsigned* dashes)
+{
+    const __m128i v = _mm_loadu_si128((const __m128i*)(const void*)p);
+    const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+    const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                        _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    *dashes = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('-')));
+    return (unsigned)_mm_movemask_epi8(_mm_or_si128(digit, alpha));
+}
+#endif
+
+static bool _match_shape(const char* s)
+{
+    if(s[GREP_VERSION_POS] != '7') return false;
+    const char var = (char)(s[GREP_VARIANT_POS] | 0x20);
+    if(var != '8' && var != '9' && var != 'a' && var != 'b') return false;
+
+#if defined(__SSE2__)
+    unsigned d0, d1, d2;
+    const unsigned h0 = _classify16(s, &d0);
+    const unsigned h1 = _classify16(s + 16, &d1);
+    const unsigned h2 = _classify16(s + 20, &d2);
+    return d0 == GREP_DASHES_W0 && d1 == GREP_DASHES_W1 && d2 == GREP_DASHES_W2 &&
+           (h0 | d0) == GREP_MASK16 && (h1 | d1) == GREP_MASK16 && (h2 | d2) == GREP_MASK16;
+#else
+    for(unsigned i = 0; i < GREP_UUID_CHARS; ++i)
+    {
+        const bool dash_pos = (i == 8u || i == 13u || i == 18u || i == 23u);
+        if(dash_pos ? (s[i] != '-') : !_is_hex(s[i])) return false;
+    }
+    return true;
+#endif
+}
+
+static bool _out_append(grep_job_t* job, const char* data, size_t n, bool newline)
+{
+    const size_t name_len = job->name ? strlen(job->name) + 1u : 0u;
+    const size_t need = job->out.len + name_len + n + (newline ? 1u : 0u);
+    if(need > job->out.cap)
+    {
+        size_t cap = job->out.cap ? job->out.cap : GREP_OUT_INITIAL;
+        while(cap < need) cap *= 2u;
+        char* nb = realloc(job->out.buf, cap);
+        if(!nb)
+        {
+            job->oom = true;
+            return false;
+        }
+        job->out.buf = nb;
+        job->out.cap = cap;
+    }
+    if(name_len)
+    {
+        memcpy(job->out.buf + job->out.len, job->name, name_len - 1u);
+        job->out.buf[job->out.len + name_len - 1u] = ':';
+        job->out.len += name_len;
+    }
+    memcpy(job->out.buf + job->out.len, data, n);
+    job->out.len += n;
+    if(newline) job->out.buf[job->out.len++] = '\n';
+    return true;
+}
+
+static void* _scan_chunk(void* arg)
+{
+    grep_job_t* job = (grep_job_t*)arg;
+    const char* p = job->base;
+    const size_t n = job->len;
+    const grep_opts_t* opts = job->opts;
+
+    size_t i = GREP_FIRST_DASH;
+    while(i < n)
+    {
+        const size_t d = _find_dash(p, i, n);
+        if(d >= n) break;
+
+        const size_t s = d - GREP_FIRST_DASH;
+        if(s + GREP_UUID_CHARS > n) break;
+
+        /* Reject candidates embedded in longer hex runs */
+        if(!_match_shape(p + s) || (s > 0 && _is_hex(p[s - 1])) ||
+           (s + GREP_UUID_CHARS < n && _is_hex(p[s + GREP_UUID_CHARS])))
+        {
+            i = d + 1u;
+            continue;
+        }
+
+        uint64_t ms = 0;
+        (void)uuid7_str_ms(p + s, &ms); /* shape already validated */
+        if(ms < opts->from_ms || ms > opts->to_ms)
+        {
+            i = s + GREP_UUID_CHARS + GREP_FIRST_DASH;
+            continue;
+        }
+
+        job->matches++;
+        if(opts->only_ids)
+        {
+            if(!opts->count && !_out_append(job, p + s, GREP_UUID_CHARS, true)) return NULL;
+            i = s + GREP_UUID_CHARS + GREP_FIRST_DASH;
+            continue;
+        }
+
+        /* Whole line: print it once and resume after it */
+        const char* ls = memrchr(p, '\n', s);
+        const size_t line_start = ls ? (size_t)(ls - p) + 1u : 0u;
+        const char* le = memchr(p + s, '\n', n - s);
+        const size_t line_end = le ? (size_t)(le - p) : n;
+        if(!opts->count && !_out_append(job, p + line_start, line_end - line_start, true)) return NULL;
+        i = line_end + 1u + GREP_FIRST_DASH;
+    }
+    return NULL;
+}
+
+static long long _scan_window(const char* base, size_t len, const grep_opts_t* opts, const char* name)
+{
+    unsigned nthreads = opts->threads;
+    if(len / GREP_MIN_CHUNK < nthreads) nthreads = (unsigned)(len / GREP_MIN_CHUNK);
+    if(nthreads == 0) nthreads = 1;
+
+    grep_job_t jobs[GREP_MAX_THREADS];
+    pthread_t tids[GREP_MAX_THREADS];
+    bool started[GREP_MAX_THREADS];
+
+    /* Cut chunk boundaries just after a newline so no line is split */
+    size_t start = 0;
+    for(unsigned t = 0; t < nthreads; ++t)
+    {
+        size_t end = (t + 1u == nthreads) ? len : (len / nthreads) * (t + 1u);
+        if(end < start) end = start;
+        if(end < len)
+        {
+            const char* nl = memchr(base + end, '\n', len - end);
+            end = nl ? (size_t)(nl - base) + 1u : len;
+        }
+        jobs[t] = (grep_job_t){.base = base + start, .len = end - start, .opts = opts, .name = name};
+        start = end;
+    }
+
+    for(unsigned t = 1; t < nthreads; ++t)
+    {
+        started[t] = pthread_create(&tids[t], NULL, _scan_chunk, &jobs[t]) == 0;
+        if(!started[t]) _scan_chunk(&jobs[t]);
+    }
+    _scan_chunk(&jobs[0]);
+
+    long long matches = 0;
+    bool oom = false;
+    for(unsigned t = 0; t < nthreads; ++t)
+    {
+        if(t > 0 && started[t]) pthread_join(tids[t], NULL);
+        if(jobs[t].oom) oom = true;
+        if(!oom && jobs[t].out.len) fwrite(jobs[t].out.buf, 1, jobs[t].out.len, stdout);
+        free(jobs[t].out.buf);
+        matches += (long long)jobs[t].matches;
+    }
+    if(oom)
+    {
+        fprintf(stderr, "uuid7grep: out of memory\n");
+        return -1;
+    }
+    return matches;
+}
+
+static long long _scan_stream(int fd, const grep_opts_t* opts, const char* name)
+{
+    size_t cap = GREP_STREAM_BLOCK;
+    char* buf = malloc(cap);
+    if(!buf) return -1;
+
+    long long total = 0;
+    size_t have = 0;
+    bool eof = false;
+    while(!eof)
+    {
+        while(have < cap)
+        {
+            ssize_t r = read(fd, buf + have, cap - have);
+            if(r < 0)
+            {
+                if(errno == EINTR) continue;
+                free(buf);
+                return -1;
+            }
+            if(r == 0)
+            {
+                eof = true;
+                break;
+            }
+            have += (size_t)r;
+        }
+
+        /* Process whole lines; keep the trailing partial line for later */
+        size_t cut = have;
+        if(!eof)
+        {
+            const char* nl = memrchr(buf, '\n', have);
+            if(!nl)
+            {
+                /* Single line longer than the window: grow and keep reading */
+                char* nb = realloc(buf, cap * 2u);
+                if(!nb)
+                {
+                    free(buf);
+                    return -1;
+                }
+                buf = nb;
+                cap *= 2u;
+                continue;
+            }
+            cut = (size_t)(nl - buf) + 1u;
+        }
+
+        long long r = _scan_window(buf, cut, opts, name);
+        if(r < 0)
+        {
+            free(buf);
+            return -1;
+        }
+        total += r;
+        memmove(buf, buf + cut, have - cut);
+        have -= cut;
+    }
+    free(buf);
+    return total;
+}
+
+static long long _scan_input(const char* path, const grep_opts_t* opts)
+{
+    const bool is_stdin = strcmp(path, "-") == 0;
+    const char* name = opts->with_name ? path : NULL;
+    int fd = is_stdin ? STDIN_FILENO : open(path, O_RDONLY);
+    if(fd < 0)
+    {
+        fprintf(stderr, "uuid7grep: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    long long r;
+    struct stat st;
+    if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(map == MAP_FAILED)
+        {
+            r = _scan_stream(fd, opts, name);
+        }
+        else
+        {
+            (void)madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+            r = _scan_window((const char*)map, (size_t)st.st_size, opts, name);
+            munmap(map, (size_t)st.st_size);
+        }
+    }
+    else
+    {
+        r = _scan_stream(fd, opts, name);
+    }
+
+    if(!is_stdin) close(fd);
+    if(r < 0) return -1;
+
+    if(opts->count)
+    {
+        if(name) printf("%s:", name);
+        printf("%lld\n", r);
+    }
+    return r;
+}
+
+/* Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant). */
+static int64_t _days_from_civil(int64_t y, unsigned m, unsigned d)
+{
+    y -= m <= 2u;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = (unsigned)(y - era * 400);
+    const unsigned mp = (m > 2u) ? m - 3u : m + 9u;
+    const unsigned doy = (153u * mp + 2u) / 5u + d - 1u;
+    const unsigned doe = yoe * 365u + yoe / 4u - yoe / 100u + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+static int _parse_time(const char* s, uint64_t* ms)
+{
+    char* end = NULL;
+    errno = 0;
+    unsigned long long v = strtoull(s, &end, 10);
+    if(errno == 0 && end != s && *end == '\0')
+    {
+        *ms = (uint64_t)v;
+        return 0;
+    }
+
+    int y, mo, d, h, mi, sec, consumed = 0;
+    char sep;
+    if(sscanf(s, "%4d-%2d-%2d%c%2d:%2d:%2d%n", &y, &mo, &d, &sep, &h, &mi, &sec, &consumed) != 7) return -1;
+    if(sep != 'T' && sep != 't' && sep != ' ') return -1;
+    if(y < 1970 || mo < 1 || mo > 12 || d < 1 || d > 31 || h > 23 || mi > 59 || sec > 60) return -1;
+
+    const char* p = s + consumed;
+    unsigned frac = 0;
+    if(*p == '.')
+    {
+        unsigned digits = 0;
+        for(++p; *p >= '0' && *p <= '9'; ++p, ++digits)
+        {
+            if(digits < 3u) frac = frac * 10u + (unsigned)(*p - '0');
+        }
+        if(digits == 0) return -1;
+        for(; digits < 3u; ++digits) frac *= 10u;
+    }
+    if(*p == 'Z' || *p == 'z') ++p;
+    if(*p != '\0') return -1;
+
+    const int64_t days = _days_from_civil(y, (unsigned)mo, (unsigned)d);
+    *ms = (uint64_t)((days * 86400 + h * 3600 + mi * 60 + sec) * 1000) + frac;
+    return 0;
+}